@@ -0,0 +1,691 @@
+#pragma once
+
+#include <bit>
+#include <vector>
+
+#include "attacks.hpp"
+#include "chess_board.hpp"
+#include "evaluation_weights.hpp"
+#include "globals.hpp"
+#include "move_generator.hpp"
+#include "non_linear_response.hpp"
+
+// The mobility of a piece is a weighted sum of these counts (see
+// Evaluator::calculate_piece_mobility) so, a position's mobility is fully
+// described by these counts per side per piece.
+enum MOBILITY_TERMS : uint8_t
+{
+    DIAGONAL_MOBILITY,
+    ORTHOGONAL_MOBILITY,
+    BACKWARDS_MOVEMENT_MOBILITY,
+    MULTI_MOVEMENT_MOBILITY,
+    KNIGHT_MOVEMENT_MOBILITY
+};
+
+constexpr uint8_t NUM_OF_MOBILITY_TERMS = 5;
+
+// Input slots of the per-position leaves of the evaluation graph recorded by
+// Feature_Evaluator<AD_Value> - the material counts followed by the mobility
+// counts. The piece bitboards use their own (sparse) input slots.
+constexpr uint32_t NUM_OF_MATERIAL_INPUTS =
+    NUM_OF_PLAYERS * (NUM_OF_UNIQUE_PIECES_PER_PLAYER - 1);
+constexpr uint32_t NUM_OF_MOBILITY_INPUTS =
+    NUM_OF_PLAYERS * NUM_OF_UNIQUE_PIECES_PER_PLAYER * NUM_OF_MOBILITY_TERMS;
+constexpr uint32_t NUM_OF_PIECE_SQUARE_INPUTS =
+    NUM_OF_PLAYERS * NUM_OF_UNIQUE_PIECES_PER_PLAYER;
+
+constexpr uint32_t material_input_slot(const uint8_t color, const uint8_t piece)
+{
+    return (color * (NUM_OF_UNIQUE_PIECES_PER_PLAYER - 1)) + piece;
+}
+
+constexpr uint32_t mobility_input_slot(const uint8_t color,
+                                       const uint8_t piece,
+                                       const uint8_t term)
+{
+    return NUM_OF_MATERIAL_INPUTS
+         + (((color * NUM_OF_UNIQUE_PIECES_PER_PLAYER) + piece)
+            * NUM_OF_MOBILITY_TERMS)
+         + term;
+}
+
+constexpr uint32_t piece_square_input_slot(const uint8_t color,
+                                           const uint8_t piece)
+{
+    return (color * NUM_OF_UNIQUE_PIECES_PER_PLAYER) + piece;
+}
+
+// =============================================================================
+// Struct:      Evaluation_Batch
+// Description: A structure-of-arrays batch of positions reduced to the inputs
+//              the evaluation terms depend on; piece bitboards, mobility counts
+//              and the side to move. Every input is stored in its own
+//              contiguous array indexed by position such that the batch
+//              evaluator can sweep a single term across all positions.
+// =============================================================================
+struct Evaluation_Batch
+{
+    std::size_t size = 0;
+
+    Multi_Array<std::vector<uint64_t>,
+                NUM_OF_PLAYERS,
+                NUM_OF_UNIQUE_PIECES_PER_PLAYER>
+        piece_bitboards;
+
+    Multi_Array<std::vector<uint8_t>,
+                NUM_OF_PLAYERS,
+                NUM_OF_UNIQUE_PIECES_PER_PLAYER,
+                NUM_OF_MOBILITY_TERMS>
+        mobility_counts;
+
+    std::vector<PIECE_COLOR> side_to_move;
+
+    void reserve(const std::size_t capacity);
+    void clear();
+    void append(const Chess_Board&           cb,
+                const Moves_Bitboard_Matrix& moving_side_matrix,
+                const Moves_Bitboard_Matrix& opposing_side_matrix);
+
+    // Generates both sides' moves to append the position.
+    void append(const Chess_Board& cb);
+
+    // Appends a copy of the position at the index of another batch.
+    void append(const Evaluation_Batch& other, const std::size_t index);
+
+    // Writes the inputs of the positions starting at start into the lanes of
+    // the replay buffers. Lanes past the end of the batch repeat the last
+    // position so, they stay finite and can be given a zero output adjoint.
+    void fill_replay_inputs(const std::size_t  start,
+                            AD_Replay_Buffers& buffers) const;
+};
+
+inline void Evaluation_Batch::reserve(const std::size_t capacity)
+{
+    for (uint8_t color = PIECE_COLOR::WHITE; color <= PIECE_COLOR::BLACK;
+         ++color)
+    {
+        for (uint8_t piece = PIECES::PAWN; piece <= PIECES::KING; ++piece)
+        {
+            piece_bitboards[color][piece].reserve(capacity);
+
+            for (auto& counts : mobility_counts[color][piece])
+            {
+                counts.reserve(capacity);
+            }
+        }
+    }
+
+    side_to_move.reserve(capacity);
+}
+
+inline void Evaluation_Batch::clear()
+{
+    for (uint8_t color = PIECE_COLOR::WHITE; color <= PIECE_COLOR::BLACK;
+         ++color)
+    {
+        for (uint8_t piece = PIECES::PAWN; piece <= PIECES::KING; ++piece)
+        {
+            piece_bitboards[color][piece].clear();
+
+            for (auto& counts : mobility_counts[color][piece]) { counts.clear(); }
+        }
+    }
+
+    side_to_move.clear();
+    size = 0;
+}
+
+inline void
+Evaluation_Batch::append(const Chess_Board&           cb,
+                         const Moves_Bitboard_Matrix& moving_side_matrix,
+                         const Moves_Bitboard_Matrix& opposing_side_matrix)
+{
+    Attacks a;
+
+    const PIECE_COLOR moving_side = cb.get_side_to_move();
+    const Bitboard    occupancies = cb.get_both_color_occupancies();
+
+    std::vector<Moves_Bitboard> moves_bitboards;
+
+    for (uint8_t color = PIECE_COLOR::WHITE; color <= PIECE_COLOR::BLACK;
+         ++color)
+    {
+        const Moves_Bitboard_Matrix& matrix =
+            (color == moving_side) ? moving_side_matrix : opposing_side_matrix;
+
+        for (uint8_t piece = PIECES::PAWN; piece <= PIECES::KING; ++piece)
+        {
+            piece_bitboards[color][piece].push_back(
+                cb.get_piece_occupancies((PIECE_COLOR) color, (PIECES) piece)
+                    .get_board());
+
+            // Same counts as Evaluator::calculate_piece_mobility, summed over
+            // every instance of the piece.
+            Multi_Array<uint8_t, NUM_OF_MOBILITY_TERMS> counts {};
+
+            moves_bitboards.clear();
+            matrix.get_piece_moves_bitboards((PIECE_COLOR) color,
+                                             (PIECES) piece,
+                                             moves_bitboards);
+            for (const Moves_Bitboard& mb : moves_bitboards)
+            {
+                const uint8_t diagonal_count =
+                    (mb.bitboard & a.get_bishop_attacks(mb.square, occupancies))
+                        .high_bit_count();
+                const uint8_t orthogonal_count =
+                    (mb.bitboard & a.get_rook_attacks(mb.square, occupancies))
+                        .high_bit_count();
+                const uint8_t backward_count =
+                    (mb.bitboard
+                     & Bitboard::get_backward_squares_mask(mb.square,
+                                                           (PIECE_COLOR) color))
+                        .high_bit_count();
+
+                counts[DIAGONAL_MOBILITY]           += diagonal_count;
+                counts[ORTHOGONAL_MOBILITY]         += orthogonal_count;
+                counts[BACKWARDS_MOVEMENT_MOBILITY] += backward_count;
+                counts[MULTI_MOVEMENT_MOBILITY] +=
+                    ((diagonal_count > 0) && (orthogonal_count > 0));
+                counts[KNIGHT_MOVEMENT_MOBILITY] +=
+                    (mb.bitboard.high_bit_count() * (piece == PIECES::KNIGHT));
+            }
+
+            for (uint8_t term = 0; term < NUM_OF_MOBILITY_TERMS; ++term)
+            {
+                mobility_counts[color][piece][term].push_back(counts[term]);
+            }
+        }
+    }
+
+    side_to_move.push_back(moving_side);
+    ++size;
+}
+
+inline void Evaluation_Batch::append(const Chess_Board& cb)
+{
+    const PIECE_COLOR moving_side   = cb.get_side_to_move();
+    const PIECE_COLOR opposing_side = ~moving_side;
+
+    Move_Generation_List  moving_side_moves_list;
+    Moves_Bitboard_Matrix moving_side_matrix;
+    Move_Generator        mg_moving_side(cb);
+    mg_moving_side.generate_all_moves<MOVE_GENERATION_TYPE::ALL>(
+        moving_side,
+        moving_side_moves_list,
+        moving_side_matrix);
+
+    Move_Generation_List  opposing_side_moves_list;
+    Moves_Bitboard_Matrix opposing_side_matrix;
+    Move_Generator        mg_opposing_side(cb);
+    mg_opposing_side.generate_all_moves<MOVE_GENERATION_TYPE::ALL>(
+        opposing_side,
+        opposing_side_moves_list,
+        opposing_side_matrix);
+
+    append(cb, moving_side_matrix, opposing_side_matrix);
+}
+
+inline void Evaluation_Batch::append(const Evaluation_Batch& other,
+                                     const std::size_t       index)
+{
+    for (uint8_t color = PIECE_COLOR::WHITE; color <= PIECE_COLOR::BLACK;
+         ++color)
+    {
+        for (uint8_t piece = PIECES::PAWN; piece <= PIECES::KING; ++piece)
+        {
+            piece_bitboards[color][piece].push_back(
+                other.piece_bitboards[color][piece][index]);
+
+            for (uint8_t term = 0; term < NUM_OF_MOBILITY_TERMS; ++term)
+            {
+                mobility_counts[color][piece][term].push_back(
+                    other.mobility_counts[color][piece][term][index]);
+            }
+        }
+    }
+
+    side_to_move.push_back(other.side_to_move[index]);
+    ++size;
+}
+
+inline void Evaluation_Batch::fill_replay_inputs(const std::size_t  start,
+                                                 AD_Replay_Buffers& buffers) const
+{
+    constexpr std::size_t L = AD_COMPILED_GRAPH_LANES;
+
+    MATREX_ASSERT((start < size), "Replay inputs start past the batch.");
+
+    for (std::size_t lane = 0; lane < L; ++lane)
+    {
+        const std::size_t index = std::min((start + lane), (size - 1));
+
+        for (uint8_t color = PIECE_COLOR::WHITE; color <= PIECE_COLOR::BLACK;
+             ++color)
+        {
+            for (uint8_t piece = PIECES::PAWN; piece <= PIECES::KING; ++piece)
+            {
+                const uint64_t bitboard = piece_bitboards[color][piece][index];
+
+                buffers.sparse_inputs[(piece_square_input_slot(color, piece)
+                                       * L)
+                                      + lane] = bitboard;
+
+                if (piece != PIECES::KING)
+                {
+                    buffers.inputs[(material_input_slot(color, piece) * L)
+                                   + lane] = std::popcount(bitboard);
+                }
+
+                for (uint8_t term = 0; term < NUM_OF_MOBILITY_TERMS; ++term)
+                {
+                    buffers.inputs[(mobility_input_slot(color, piece, term) * L)
+                                   + lane] =
+                        mobility_counts[color][piece][term][index];
+                }
+            }
+        }
+    }
+}
+
+// =============================================================================
+// Class:       Feature_Evaluator
+// Description: Evaluates a single position of an Evaluation_Batch. Unlike the
+//              Batch_Evaluator it supports auto-differentiation so, the tuner
+//              can compute gradients from the precomputed features without a
+//              Chess_Board or move generation. The piece-square sums only visit
+//              occupied squares instead of every square of the board.
+// =============================================================================
+template <typename T>
+class Feature_Evaluator
+{
+  public:
+
+    Feature_Evaluator(const Evaluation_Weights<T>& weights,
+                      const Evaluation_Batch&      batch,
+                      const std::size_t            index);
+
+    T evaluate_template_typed() const;
+
+    // The evaluation from white's perspective; unlike evaluate_template_typed
+    // the structure of it's graph doesn't depend on the side to move.
+    T evaluate_white_perspective() const;
+
+  private:
+
+    const Evaluation_Weights<T>& m_weights;
+    const Evaluation_Batch&      m_batch;
+    const std::size_t            m_index;
+
+    T material_score(const PIECE_COLOR side) const;
+    T mobility_score(const PIECE_COLOR side) const;
+    T piece_square_score(const PIECE_COLOR side) const;
+
+    T constant_conversion(const double value) const;
+
+    // A per-position feature of the evaluation, an input leaf of the graph
+    // when auto-differentiating.
+    T feature(const double value, const uint32_t slot) const;
+};
+
+template <typename T>
+Feature_Evaluator<T>::Feature_Evaluator(const Evaluation_Weights<T>& weights,
+                                        const Evaluation_Batch&      batch,
+                                        const std::size_t            index) :
+    m_weights(weights), m_batch(batch), m_index(index)
+{
+}
+
+template <typename T>
+T Feature_Evaluator<T>::evaluate_template_typed() const
+{
+    const PIECE_COLOR moving_side   = m_batch.side_to_move[m_index];
+    const PIECE_COLOR opposing_side = ~moving_side;
+
+    const T material =
+        material_score(moving_side) - material_score(opposing_side);
+    const T mobility =
+        mobility_score(moving_side) - mobility_score(opposing_side);
+    const T piece_square =
+        piece_square_score(moving_side) - piece_square_score(opposing_side);
+
+    return material + mobility + piece_square;
+}
+
+template <typename T>
+T Feature_Evaluator<T>::evaluate_white_perspective() const
+{
+    const T material = material_score(PIECE_COLOR::WHITE)
+                     - material_score(PIECE_COLOR::BLACK);
+    const T mobility = mobility_score(PIECE_COLOR::WHITE)
+                     - mobility_score(PIECE_COLOR::BLACK);
+    const T piece_square = piece_square_score(PIECE_COLOR::WHITE)
+                         - piece_square_score(PIECE_COLOR::BLACK);
+
+    return material + mobility + piece_square;
+}
+
+template <typename T>
+T Feature_Evaluator<T>::material_score(const PIECE_COLOR side) const
+{
+    T return_value = constant_conversion(0.0);
+
+    for (uint8_t piece = PIECES::PAWN; piece <= PIECES::QUEEN; ++piece)
+    {
+        const uint64_t bitboard = m_batch.piece_bitboards[side][piece][m_index];
+
+        const T material =
+            m_weights.material[piece]
+            * feature(std::popcount(bitboard), material_input_slot(side, piece));
+
+        return_value +=
+            Non_Linear_Response(m_weights.material_NLR_parameters[piece])
+                .value(material);
+    }
+
+    return return_value;
+}
+
+template <typename T>
+T Feature_Evaluator<T>::mobility_score(const PIECE_COLOR side) const
+{
+    T return_value = constant_conversion(0.0);
+
+    for (uint8_t piece = PIECES::PAWN; piece <= PIECES::KING; ++piece)
+    {
+        const auto& counts = m_batch.mobility_counts[side][piece];
+
+        const auto count = [&](const MOBILITY_TERMS term)
+        {
+            return feature(counts[term][m_index],
+                           mobility_input_slot(side, piece, term));
+        };
+
+        const T piece_mobility =
+            (m_weights.diagonal_mobility * count(DIAGONAL_MOBILITY))
+            + (m_weights.orthogonal_mobility * count(ORTHOGONAL_MOBILITY))
+            + (m_weights.backwards_movement_mobility
+               * count(BACKWARDS_MOVEMENT_MOBILITY))
+            + (m_weights.multi_movement_mobility
+               * count(MULTI_MOVEMENT_MOBILITY))
+            + (m_weights.knight_movement_mobility
+               * count(KNIGHT_MOVEMENT_MOBILITY));
+
+        return_value +=
+            Non_Linear_Response(m_weights.piece_mobility_NLR_parameters[piece])
+                .value(piece_mobility);
+    }
+
+    return return_value;
+}
+
+template <typename T>
+T Feature_Evaluator<T>::piece_square_score(const PIECE_COLOR side) const
+{
+    T return_value = constant_conversion(0.0);
+    T interaction  = constant_conversion(1.0);
+
+    for (uint8_t piece = PIECES::PAWN; piece <= PIECES::KING; ++piece)
+    {
+        const auto& table = m_weights.piece_square_tables[side][piece];
+
+        const uint64_t bitboard = m_batch.piece_bitboards[side][piece][m_index];
+
+        T piece_square = constant_conversion(0.0);
+        if constexpr (std::is_same_v<T, AD_Value>)
+        {
+            // The weights of a table are consecutive variables on the tape.
+            MATREX_ASSERT(
+                (table[NUM_OF_SQUARES_ON_CHESS_BOARD - 1].node
+                 == (table[0].node + NUM_OF_SQUARES_ON_CHESS_BOARD - 1)),
+                "Piece-square table weights are not consecutive on the tape.");
+
+            piece_square =
+                table[0].sparse_sum(bitboard,
+                                    piece_square_input_slot(side, piece));
+        }
+        else
+        {
+            for (const Square square : Bitboard(bitboard))
+            {
+                piece_square += table[square.get_index()];
+            }
+        }
+
+        const T value =
+            Non_Linear_Response(m_weights.piece_square_NLR_parameters[side][piece])
+                .value(piece_square);
+
+        return_value += value;
+        interaction   = interaction * value;
+    }
+
+    // Explicit interactive term of all of this side's piece-square values.
+    return_value +=
+        Non_Linear_Response(m_weights.interactive_piece_square_NLR_parameters[side])
+            .value(interaction);
+
+    return return_value;
+}
+
+template <typename T>
+T Feature_Evaluator<T>::constant_conversion(const double value) const
+{
+    if constexpr (std::is_same_v<T, AD_Value>)
+    {
+        return AD_Value::constant(m_weights[0].tape, value);
+    }
+    else
+    {
+        return explicit_fp_double_conversion<T>(value);
+    }
+}
+
+template <typename T>
+T Feature_Evaluator<T>::feature(const double   value,
+                                MAYBE_UNUSED const uint32_t slot) const
+{
+    if constexpr (std::is_same_v<T, AD_Value>)
+    {
+        return AD_Value::input(m_weights[0].tape, value, slot);
+    }
+    else
+    {
+        return explicit_fp_double_conversion<T>(value);
+    }
+}
+
+// =============================================================================
+// Class:       Batch_Evaluator
+// Description: Evaluates every position of an Evaluation_Batch. Instead of
+//              evaluating position by position, each evaluation term is swept
+//              across the whole batch with loops over contiguous arrays such
+//              that, a term's weights are loaded once per batch. Only the
+//              feature loops are simple enough to be vectorized, the
+//              non-linear responses and the loops over bitboards are scalar.
+//              The scores are identical to Evaluator::evaluate_template_typed
+//              up to the order of the floating point additions.
+// =============================================================================
+template <typename T>
+class Batch_Evaluator
+{
+    static_assert(!std::is_same_v<T, AD_Value>,
+                  "Batch evaluation does not support auto-differentiation.");
+
+  public:
+
+    Batch_Evaluator(const Evaluation_Weights<T>& weights);
+
+    void evaluate(const Evaluation_Batch& batch, std::vector<T>& scores) const;
+
+  private:
+
+    const Evaluation_Weights<T>& m_weights;
+
+    using Side_Scores = Multi_Array<std::vector<T>, NUM_OF_PLAYERS>;
+
+    void material_scores(const Evaluation_Batch& batch,
+                         std::vector<T>&         features,
+                         Side_Scores&            side_scores) const;
+
+    void mobility_scores(const Evaluation_Batch& batch,
+                         std::vector<T>&         features,
+                         Side_Scores&            side_scores) const;
+
+    void piece_square_scores(const Evaluation_Batch& batch,
+                             std::vector<T>&         features,
+                             Side_Scores&            side_scores) const;
+};
+
+template <typename T>
+Batch_Evaluator<T>::Batch_Evaluator(const Evaluation_Weights<T>& weights) :
+    m_weights(weights)
+{
+}
+
+template <typename T>
+void Batch_Evaluator<T>::evaluate(const Evaluation_Batch& batch,
+                                  std::vector<T>&         scores) const
+{
+    const std::size_t N    = batch.size;
+    const T           zero = explicit_fp_double_conversion<T>(0.0);
+
+    std::vector<T> features(N);
+    Side_Scores    side_scores = {std::vector<T>(N, zero),
+                                  std::vector<T>(N, zero)};
+
+    material_scores(batch, features, side_scores);
+    mobility_scores(batch, features, side_scores);
+    piece_square_scores(batch, features, side_scores);
+
+    scores.resize(N);
+
+    const T* white_scores = side_scores[PIECE_COLOR::WHITE].data();
+    const T* black_scores = side_scores[PIECE_COLOR::BLACK].data();
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        scores[i] = (batch.side_to_move[i] == PIECE_COLOR::WHITE)
+                      ? (white_scores[i] - black_scores[i])
+                      : (black_scores[i] - white_scores[i]);
+    }
+}
+
+template <typename T>
+void Batch_Evaluator<T>::material_scores(const Evaluation_Batch& batch,
+                                         std::vector<T>&         features,
+                                         Side_Scores& side_scores) const
+{
+    const std::size_t N = batch.size;
+
+    for (uint8_t color = PIECE_COLOR::WHITE; color <= PIECE_COLOR::BLACK;
+         ++color)
+    {
+        for (uint8_t piece = PIECES::PAWN; piece <= PIECES::QUEEN; ++piece)
+        {
+            const uint64_t* bitboards = batch.piece_bitboards[color][piece].data();
+            const T         weight    = m_weights.material[piece];
+
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                features[i] = weight * std::popcount(bitboards[i]);
+            }
+
+            const Non_Linear_Response<T> nlr(
+                m_weights.material_NLR_parameters[piece]);
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                side_scores[color][i] += nlr.value(features[i]);
+            }
+        }
+    }
+}
+
+template <typename T>
+void Batch_Evaluator<T>::mobility_scores(const Evaluation_Batch& batch,
+                                         std::vector<T>&         features,
+                                         Side_Scores& side_scores) const
+{
+    const std::size_t N = batch.size;
+
+    for (uint8_t color = PIECE_COLOR::WHITE; color <= PIECE_COLOR::BLACK;
+         ++color)
+    {
+        for (uint8_t piece = PIECES::PAWN; piece <= PIECES::KING; ++piece)
+        {
+            const auto& counts = batch.mobility_counts[color][piece];
+
+            const uint8_t* diagonal   = counts[DIAGONAL_MOBILITY].data();
+            const uint8_t* orthogonal = counts[ORTHOGONAL_MOBILITY].data();
+            const uint8_t* backwards  = counts[BACKWARDS_MOVEMENT_MOBILITY].data();
+            const uint8_t* multi      = counts[MULTI_MOVEMENT_MOBILITY].data();
+            const uint8_t* knight     = counts[KNIGHT_MOVEMENT_MOBILITY].data();
+
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                features[i] = (m_weights.diagonal_mobility * diagonal[i])
+                            + (m_weights.orthogonal_mobility * orthogonal[i])
+                            + (m_weights.backwards_movement_mobility
+                               * backwards[i])
+                            + (m_weights.multi_movement_mobility * multi[i])
+                            + (m_weights.knight_movement_mobility * knight[i]);
+            }
+
+            const Non_Linear_Response<T> nlr(
+                m_weights.piece_mobility_NLR_parameters[piece]);
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                side_scores[color][i] += nlr.value(features[i]);
+            }
+        }
+    }
+}
+
+template <typename T>
+void Batch_Evaluator<T>::piece_square_scores(const Evaluation_Batch& batch,
+                                             std::vector<T>&         features,
+                                             Side_Scores& side_scores) const
+{
+    const std::size_t N = batch.size;
+
+    std::vector<T> interactions(N);
+
+    for (uint8_t color = PIECE_COLOR::WHITE; color <= PIECE_COLOR::BLACK;
+         ++color)
+    {
+        std::fill(interactions.begin(),
+                  interactions.end(),
+                  explicit_fp_double_conversion<T>(1.0));
+
+        for (uint8_t piece = PIECES::PAWN; piece <= PIECES::KING; ++piece)
+        {
+            const uint64_t* bitboards = batch.piece_bitboards[color][piece].data();
+            const auto&     table     = m_weights.piece_square_tables[color][piece];
+
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                T value = explicit_fp_double_conversion<T>(0.0);
+                for (const Square square : Bitboard(bitboards[i]))
+                {
+                    value += table[square.get_index()];
+                }
+                features[i] = value;
+            }
+
+            const Non_Linear_Response<T> nlr(
+                m_weights.piece_square_NLR_parameters[color][piece]);
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                const T value          = nlr.value(features[i]);
+                side_scores[color][i] += value;
+                interactions[i]        = interactions[i] * value;
+            }
+        }
+
+        // Explicit interactive term of all of this side's piece-square values.
+        const Non_Linear_Response<T> nlr(
+            m_weights.interactive_piece_square_NLR_parameters[color]);
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            side_scores[color][i] += nlr.value(interactions[i]);
+        }
+    }
+}
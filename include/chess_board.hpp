@@ -7,6 +7,7 @@
 #include "bitboard.hpp"
 #include "chess_move.hpp"
 #include "globals.hpp"
+#include "nnue.hpp"
 #include "zobrist_hash.hpp"
 
 constexpr uint8_t     HALF_MOVE_CLOCK_MAXIMUM = 100;
@@ -46,6 +47,34 @@ struct Chess_Board_State
     }
 };
 
+// Compact 32 byte representation of a position used for training datasets. The
+// pieces are stored as 4 bit codes ((color << 3) | piece), two per byte, in the
+// least to most significant bit order of the occupancy bitboard. The result is
+// from white's perspective (0 = loss, 1 = draw, 2 = win) and the score is an
+// optional search score from white's perspective (0 if unknown).
+struct Packed_Position
+{
+    uint64_t occupancy;
+    Multi_Array<uint8_t, ((NUM_OF_PLAYERS * NUM_OF_PIECES_PER_PLAYER) / 2)>
+        pieces;
+
+    uint16_t castling_rights     : 4;
+    uint16_t castling_rook_files : 12; // 3 bits per [color][castling type].
+
+    uint16_t side_to_move     : 1;
+    uint16_t enpassant_square : 7; // Needs 7 bits because of NO_SQUARE
+    uint16_t half_move_clock  : 7;
+    uint16_t                  : 1;
+
+    uint16_t full_move_count : 14;
+    uint16_t result          : 2;
+
+    int16_t score;
+};
+
+static_assert(sizeof(Packed_Position) == 32,
+              "Packed positions are expected to be 32 bytes.");
+
 class Chess_Board
 {
   private:
@@ -72,6 +101,12 @@ class Chess_Board
 
     std::string to_fen();
 
+    void set_from_packed_position(const Packed_Position& packed);
+
+    // Only the board fields of the packed position are set, the result and
+    // score are left as zero.
+    Packed_Position to_packed_position() const;
+
     Bitboard get_both_color_occupancies() const;
 
     Bitboard get_color_occupancies(const PIECE_COLOR c) const;
@@ -107,6 +142,12 @@ class Chess_Board
     Undo_Chess_Move make_move(const Chess_Move& move);
     void            undo_move(const Undo_Chess_Move& undo_move);
 
+    // Passes the turn to the opponent without moving a piece. The null move
+    // starts a new hash history such that, no repetition is ever detected
+    // across it.
+    Undo_Chess_Move make_null_move();
+    void            undo_null_move(const Undo_Chess_Move& undo_move);
+
     void make_moves_from_string(const std::string& moves_str,
                                 const bool         is_frc);
 
@@ -128,18 +169,30 @@ class Chess_Board
     bool is_draw_by_fifty_move_rule() const;
     bool has_insufficient_mating_material() const;
 
+    // Whether the side has a piece other than it's pawns and king.
+    bool has_non_pawn_material(const PIECE_COLOR c) const;
+
+    void                    refresh_nnue_accumulator();
+    const NNUE_Accumulator& get_nnue_accumulator() const;
+
     bool operator==(const Chess_Board& other) const;
 
   private:
 
     Zobrist_Hash m_zobrist_hash;
 
+    NNUE_Accumulator m_nnue_accumulator;
+
     void place_pieces_from_fen(const std::string& rank_description,
                                const uint8_t      length_of_description,
                                const uint8_t      rank);
 
     inline void calculate_next_board_state(const PIECE_COLOR moving_side,
                                            const Chess_Move& move);
+
+    template <bool is_undo>
+    inline void update_nnue_accumulator(const PIECE_COLOR moving_side,
+                                        const Chess_Move& move);
 };
 
 // The core of make move and unmake move which takes advantage of the
@@ -229,3 +282,55 @@ Chess_Board::calculate_next_board_state(const PIECE_COLOR moving_side,
             Square(move.castling_rook_destination_square));
     }
 }
+
+// Unlike the Zobrist hash, the NNUE accumulator is not updated with XOR so, the
+// direction of the update matters - making a move removes the pieces from their
+// source squares and adds them to their destination squares whereas undoing a
+// move does the opposite.
+template <bool is_undo>
+inline void
+Chess_Board::update_nnue_accumulator(const PIECE_COLOR moving_side,
+                                     const Chess_Move& move)
+{
+    constexpr bool ADD    = !is_undo;
+    constexpr bool REMOVE = is_undo;
+
+    const PIECE_COLOR opposing_side = ~moving_side;
+
+    if (move.is_capture)
+    {
+        m_nnue_accumulator.update_piece<REMOVE>(
+            opposing_side,
+            move.captured_piece,
+            Square(move.destination_square));
+    }
+
+    if (move.is_en_passant)
+    {
+        m_nnue_accumulator.update_piece<REMOVE>(
+            opposing_side,
+            PIECES::PAWN,
+            Square(move.en_passant_victim_square));
+    }
+
+    m_nnue_accumulator.update_piece<REMOVE>(moving_side,
+                                            move.moving_piece,
+                                            Square(move.source_square));
+
+    m_nnue_accumulator.update_piece<ADD>(
+        moving_side,
+        (move.is_promotion ? move.promoted_piece : move.moving_piece),
+        Square(move.destination_square));
+
+    if (move.is_short_castling || move.is_long_castling)
+    {
+        m_nnue_accumulator.update_piece<REMOVE>(
+            moving_side,
+            PIECES::ROOK,
+            Square(move.castling_rook_source_square));
+        m_nnue_accumulator.update_piece<ADD>(
+            moving_side,
+            PIECES::ROOK,
+            Square(move.castling_rook_destination_square));
+    }
+}
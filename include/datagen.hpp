@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include "dataset.hpp"
+#include "psuedo_random_number_generator.hpp"
+#include "search.hpp"
+#include "threads.hpp"
+
+constexpr std::size_t DATAGEN_DEFAULT_NUM_OF_THREADS = 4;
+constexpr uint64_t    DATAGEN_DEFAULT_NUM_OF_GAMES   = 10000;
+constexpr int16_t     DATAGEN_DEFAULT_DEPTH          = 8;
+
+// Number of uniformly random legal moves played from the start position before
+// the engine takes over such that, the games do not all follow the same line.
+constexpr uint16_t DATAGEN_NUM_OF_RANDOM_OPENING_PLIES = 8;
+
+// Games still running after this many plies are adjudicated as draws.
+constexpr uint16_t DATAGEN_MAX_GAME_PLIES = 400;
+
+// Every worker owns a search engine so, the transposition table size (in MiB)
+// is per worker.
+constexpr uint64_t DATAGEN_TRANSPOSITION_TABLE_SIZE = 16;
+
+constexpr uint64_t DATAGEN_PROGRESS_INTERVAL_MS = 10000;
+
+struct Datagen_Options
+{
+    std::size_t num_of_threads = DATAGEN_DEFAULT_NUM_OF_THREADS;
+    uint64_t    num_of_games   = DATAGEN_DEFAULT_NUM_OF_GAMES;
+    int16_t     depth          = DATAGEN_DEFAULT_DEPTH; // <= 0 for no limit.
+    uint64_t    nodes          = 0; // Soft node limit, 0 for no limit.
+    uint16_t    max_game_plies = DATAGEN_MAX_GAME_PLIES;
+    uint64_t    seed           = GLOBAL_PRNG_DEFAULT_SEED;
+    bool        pin_threads    = false;
+};
+
+// Plays a single self-play game from a randomized opening and appends every
+// position the engine searched to game_positions with it's search score and
+// the game's result, both from white's perspective. Positions where the search
+// found a mate are not recorded because the game is adjudicated there.
+void play_self_play_game(Search_Engine&                engine,
+                         Psuedo_RNG<uint64_t>&         rng,
+                         const Datagen_Options&        options,
+                         std::vector<Packed_Position>& game_positions);
+
+struct Datagen_Shared_Data
+{
+    const Datagen_Options& options;
+    std::ostream&          output;
+    std::mutex             output_mutex;
+    std::atomic<uint64_t>  next_game              = 0;
+    std::atomic<uint64_t>  num_of_games_completed = 0;
+    std::atomic<uint64_t>  num_of_positions       = 0;
+};
+
+// =============================================================================
+// Datagen Class
+//
+// Generates training data by playing fixed depth or fixed node self-play games
+// on every thread of a thread pool. The positions are written to the output as
+// a binary dataset of packed positions (see dataset.hpp) in chunks so, the
+// workers rarely contend for the output.
+// =============================================================================
+class Datagen
+{
+  public:
+
+    Datagen(std::ostream& log, std::ostream& output, Datagen_Options options);
+
+    // Plays all the games and returns the number of positions written.
+    uint64_t generate();
+
+  private:
+
+    std::ostream&   m_log;
+    std::ostream&   m_output;
+    Datagen_Options m_options;
+    Thread_Pool     m_thread_pool;
+
+    void log_progress(const Datagen_Shared_Data& shared_data,
+                      const uint64_t             elapsed_time);
+};
+
+// =============================================================================
+// Datagen Worker Class
+//
+// A job that keeps claiming games from the shared game counter until all of
+// them are claimed. The positions of finished games are buffered locally and
+// written to the output once a chunk is full.
+// =============================================================================
+class Datagen_Worker : public Typed_Thread_Job<Datagen_Shared_Data>
+{
+  private:
+
+    std::size_t m_index_to_worker;
+
+  public:
+
+    Datagen_Worker(Datagen_Shared_Data& shared_data, const std::size_t worker) :
+        Typed_Thread_Job(shared_data)
+    {
+        m_index_to_worker = write_to_private_data<std::size_t>(worker);
+    }
+
+    virtual bool has_job() const override { return true; }
+
+    virtual std::any operator()(std::stop_token) override;
+
+  private:
+
+    void flush_chunk(std::vector<Packed_Position>& chunk);
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cmath>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "chess_board.hpp"
+
+// Number of packed positions buffered before they are written to or read from
+// a binary dataset file.
+constexpr std::size_t DATASET_IO_CHUNK_SIZE = 65536;
+
+// Results of a packed position (white's perspective) as stored in the 2 bit
+// result field.
+enum PACKED_RESULT : uint8_t
+{
+    PACKED_LOSS,
+    PACKED_DRAW,
+    PACKED_WIN
+};
+
+// Converts a text dataset of lines formatted as "<fen> [<result>]" with the
+// result being 1.0, 0.5 or 0.0 from white's perspective into a binary dataset of
+// packed positions. Returns the number of positions written.
+uint64_t convert_text_dataset(std::istream& text_dataset,
+                              std::ostream& binary_dataset);
+
+// Reads a whole binary dataset of packed positions.
+std::vector<Packed_Position> read_binary_dataset(std::istream& binary_dataset);
+
+inline double packed_result_to_score(const Packed_Position& packed)
+{
+    return static_cast<double>(packed.result)
+         / static_cast<double>(PACKED_RESULT::PACKED_WIN);
+}
+
+inline uint8_t score_to_packed_result(const double score)
+{
+    return static_cast<uint8_t>(std::lround(
+        score * static_cast<double>(PACKED_RESULT::PACKED_WIN)));
+}
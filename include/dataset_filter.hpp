@@ -0,0 +1,134 @@
+#pragma once
+
+#include <filesystem>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "dataset.hpp"
+#include "psuedo_random_number_generator.hpp"
+#include "search.hpp"
+#include "threads.hpp"
+
+constexpr std::size_t DATASET_FILTER_DEFAULT_NUM_OF_THREADS = 4;
+
+// Positions whose quiescence search score differs from their static evaluation
+// by more than this many centipawns have a pending tactic so, they are dropped.
+constexpr int32_t DATASET_FILTER_DEFAULT_QUIESCENCE_MARGIN = 60;
+
+// Every worker owns a search engine so, the transposition table size (in MiB)
+// is per worker.
+constexpr uint64_t DATASET_FILTER_TRANSPOSITION_TABLE_SIZE = 16;
+
+// Maximum number of positions of a shuffle bucket, the buckets are deduplicated
+// and shuffled in memory one at a time so, this bounds the memory used by both
+// (128 MiB of packed positions and 48 MiB of hashes and indices).
+constexpr std::size_t DATASET_SHUFFLE_BUCKET_SIZE = (1 << 22);
+
+// Number of positions buffered per shuffle bucket before they are appended to
+// the bucket's file.
+constexpr std::size_t DATASET_SHUFFLE_BUCKET_BUFFER_SIZE = 4096;
+
+struct Dataset_Filter_Options
+{
+    std::size_t num_of_threads    = DATASET_FILTER_DEFAULT_NUM_OF_THREADS;
+    int32_t     quiescence_margin = DATASET_FILTER_DEFAULT_QUIESCENCE_MARGIN;
+    uint64_t    seed              = GLOBAL_PRNG_DEFAULT_SEED;
+
+    // Directory in which every run creates it's own directory of temporary
+    // shuffle bucket files.
+    std::filesystem::path bucket_directory =
+        std::filesystem::temp_directory_path();
+};
+
+struct Dataset_Filter_Statistics
+{
+    uint64_t num_of_positions_read      = 0;
+    uint64_t num_of_duplicates          = 0;
+    uint64_t num_of_positions_in_check  = 0;
+    uint64_t num_of_non_quiet_positions = 0;
+    uint64_t num_of_positions_written   = 0;
+};
+
+enum class Dataset_Filter_Verdict : uint8_t
+{
+    KEEP,
+    IN_CHECK,
+    NOT_QUIET
+};
+
+struct Dataset_Filter_Shared_Data
+{
+    const std::vector<Packed_Position>&                chunk;
+    const std::vector<std::unique_ptr<Search_Engine>>& engines;
+    const Search_Constraints&                          constraints;
+    const int32_t                                      quiescence_margin;
+    std::vector<Dataset_Filter_Verdict>                verdicts;
+    std::vector<Zobrist_Hash_Storage_Type>             hashes;
+};
+
+// =============================================================================
+// Dataset Filter Class
+//
+// Streams a binary dataset of packed positions through a filter which drops
+// positions in check and positions that are not quiet, then drops exact
+// duplicates (by Zobrist hash) and shuffles the remaining positions into the
+// output. The positions are scattered to bucket files by their hash such that,
+// all the duplicates of a position are in the same bucket. Only a chunk of the
+// input and one bucket are in memory at a time.
+// =============================================================================
+class Dataset_Filter
+{
+  public:
+
+    Dataset_Filter(std::ostream& log, Dataset_Filter_Options options);
+
+    Dataset_Filter_Statistics filter(std::istream& input, std::ostream& output);
+
+  private:
+
+    std::ostream&                               m_log;
+    Dataset_Filter_Options                      m_options;
+    Thread_Pool                                 m_thread_pool;
+    std::vector<std::unique_ptr<Search_Engine>> m_engines;
+
+    void classify_chunk(Dataset_Filter_Shared_Data& shared_data);
+
+    // Creates a directory for the bucket files that no other run uses.
+    std::filesystem::path create_bucket_directory() const;
+
+    // Drops the duplicates of a bucket, keeping the first occurrence of every
+    // position, then shuffles it in memory and appends it to the output.
+    void dedup_and_shuffle_bucket(const std::filesystem::path& bucket_path,
+                                  Psuedo_RNG<uint64_t>&        rng,
+                                  std::ostream&                output,
+                                  Dataset_Filter_Statistics&   statistics);
+};
+
+// =============================================================================
+// Dataset Filter Worker Class
+//
+// A job which computes the Zobrist hash and the filter verdict of a contiguous
+// slice of a chunk with the search engine of it's worker.
+// =============================================================================
+class Dataset_Filter_Worker
+    : public Typed_Thread_Job<Dataset_Filter_Shared_Data>
+{
+  private:
+
+    std::size_t m_index_to_worker;
+
+  public:
+
+    Dataset_Filter_Worker(Dataset_Filter_Shared_Data& shared_data,
+                          const std::size_t           worker) :
+        Typed_Thread_Job(shared_data)
+    {
+        m_index_to_worker = write_to_private_data<std::size_t>(worker);
+    }
+
+    virtual bool has_job() const override { return true; }
+
+    virtual std::any operator()(std::stop_token) override;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cmath>
+#include <iostream>
 
 #include "chess_board.hpp"
 #include "globals.hpp"
@@ -10,6 +11,46 @@
 #include "correction_history_table.hpp"
 #include "evaluation_weights.hpp"
 
+// Set to 1 to count how often lazy evaluation skips the expensive stage.
+#define COLLECT_EVAL_STATISTICS 0
+
+// Lazy evaluation skips the mobility stage when the cheap stages (material and
+// piece-square) are further than this margin outside the alpha-beta window.
+// The margin is an empirical bound on the magnitude of the mobility stage, it
+// is not derived from the weights and may not hold after a retune so, the
+// statistics count how often the mobility stage falls outside of it.
+constexpr Matrex_FP_Int LAZY_EVALUATION_MARGIN =
+    Matrex_FP_Int::from_integer(250);
+
+struct Evaluation_Statistics
+{
+    uint64_t cheap_stage_evaluations     = 0;
+    uint64_t expensive_stage_evaluations = 0;
+    uint64_t lazy_fail_lows              = 0;
+    uint64_t lazy_fail_highs             = 0;
+    uint64_t lazy_margin_violations      = 0;
+
+    void print() const
+    {
+        const double lazy_exit_rate =
+            (cheap_stage_evaluations == 0)
+                ? 0.0
+                : (static_cast<double>(lazy_fail_lows + lazy_fail_highs)
+                   / static_cast<double>(cheap_stage_evaluations) * 100);
+
+        std::cout << "Evaluation Statistics:\n"
+                  << "Cheap Stage Evaluations: " << cheap_stage_evaluations
+                  << "\n"
+                  << "Expensive Stage Evaluations: "
+                  << expensive_stage_evaluations << "\n"
+                  << "Lazy Fail-Lows: " << lazy_fail_lows << "\n"
+                  << "Lazy Fail-Highs: " << lazy_fail_highs << "\n"
+                  << "Lazy Margin Violations: " << lazy_margin_violations
+                  << "\n"
+                  << "Lazy Exit Rate: " << lazy_exit_rate << "%" << std::endl;
+    }
+};
+
 template <typename T>
 class Evaluator
 {
@@ -20,12 +61,29 @@ class Evaluator
               const Moves_Bitboard_Matrix& moving_side_matrix,
               const Moves_Bitboard_Matrix& opposing_side_matrix);
 
+    // The opposing side's moves are only generated if the lazy evaluation
+    // needs the expensive stage.
+    Evaluator(const Evaluation_Weights<T>& weights,
+              const Chess_Board&           cb,
+              const Moves_Bitboard_Matrix& moving_side_matrix);
+
     T evaluate_template_typed() const;
 
     template <std::size_t corr_hist_table_size>
     Score evaluate(const Correction_History_Tables<corr_hist_table_size>&
                        corr_hist_tables) const;
 
+    template <std::size_t corr_hist_table_size>
+    Score evaluate(
+        const Correction_History_Tables<corr_hist_table_size>& corr_hist_tables,
+        const Score                                            alpha,
+        const Score                                            beta,
+        bool&                                                  is_lazy,
+        Evaluation_Statistics& statistics) const;
+
+    T cheap_stage_score() const;
+    T expensive_stage_score(const Moves_Bitboard_Matrix& opposing_side_matrix) const;
+
     template <PIECE_COLOR moving_side>
     inline T material_score() const;
 
@@ -40,7 +98,8 @@ class Evaluator
     const Evaluation_Weights<T>& m_weights;
     const Chess_Board&           m_chess_board;
     const Moves_Bitboard_Matrix& m_moving_side_matrix;
-    const Moves_Bitboard_Matrix& m_opposing_side_matrix;
+
+    Optional_Reference<const Moves_Bitboard_Matrix> m_opposing_side_matrix;
 
     // Helpers
     template <PIECE_COLOR side>
@@ -62,6 +121,17 @@ Evaluator<T>::Evaluator(const Evaluation_Weights<T>& weights,
 {
 }
 
+template <typename T>
+Evaluator<T>::Evaluator(const Evaluation_Weights<T>& weights,
+                        const Chess_Board&           cb,
+                        const Moves_Bitboard_Matrix& moving_side_matrix) :
+    m_weights(weights),
+    m_chess_board(cb),
+    m_moving_side_matrix(moving_side_matrix),
+    m_opposing_side_matrix()
+{
+}
+
 template <typename T>
 T Evaluator<T>::evaluate_template_typed() const
 {
@@ -75,8 +145,9 @@ T Evaluator<T>::evaluate_template_typed() const
     {
         material = material_score<PIECE_COLOR::WHITE>()
                  - material_score<PIECE_COLOR::BLACK>();
-        mobility = mobility_score<PIECE_COLOR::WHITE>(m_moving_side_matrix)
-                 - mobility_score<PIECE_COLOR::BLACK>(m_opposing_side_matrix);
+        mobility =
+            mobility_score<PIECE_COLOR::WHITE>(m_moving_side_matrix)
+            - mobility_score<PIECE_COLOR::BLACK>(m_opposing_side_matrix.get_ref());
         piece_square = piece_square_score<PIECE_COLOR::WHITE>()
                      - piece_square_score<PIECE_COLOR::BLACK>();
     }
@@ -84,8 +155,9 @@ T Evaluator<T>::evaluate_template_typed() const
     {
         material = material_score<PIECE_COLOR::BLACK>()
                  - material_score<PIECE_COLOR::WHITE>();
-        mobility = mobility_score<PIECE_COLOR::BLACK>(m_moving_side_matrix)
-                 - mobility_score<PIECE_COLOR::WHITE>(m_opposing_side_matrix);
+        mobility =
+            mobility_score<PIECE_COLOR::BLACK>(m_moving_side_matrix)
+            - mobility_score<PIECE_COLOR::WHITE>(m_opposing_side_matrix.get_ref());
         piece_square = piece_square_score<PIECE_COLOR::BLACK>()
                      - piece_square_score<PIECE_COLOR::WHITE>();
     }
@@ -112,6 +184,122 @@ Score Evaluator<T>::evaluate(
     return return_value;
 }
 
+// Lazy evaluation - the cheap stage (material and piece-square) is evaluated
+// first and if it is far enough outside of the alpha-beta window that the
+// expensive stage (mobility, including the opposing side's move generation)
+// cannot bring it back inside, the cheap stage offset by the margin is returned
+// as a bound and is_lazy is set.
+template <typename T>
+template <std::size_t corr_hist_table_size>
+Score Evaluator<T>::evaluate(
+    const Correction_History_Tables<corr_hist_table_size>& corr_hist_tables,
+    const Score                                            alpha,
+    const Score                                            beta,
+    bool&                                                  is_lazy,
+    MAYBE_UNUSED Evaluation_Statistics&                    statistics) const
+{
+    const Score correction = corr_hist_tables.get_correction(m_chess_board);
+    const T     cheap      = cheap_stage_score();
+    const Score cheap_evaluation = Score(cheap) + correction;
+    const Score margin           = Score(LAZY_EVALUATION_MARGIN);
+
+#if COLLECT_EVAL_STATISTICS == 1
+    ++statistics.cheap_stage_evaluations;
+#endif
+
+    is_lazy = true;
+
+    Score evaluation;
+    if ((cheap_evaluation + margin) <= alpha)
+    {
+#if COLLECT_EVAL_STATISTICS == 1
+        ++statistics.lazy_fail_lows;
+#endif
+        evaluation = cheap_evaluation + margin;
+    }
+    else if ((cheap_evaluation - margin) >= beta)
+    {
+#if COLLECT_EVAL_STATISTICS == 1
+        ++statistics.lazy_fail_highs;
+#endif
+        evaluation = cheap_evaluation - margin;
+    }
+    else
+    {
+#if COLLECT_EVAL_STATISTICS == 1
+        ++statistics.expensive_stage_evaluations;
+#endif
+        is_lazy = false;
+
+        T expensive;
+        if (m_opposing_side_matrix.has_ref())
+        {
+            expensive = expensive_stage_score(m_opposing_side_matrix.get_ref());
+        }
+        else
+        {
+            const PIECE_COLOR opposing_side =
+                (PIECE_COLOR) ((~m_chess_board.get_side_to_move()) & 0x1);
+            Move_Generation_List  not_used_moves_list;
+            Moves_Bitboard_Matrix opposing_side_matrix;
+            Move_Generator        mg(m_chess_board);
+            mg.generate_all_moves<MOVE_GENERATION_TYPE::ALL>(
+                opposing_side,
+                not_used_moves_list,
+                opposing_side_matrix);
+
+            expensive = expensive_stage_score(opposing_side_matrix);
+        }
+
+#if COLLECT_EVAL_STATISTICS == 1
+        statistics.lazy_margin_violations +=
+            ((expensive > LAZY_EVALUATION_MARGIN)
+             || (expensive < -LAZY_EVALUATION_MARGIN));
+#endif
+
+        evaluation = Score(cheap + expensive) + correction;
+    }
+
+    const T clamped_evaluation = Matrex_FP_Int(
+        std::clamp(evaluation.to_int(), FP_EVALUATION_MIN, FP_EVALUATION_MAX));
+    return Score(clamped_evaluation);
+}
+
+template <typename T>
+T Evaluator<T>::cheap_stage_score() const
+{
+    if (m_chess_board.get_side_to_move() == PIECE_COLOR::WHITE)
+    {
+        return (material_score<PIECE_COLOR::WHITE>()
+                - material_score<PIECE_COLOR::BLACK>())
+             + (piece_square_score<PIECE_COLOR::WHITE>()
+                - piece_square_score<PIECE_COLOR::BLACK>());
+    }
+    else
+    {
+        return (material_score<PIECE_COLOR::BLACK>()
+                - material_score<PIECE_COLOR::WHITE>())
+             + (piece_square_score<PIECE_COLOR::BLACK>()
+                - piece_square_score<PIECE_COLOR::WHITE>());
+    }
+}
+
+template <typename T>
+T Evaluator<T>::expensive_stage_score(
+    const Moves_Bitboard_Matrix& opposing_side_matrix) const
+{
+    if (m_chess_board.get_side_to_move() == PIECE_COLOR::WHITE)
+    {
+        return mobility_score<PIECE_COLOR::WHITE>(m_moving_side_matrix)
+             - mobility_score<PIECE_COLOR::BLACK>(opposing_side_matrix);
+    }
+    else
+    {
+        return mobility_score<PIECE_COLOR::BLACK>(m_moving_side_matrix)
+             - mobility_score<PIECE_COLOR::WHITE>(opposing_side_matrix);
+    }
+}
+
 template <typename T>
 template <PIECE_COLOR moving_side>
 inline T Evaluator<T>::material_score() const
@@ -300,3 +488,60 @@ T Evaluator<T>::constant_conversion(const double value) const
         return explicit_fp_double_conversion<T>(value);
     }
 }
+
+/*******************************************************************************
+ *
+ * NNUE EVALUATOR
+ *
+ *******************************************************************************/
+
+// Evaluates a position with the loaded NNUE network. It shares the evaluate()
+// contract with the hand-crafted evaluator so that the search can switch
+// between the two. Requires that a network is loaded and that the board's
+// accumulator is up-to-date.
+class NNUE_Evaluator
+{
+  public:
+
+    NNUE_Evaluator(const Chess_Board& cb);
+
+    Matrex_FP_Int evaluate_template_typed() const;
+
+    template <std::size_t corr_hist_table_size>
+    Score evaluate(const Correction_History_Tables<corr_hist_table_size>&
+                       corr_hist_tables) const;
+
+  private:
+
+    const Chess_Board& m_chess_board;
+};
+
+inline NNUE_Evaluator::NNUE_Evaluator(const Chess_Board& cb) : m_chess_board(cb)
+{
+}
+
+inline Matrex_FP_Int NNUE_Evaluator::evaluate_template_typed() const
+{
+    const int32_t evaluation = m_chess_board.get_nnue_accumulator().forward(
+        m_chess_board.get_side_to_move());
+
+    return Matrex_FP_Int::from_integer(
+        std::clamp(evaluation,
+                   static_cast<int32_t>(ESCORE::EVALUATION_MIN),
+                   static_cast<int32_t>(ESCORE::EVALUATION_MAX)));
+}
+
+template <std::size_t corr_hist_table_size>
+Score NNUE_Evaluator::evaluate(
+    const Correction_History_Tables<corr_hist_table_size>& corr_hist_tables)
+    const
+{
+    const Score corrected_evaluation =
+        Score(evaluate_template_typed())
+        + corr_hist_tables.get_correction(m_chess_board);
+    const Matrex_FP_Int clamped_evaluation =
+        Matrex_FP_Int(std::clamp(corrected_evaluation.to_int(),
+                                 FP_EVALUATION_MIN,
+                                 FP_EVALUATION_MAX));
+    return Score(clamped_evaluation);
+}
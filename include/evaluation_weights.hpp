@@ -1,234 +1,193 @@
 #pragma once
 
+#include <algorithm>
+
 #include "globals.hpp"
 #include "non_linear_response.hpp"
 
+// The weights are stored in one contiguous, cache line aligned array of T. The
+// named members are views into that array (in the order of their flat index)
+// so, the optimizer's arithmetic runs as plain loops over the array.
 template <typename T>
 class Evaluation_Weights
 {
 
+    using Material_NLR_Type =
+        Multi_Array<NLR_Parameters<T>, (NUM_OF_UNIQUE_PIECES_PER_PLAYER - 1)>;
+    using Material_Type = Multi_Array<T, (NUM_OF_UNIQUE_PIECES_PER_PLAYER - 1)>;
+    using Piece_Mobility_NLR_Type =
+        Multi_Array<NLR_Parameters<T>, NUM_OF_UNIQUE_PIECES_PER_PLAYER>;
+    using Piece_Square_NLR_Type = Multi_Array<NLR_Parameters<T>,
+                                              NUM_OF_PLAYERS,
+                                              NUM_OF_UNIQUE_PIECES_PER_PLAYER>;
     using Piece_Square_Table_Type = Multi_Array<T,
                                                 NUM_OF_PLAYERS,
                                                 NUM_OF_UNIQUE_PIECES_PER_PLAYER,
                                                 NUM_OF_SQUARES_ON_CHESS_BOARD>;
+    using Interactive_Piece_Square_NLR_Type =
+        Multi_Array<NLR_Parameters<T>, NUM_OF_PLAYERS>;
+
+    // Offsets of the views into the array.
+    static constexpr std::size_t MATERIAL_NLR_OFFSET = 0;
+    static constexpr std::size_t MATERIAL_OFFSET =
+        MATERIAL_NLR_OFFSET + (sizeof(Material_NLR_Type) / sizeof(T));
+    static constexpr std::size_t PIECE_MOBILITY_NLR_OFFSET =
+        MATERIAL_OFFSET + (sizeof(Material_Type) / sizeof(T));
+    static constexpr std::size_t DIAGONAL_MOBILITY_OFFSET =
+        PIECE_MOBILITY_NLR_OFFSET
+        + (sizeof(Piece_Mobility_NLR_Type) / sizeof(T));
+    static constexpr std::size_t ORTHOGONAL_MOBILITY_OFFSET =
+        DIAGONAL_MOBILITY_OFFSET + 1;
+    static constexpr std::size_t KNIGHT_MOVEMENT_MOBILITY_OFFSET =
+        ORTHOGONAL_MOBILITY_OFFSET + 1;
+    static constexpr std::size_t MULTI_MOVEMENT_MOBILITY_OFFSET =
+        KNIGHT_MOVEMENT_MOBILITY_OFFSET + 1;
+    static constexpr std::size_t BACKWARDS_MOVEMENT_MOBILITY_OFFSET =
+        MULTI_MOVEMENT_MOBILITY_OFFSET + 1;
+    static constexpr std::size_t PIECE_SQUARE_NLR_OFFSET =
+        BACKWARDS_MOVEMENT_MOBILITY_OFFSET + 1;
+    static constexpr std::size_t PIECE_SQUARE_TABLES_OFFSET =
+        PIECE_SQUARE_NLR_OFFSET + (sizeof(Piece_Square_NLR_Type) / sizeof(T));
+    static constexpr std::size_t INTERACTIVE_PIECE_SQUARE_NLR_OFFSET =
+        PIECE_SQUARE_TABLES_OFFSET
+        + (sizeof(Piece_Square_Table_Type) / sizeof(T));
+
+  public:
+
+    static constexpr std::size_t SIZE =
+        INTERACTIVE_PIECE_SQUARE_NLR_OFFSET
+        + (sizeof(Interactive_Piece_Square_NLR_Type) / sizeof(T));
+
+  private:
+
+    // A view is only valid if its type is a whole number of weights without
+    // padding and doesn't need a stronger alignment than T.
+    template <typename View>
+    static constexpr bool is_valid_view_type()
+    {
+        return ((sizeof(View) % sizeof(T)) == 0)
+            && (alignof(View) == alignof(T));
+    }
+
+    static_assert(
+        is_valid_view_type<NLR_Parameters<T>>()
+            && is_valid_view_type<Material_NLR_Type>()
+            && is_valid_view_type<Material_Type>()
+            && is_valid_view_type<Piece_Mobility_NLR_Type>()
+            && is_valid_view_type<Piece_Square_NLR_Type>()
+            && is_valid_view_type<Piece_Square_Table_Type>()
+            && is_valid_view_type<Interactive_Piece_Square_NLR_Type>(),
+        "Evaluation weight views must be packed without padding.");
 
-    // clang-format off
-  using Evaluation_Weights_Reference_Array = Reference_Array<
-      T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T,
-      T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T,
-      T, Multi_Array<T, (NUM_OF_UNIQUE_PIECES_PER_PLAYER - 1)>, T, T, T, T, T,
-      T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T,
-      T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T,
-      T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, 
-      T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, 
-      T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, 
-      T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, 
-      T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, T, 
-      T, T, T, T, T, Piece_Square_Table_Type, T, T, T, T, T, T, T, T, T, T, T,
-      T, T, T, T, T, T, T, T, T>;
-    // clang-format on
+    CACHE_ALIGN T m_data[SIZE];
+
+    template <typename View>
+    View& view(const std::size_t offset)
+    {
+        return *reinterpret_cast<View*>(&m_data[offset]);
+    }
+
+    // Binds the views to this object's array and leaves the weights
+    // uninitialized; used by the public constructors before they fill the
+    // array.
+    struct Uninitialized
+    {
+    };
+
+    explicit Evaluation_Weights(Uninitialized) :
+        material_NLR_parameters(view<Material_NLR_Type>(MATERIAL_NLR_OFFSET)),
+        material(view<Material_Type>(MATERIAL_OFFSET)),
+        piece_mobility_NLR_parameters(
+            view<Piece_Mobility_NLR_Type>(PIECE_MOBILITY_NLR_OFFSET)),
+        diagonal_mobility(m_data[DIAGONAL_MOBILITY_OFFSET]),
+        orthogonal_mobility(m_data[ORTHOGONAL_MOBILITY_OFFSET]),
+        knight_movement_mobility(m_data[KNIGHT_MOVEMENT_MOBILITY_OFFSET]),
+        multi_movement_mobility(m_data[MULTI_MOVEMENT_MOBILITY_OFFSET]),
+        backwards_movement_mobility(m_data[BACKWARDS_MOVEMENT_MOBILITY_OFFSET]),
+        piece_square_NLR_parameters(
+            view<Piece_Square_NLR_Type>(PIECE_SQUARE_NLR_OFFSET)),
+        piece_square_tables(
+            view<Piece_Square_Table_Type>(PIECE_SQUARE_TABLES_OFFSET)),
+        interactive_piece_square_NLR_parameters(
+            view<Interactive_Piece_Square_NLR_Type>(
+                INTERACTIVE_PIECE_SQUARE_NLR_OFFSET))
+    {
+    }
 
   public:
 
-    Evaluation_Weights() :
-        material_NLR_parameters {},
-        material {},
-        piece_mobility_NLR_parameters {},
-        diagonal_mobility(T {}),
-        orthogonal_mobility(T {}),
-        knight_movement_mobility(T {}),
-        multi_movement_mobility(T {}),
-        backwards_movement_mobility(T {}),
-        piece_square_NLR_parameters {},
-        piece_square_tables {},
-        interactive_piece_square_NLR_parameters {},
-        m_weight_ref_array(
-            NLR_ARRAY_FIELDS(material_NLR_parameters, PIECES::PAWN),
-            NLR_ARRAY_FIELDS(material_NLR_parameters, PIECES::KNIGHT),
-            NLR_ARRAY_FIELDS(material_NLR_parameters, PIECES::BISHOP),
-            NLR_ARRAY_FIELDS(material_NLR_parameters, PIECES::ROOK),
-            NLR_ARRAY_FIELDS(material_NLR_parameters, PIECES::QUEEN),
-            material,
-            NLR_ARRAY_FIELDS(piece_mobility_NLR_parameters, PIECES::PAWN),
-            NLR_ARRAY_FIELDS(piece_mobility_NLR_parameters, PIECES::KNIGHT),
-            NLR_ARRAY_FIELDS(piece_mobility_NLR_parameters, PIECES::BISHOP),
-            NLR_ARRAY_FIELDS(piece_mobility_NLR_parameters, PIECES::ROOK),
-            NLR_ARRAY_FIELDS(piece_mobility_NLR_parameters, PIECES::QUEEN),
-            NLR_ARRAY_FIELDS(piece_mobility_NLR_parameters, PIECES::KING),
-            diagonal_mobility,
-            orthogonal_mobility,
-            knight_movement_mobility,
-            multi_movement_mobility,
-            backwards_movement_mobility,
-            NLR_2D_ARRAY_FIELDS(piece_square_NLR_parameters,
-                                PIECE_COLOR::WHITE,
-                                PIECES::PAWN),
-            NLR_2D_ARRAY_FIELDS(piece_square_NLR_parameters,
-                                PIECE_COLOR::WHITE,
-                                PIECES::KNIGHT),
-            NLR_2D_ARRAY_FIELDS(piece_square_NLR_parameters,
-                                PIECE_COLOR::WHITE,
-                                PIECES::BISHOP),
-            NLR_2D_ARRAY_FIELDS(piece_square_NLR_parameters,
-                                PIECE_COLOR::WHITE,
-                                PIECES::ROOK),
-            NLR_2D_ARRAY_FIELDS(piece_square_NLR_parameters,
-                                PIECE_COLOR::WHITE,
-                                PIECES::QUEEN),
-            NLR_2D_ARRAY_FIELDS(piece_square_NLR_parameters,
-                                PIECE_COLOR::WHITE,
-                                PIECES::KING),
-            NLR_2D_ARRAY_FIELDS(piece_square_NLR_parameters,
-                                PIECE_COLOR::BLACK,
-                                PIECES::PAWN),
-            NLR_2D_ARRAY_FIELDS(piece_square_NLR_parameters,
-                                PIECE_COLOR::BLACK,
-                                PIECES::KNIGHT),
-            NLR_2D_ARRAY_FIELDS(piece_square_NLR_parameters,
-                                PIECE_COLOR::BLACK,
-                                PIECES::BISHOP),
-            NLR_2D_ARRAY_FIELDS(piece_square_NLR_parameters,
-                                PIECE_COLOR::BLACK,
-                                PIECES::ROOK),
-            NLR_2D_ARRAY_FIELDS(piece_square_NLR_parameters,
-                                PIECE_COLOR::BLACK,
-                                PIECES::QUEEN),
-            NLR_2D_ARRAY_FIELDS(piece_square_NLR_parameters,
-                                PIECE_COLOR::BLACK,
-                                PIECES::KING),
-            piece_square_tables,
-            NLR_ARRAY_FIELDS(interactive_piece_square_NLR_parameters,
-                             PIECE_COLOR::WHITE),
-            NLR_ARRAY_FIELDS(interactive_piece_square_NLR_parameters,
-                             PIECE_COLOR::BLACK))
+    Evaluation_Weights() : Evaluation_Weights(Uninitialized {})
     {
+        std::fill(std::begin(m_data), std::end(m_data), T {});
     }
 
     Evaluation_Weights(
-        const Multi_Array<NLR_Parameters<T>,
-                          (NUM_OF_UNIQUE_PIECES_PER_PLAYER - 1)>
-            material_NLR_weights,
-        const Multi_Array<T, (NUM_OF_UNIQUE_PIECES_PER_PLAYER - 1)>
-            material_weights,
-        const Multi_Array<NLR_Parameters<T>, NUM_OF_UNIQUE_PIECES_PER_PLAYER>
-                piece_mobility_NLR_weights,
-        const T diagonal_mobility_weight,
-        const T orthogonal_mobility_weight,
-        const T knight_movement_mobility_weight,
-        const T multi_movement_mobility_weight,
-        const T backwards_movement_mobility_weight,
-        const Multi_Array<NLR_Parameters<T>,
-                          NUM_OF_PLAYERS,
-                          NUM_OF_UNIQUE_PIECES_PER_PLAYER>
-                                      piece_square_NLR_weights,
-        const Piece_Square_Table_Type piece_square_weights,
-        const Multi_Array<NLR_Parameters<T>, NUM_OF_PLAYERS>
+        const Material_NLR_Type&       material_NLR_weights,
+        const Material_Type&           material_weights,
+        const Piece_Mobility_NLR_Type& piece_mobility_NLR_weights,
+        const T                        diagonal_mobility_weight,
+        const T                        orthogonal_mobility_weight,
+        const T                        knight_movement_mobility_weight,
+        const T                        multi_movement_mobility_weight,
+        const T                        backwards_movement_mobility_weight,
+        const Piece_Square_NLR_Type&   piece_square_NLR_weights,
+        const Piece_Square_Table_Type& piece_square_weights,
+        const Interactive_Piece_Square_NLR_Type&
             interactive_piece_square_NLR_weights) :
-        material_NLR_parameters(material_NLR_weights),
-        material(material_weights),
-        piece_mobility_NLR_parameters(piece_mobility_NLR_weights),
-        diagonal_mobility(diagonal_mobility_weight),
-        orthogonal_mobility(orthogonal_mobility_weight),
-        knight_movement_mobility(knight_movement_mobility_weight),
-        multi_movement_mobility(multi_movement_mobility_weight),
-        backwards_movement_mobility(backwards_movement_mobility_weight),
-        piece_square_NLR_parameters(piece_square_NLR_weights),
-        piece_square_tables(piece_square_weights),
-        interactive_piece_square_NLR_parameters(
-            interactive_piece_square_NLR_weights),
-        m_weight_ref_array(
-            NLR_ARRAY_FIELDS(material_NLR_parameters, PIECES::PAWN),
-            NLR_ARRAY_FIELDS(material_NLR_parameters, PIECES::KNIGHT),
-            NLR_ARRAY_FIELDS(material_NLR_parameters, PIECES::BISHOP),
-            NLR_ARRAY_FIELDS(material_NLR_parameters, PIECES::ROOK),
-            NLR_ARRAY_FIELDS(material_NLR_parameters, PIECES::QUEEN),
-            material,
-            NLR_ARRAY_FIELDS(piece_mobility_NLR_parameters, PIECES::PAWN),
-            NLR_ARRAY_FIELDS(piece_mobility_NLR_parameters, PIECES::KNIGHT),
-            NLR_ARRAY_FIELDS(piece_mobility_NLR_parameters, PIECES::BISHOP),
-            NLR_ARRAY_FIELDS(piece_mobility_NLR_parameters, PIECES::ROOK),
-            NLR_ARRAY_FIELDS(piece_mobility_NLR_parameters, PIECES::QUEEN),
-            NLR_ARRAY_FIELDS(piece_mobility_NLR_parameters, PIECES::KING),
-            diagonal_mobility,
-            orthogonal_mobility,
-            knight_movement_mobility,
-            multi_movement_mobility,
-            backwards_movement_mobility,
-            NLR_2D_ARRAY_FIELDS(piece_square_NLR_parameters,
-                                PIECE_COLOR::WHITE,
-                                PIECES::PAWN),
-            NLR_2D_ARRAY_FIELDS(piece_square_NLR_parameters,
-                                PIECE_COLOR::WHITE,
-                                PIECES::KNIGHT),
-            NLR_2D_ARRAY_FIELDS(piece_square_NLR_parameters,
-                                PIECE_COLOR::WHITE,
-                                PIECES::BISHOP),
-            NLR_2D_ARRAY_FIELDS(piece_square_NLR_parameters,
-                                PIECE_COLOR::WHITE,
-                                PIECES::ROOK),
-            NLR_2D_ARRAY_FIELDS(piece_square_NLR_parameters,
-                                PIECE_COLOR::WHITE,
-                                PIECES::QUEEN),
-            NLR_2D_ARRAY_FIELDS(piece_square_NLR_parameters,
-                                PIECE_COLOR::WHITE,
-                                PIECES::KING),
-            NLR_2D_ARRAY_FIELDS(piece_square_NLR_parameters,
-                                PIECE_COLOR::BLACK,
-                                PIECES::PAWN),
-            NLR_2D_ARRAY_FIELDS(piece_square_NLR_parameters,
-                                PIECE_COLOR::BLACK,
-                                PIECES::KNIGHT),
-            NLR_2D_ARRAY_FIELDS(piece_square_NLR_parameters,
-                                PIECE_COLOR::BLACK,
-                                PIECES::BISHOP),
-            NLR_2D_ARRAY_FIELDS(piece_square_NLR_parameters,
-                                PIECE_COLOR::BLACK,
-                                PIECES::ROOK),
-            NLR_2D_ARRAY_FIELDS(piece_square_NLR_parameters,
-                                PIECE_COLOR::BLACK,
-                                PIECES::QUEEN),
-            NLR_2D_ARRAY_FIELDS(piece_square_NLR_parameters,
-                                PIECE_COLOR::BLACK,
-                                PIECES::KING),
-            piece_square_tables,
-            NLR_ARRAY_FIELDS(interactive_piece_square_NLR_parameters,
-                             PIECE_COLOR::WHITE),
-            NLR_ARRAY_FIELDS(interactive_piece_square_NLR_parameters,
-                             PIECE_COLOR::BLACK))
+        Evaluation_Weights(Uninitialized {})
+    {
+        material_NLR_parameters       = material_NLR_weights;
+        material                      = material_weights;
+        piece_mobility_NLR_parameters = piece_mobility_NLR_weights;
+        diagonal_mobility             = diagonal_mobility_weight;
+        orthogonal_mobility           = orthogonal_mobility_weight;
+        knight_movement_mobility      = knight_movement_mobility_weight;
+        multi_movement_mobility       = multi_movement_mobility_weight;
+        backwards_movement_mobility   = backwards_movement_mobility_weight;
+        piece_square_NLR_parameters   = piece_square_NLR_weights;
+        piece_square_tables           = piece_square_weights;
+        interactive_piece_square_NLR_parameters =
+            interactive_piece_square_NLR_weights;
+    }
+
+    // The views are bound to this object's array so, only the weights are
+    // copied.
+    Evaluation_Weights(const Evaluation_Weights& other) :
+        Evaluation_Weights(Uninitialized {})
     {
+        std::copy(std::begin(other.m_data), std::end(other.m_data), m_data);
     }
 
-    Evaluation_Weights(const Evaluation_Weights& other);
-    Evaluation_Weights& operator=(const Evaluation_Weights& other);
-    Evaluation_Weights(Evaluation_Weights&& other) noexcept;
-    Evaluation_Weights& operator=(Evaluation_Weights&& other) noexcept;
+    Evaluation_Weights& operator=(const Evaluation_Weights& other)
+    {
+        std::copy(std::begin(other.m_data), std::end(other.m_data), m_data);
+        return *this;
+    }
 
     // Material weights.
-    Multi_Array<NLR_Parameters<T>, (NUM_OF_UNIQUE_PIECES_PER_PLAYER - 1)>
-        material_NLR_parameters;
-    Multi_Array<T, (NUM_OF_UNIQUE_PIECES_PER_PLAYER - 1)> material;
+    Material_NLR_Type& material_NLR_parameters;
+    Material_Type&     material;
 
     // Mobility weights.
-    Multi_Array<NLR_Parameters<T>, NUM_OF_UNIQUE_PIECES_PER_PLAYER>
-        piece_mobility_NLR_parameters;
-    T   diagonal_mobility;
-    T   orthogonal_mobility;
-    T   knight_movement_mobility;
-    T   multi_movement_mobility;
-    T   backwards_movement_mobility;
+    Piece_Mobility_NLR_Type& piece_mobility_NLR_parameters;
+    T&                       diagonal_mobility;
+    T&                       orthogonal_mobility;
+    T&                       knight_movement_mobility;
+    T&                       multi_movement_mobility;
+    T&                       backwards_movement_mobility;
 
     // Piece Square Tables
-    Multi_Array<NLR_Parameters<T>,
-                NUM_OF_PLAYERS,
-                NUM_OF_UNIQUE_PIECES_PER_PLAYER>
-                            piece_square_NLR_parameters;
-    Piece_Square_Table_Type piece_square_tables;
-    Multi_Array<NLR_Parameters<T>, NUM_OF_PLAYERS>
-        interactive_piece_square_NLR_parameters;
+    Piece_Square_NLR_Type&             piece_square_NLR_parameters;
+    Piece_Square_Table_Type&           piece_square_tables;
+    Interactive_Piece_Square_NLR_Type& interactive_piece_square_NLR_parameters;
 
     T&       operator[](std::size_t index);
     const T& operator[](std::size_t index) const;
 
+    // The flat array of the weights, indexed the same as operator[].
+    T*       data();
+    const T* data() const;
+
     // Arithmetic operators with another evaluation weights.
     Evaluation_Weights operator+(const Evaluation_Weights& other) const;
     Evaluation_Weights operator-(const Evaluation_Weights& other) const;
@@ -266,65 +225,42 @@ class Evaluation_Weights
     std::size_t get_index_of(const U& ref) const;
 
     std::size_t get_size() const;
-
-  private:
-
-    Evaluation_Weights_Reference_Array m_weight_ref_array;
 };
 
 // Function prototype for non-member function.
 template <typename T>
 Evaluation_Weights<T> operator/(T scalar, const Evaluation_Weights<T>& weights);
 
-// This copy constructor avoids dangling references by first default
-// constructing a reference array (creating bounded references to the member
-// variables) and then assigning the reference array values from the other
-// evaluation weights (keep in mind, raw references cannot be rebound).
-template <typename T>
-Evaluation_Weights<T>::Evaluation_Weights(const Evaluation_Weights& other) :
-    Evaluation_Weights()
-{
-    for (std::size_t i = 0; i < get_size(); ++i) { (*this)[i] = other[i]; }
-}
-
 template <typename T>
-Evaluation_Weights<T>&
-Evaluation_Weights<T>::operator=(const Evaluation_Weights& other)
+T& Evaluation_Weights<T>::operator[](std::size_t index)
 {
-    if (this == &other) { return *this; }
-
-    for (std::size_t i = 0; i < get_size(); ++i) { (*this)[i] = other[i]; }
-    return *this;
-}
+    MATREX_ASSERT((index < SIZE),
+                  "Evaluation weights indexed outside of size. Index: {}",
+                  index);
 
-// Move constructor - same as copy constructor.
-template <typename T>
-Evaluation_Weights<T>::Evaluation_Weights(Evaluation_Weights&& other) noexcept :
-    Evaluation_Weights()
-{
-    for (std::size_t i = 0; i < get_size(); ++i) { (*this)[i] = other[i]; }
+    return data()[index];
 }
 
 template <typename T>
-Evaluation_Weights<T>&
-Evaluation_Weights<T>::operator=(Evaluation_Weights&& other) noexcept
+const T& Evaluation_Weights<T>::operator[](std::size_t index) const
 {
-    if (this == &other) { return *this; }
+    MATREX_ASSERT((index < SIZE),
+                  "Evaluation weights indexed outside of size. Index: {}",
+                  index);
 
-    for (std::size_t i = 0; i < get_size(); ++i) { (*this)[i] = other[i]; }
-    return *this;
+    return data()[index];
 }
 
 template <typename T>
-T& Evaluation_Weights<T>::operator[](std::size_t index)
+T* Evaluation_Weights<T>::data()
 {
-    return m_weight_ref_array[index];
+    return m_data;
 }
 
 template <typename T>
-const T& Evaluation_Weights<T>::operator[](std::size_t index) const
+const T* Evaluation_Weights<T>::data() const
 {
-    return m_weight_ref_array[index];
+    return m_data;
 }
 
 template <typename T>
@@ -333,10 +269,11 @@ Evaluation_Weights<T>::operator+(const Evaluation_Weights& other) const
 {
     Evaluation_Weights result;
 
-    for (std::size_t i = 0; i < m_weight_ref_array.size; ++i)
-    {
-        result[i] = m_weight_ref_array[i] + other.m_weight_ref_array[i];
-    }
+    T*       r = result.data();
+    const T* a = data();
+    const T* b = other.data();
+
+    for (std::size_t i = 0; i < SIZE; ++i) { r[i] = a[i] + b[i]; }
 
     return result;
 }
@@ -347,10 +284,11 @@ Evaluation_Weights<T>::operator-(const Evaluation_Weights& other) const
 {
     Evaluation_Weights result;
 
-    for (std::size_t i = 0; i < m_weight_ref_array.size; ++i)
-    {
-        result[i] = m_weight_ref_array[i] - other.m_weight_ref_array[i];
-    }
+    T*       r = result.data();
+    const T* a = data();
+    const T* b = other.data();
+
+    for (std::size_t i = 0; i < SIZE; ++i) { r[i] = a[i] - b[i]; }
 
     return result;
 }
@@ -361,10 +299,11 @@ Evaluation_Weights<T>::operator/(const Evaluation_Weights& other) const
 {
     Evaluation_Weights result;
 
-    for (std::size_t i = 0; i < m_weight_ref_array.size; ++i)
-    {
-        result[i] = m_weight_ref_array[i] / other.m_weight_ref_array[i];
-    }
+    T*       r = result.data();
+    const T* a = data();
+    const T* b = other.data();
+
+    for (std::size_t i = 0; i < SIZE; ++i) { r[i] = a[i] / b[i]; }
 
     return result;
 }
@@ -375,10 +314,11 @@ Evaluation_Weights<T>::operator*(const Evaluation_Weights& other) const
 {
     Evaluation_Weights result;
 
-    for (std::size_t i = 0; i < m_weight_ref_array.size; ++i)
-    {
-        result[i] = m_weight_ref_array[i] * other.m_weight_ref_array[i];
-    }
+    T*       r = result.data();
+    const T* a = data();
+    const T* b = other.data();
+
+    for (std::size_t i = 0; i < SIZE; ++i) { r[i] = a[i] * b[i]; }
 
     return result;
 }
@@ -387,9 +327,10 @@ template <typename T>
 Evaluation_Weights<T>&
 Evaluation_Weights<T>::operator+=(const Evaluation_Weights<T>& other)
 {
-    Evaluation_Weights<T> sum = (*this) + other;
+    T*       a = data();
+    const T* b = other.data();
 
-    for (std::size_t i = 0; i < get_size(); ++i) { (*this)[i] = sum[i]; }
+    for (std::size_t i = 0; i < SIZE; ++i) { a[i] = a[i] + b[i]; }
 
     return *this;
 }
@@ -398,31 +339,34 @@ template <typename T>
 Evaluation_Weights<T>&
 Evaluation_Weights<T>::operator-=(const Evaluation_Weights<T>& other)
 {
-    Evaluation_Weights<T> difference = (*this) - other;
+    T*       a = data();
+    const T* b = other.data();
 
-    for (std::size_t i = 0; i < get_size(); ++i) { (*this)[i] = difference[i]; }
+    for (std::size_t i = 0; i < SIZE; ++i) { a[i] = a[i] - b[i]; }
 
     return *this;
 }
 
 template <typename T>
 Evaluation_Weights<T>&
-Evaluation_Weights<T>::operator/=(const Evaluation_Weights& other)
+Evaluation_Weights<T>::operator/=(const Evaluation_Weights<T>& other)
 {
-    Evaluation_Weights<T> quotient = (*this) / other;
+    T*       a = data();
+    const T* b = other.data();
 
-    for (std::size_t i = 0; i < get_size(); ++i) { (*this)[i] = quotient[i]; }
+    for (std::size_t i = 0; i < SIZE; ++i) { a[i] = a[i] / b[i]; }
 
     return *this;
 }
 
 template <typename T>
 Evaluation_Weights<T>&
-Evaluation_Weights<T>::operator*=(const Evaluation_Weights& other)
+Evaluation_Weights<T>::operator*=(const Evaluation_Weights<T>& other)
 {
-    Evaluation_Weights<T> product = (*this) * other;
+    T*       a = data();
+    const T* b = other.data();
 
-    for (std::size_t i = 0; i < get_size(); ++i) { (*this)[i] = product[i]; }
+    for (std::size_t i = 0; i < SIZE; ++i) { a[i] = a[i] * b[i]; }
 
     return *this;
 }
@@ -432,10 +376,10 @@ Evaluation_Weights<T> Evaluation_Weights<T>::operator-() const
 {
     Evaluation_Weights result;
 
-    for (std::size_t i = 0; i < m_weight_ref_array.size; ++i)
-    {
-        result[i] = -m_weight_ref_array[i];
-    }
+    T*       r = result.data();
+    const T* a = data();
+
+    for (std::size_t i = 0; i < SIZE; ++i) { r[i] = -a[i]; }
 
     return result;
 }
@@ -445,10 +389,10 @@ Evaluation_Weights<T> Evaluation_Weights<T>::operator+(const T value) const
 {
     Evaluation_Weights result;
 
-    for (std::size_t i = 0; i < m_weight_ref_array.size; ++i)
-    {
-        result[i] = m_weight_ref_array[i] + value;
-    }
+    T*       r = result.data();
+    const T* a = data();
+
+    for (std::size_t i = 0; i < SIZE; ++i) { r[i] = a[i] + value; }
 
     return result;
 }
@@ -458,10 +402,10 @@ Evaluation_Weights<T> Evaluation_Weights<T>::operator-(const T value) const
 {
     Evaluation_Weights result;
 
-    for (std::size_t i = 0; i < m_weight_ref_array.size; ++i)
-    {
-        result[i] = m_weight_ref_array[i] - value;
-    }
+    T*       r = result.data();
+    const T* a = data();
+
+    for (std::size_t i = 0; i < SIZE; ++i) { r[i] = a[i] - value; }
 
     return result;
 }
@@ -471,10 +415,10 @@ Evaluation_Weights<T> Evaluation_Weights<T>::operator*(const T value) const
 {
     Evaluation_Weights result;
 
-    for (std::size_t i = 0; i < m_weight_ref_array.size; ++i)
-    {
-        result[i] = m_weight_ref_array[i] * value;
-    }
+    T*       r = result.data();
+    const T* a = data();
+
+    for (std::size_t i = 0; i < SIZE; ++i) { r[i] = a[i] * value; }
 
     return result;
 }
@@ -484,10 +428,10 @@ Evaluation_Weights<T> Evaluation_Weights<T>::operator/(const T value) const
 {
     Evaluation_Weights result;
 
-    for (std::size_t i = 0; i < m_weight_ref_array.size; ++i)
-    {
-        result[i] = m_weight_ref_array[i] / value;
-    }
+    T*       r = result.data();
+    const T* a = data();
+
+    for (std::size_t i = 0; i < SIZE; ++i) { r[i] = a[i] / value; }
 
     return result;
 }
@@ -495,9 +439,9 @@ Evaluation_Weights<T> Evaluation_Weights<T>::operator/(const T value) const
 template <typename T>
 Evaluation_Weights<T>& Evaluation_Weights<T>::operator+=(const T other)
 {
-    Evaluation_Weights<T> sum = (*this) + other;
+    T* a = data();
 
-    for (std::size_t i = 0; i < get_size(); ++i) { (*this)[i] = sum[i]; }
+    for (std::size_t i = 0; i < SIZE; ++i) { a[i] = a[i] + other; }
 
     return *this;
 }
@@ -505,9 +449,9 @@ Evaluation_Weights<T>& Evaluation_Weights<T>::operator+=(const T other)
 template <typename T>
 Evaluation_Weights<T>& Evaluation_Weights<T>::operator-=(const T other)
 {
-    Evaluation_Weights<T> difference = (*this) - other;
+    T* a = data();
 
-    for (std::size_t i = 0; i < get_size(); ++i) { (*this)[i] = difference[i]; }
+    for (std::size_t i = 0; i < SIZE; ++i) { a[i] = a[i] - other; }
 
     return *this;
 }
@@ -515,9 +459,9 @@ Evaluation_Weights<T>& Evaluation_Weights<T>::operator-=(const T other)
 template <typename T>
 Evaluation_Weights<T>& Evaluation_Weights<T>::operator/=(const T other)
 {
-    Evaluation_Weights<T> quotient = (*this) / other;
+    T* a = data();
 
-    for (std::size_t i = 0; i < get_size(); ++i) { (*this)[i] = quotient[i]; }
+    for (std::size_t i = 0; i < SIZE; ++i) { a[i] = a[i] / other; }
 
     return *this;
 }
@@ -525,9 +469,9 @@ Evaluation_Weights<T>& Evaluation_Weights<T>::operator/=(const T other)
 template <typename T>
 Evaluation_Weights<T>& Evaluation_Weights<T>::operator*=(const T other)
 {
-    Evaluation_Weights<T> product = (*this) * other;
+    T* a = data();
 
-    for (std::size_t i = 0; i < get_size(); ++i) { (*this)[i] = product[i]; }
+    for (std::size_t i = 0; i < SIZE; ++i) { a[i] = a[i] * other; }
 
     return *this;
 }
@@ -538,9 +482,12 @@ Evaluation_Weights<T> operator/(const T                      scalar,
 {
     Evaluation_Weights<T> result;
 
-    for (std::size_t i = 0; i < result.get_size(); ++i)
+    T*       r = result.data();
+    const T* a = weights.data();
+
+    for (std::size_t i = 0; i < Evaluation_Weights<T>::SIZE; ++i)
     {
-        result[i] = scalar / weights[i];
+        r[i] = scalar / a[i];
     }
 
     return result;
@@ -551,9 +498,12 @@ Evaluation_Weights<T> Evaluation_Weights<T>::sqrt() const
 {
     Evaluation_Weights result;
 
-    for (std::size_t i = 0; i < m_weight_ref_array.size; ++i)
+    T*       r = result.data();
+    const T* a = data();
+
+    for (std::size_t i = 0; i < SIZE; ++i)
     {
-        result[i] = static_cast<T>(std::sqrt(m_weight_ref_array[i]));
+        r[i] = static_cast<T>(std::sqrt(a[i]));
     }
 
     return result;
@@ -564,10 +514,9 @@ T Evaluation_Weights<T>::magnitude() const
 {
     T result = 0;
 
-    for (std::size_t i = 0; i < (*this).get_size(); ++i)
-    {
-        result += ((*this)[i] * (*this)[i]);
-    }
+    const T* a = data();
+
+    for (std::size_t i = 0; i < SIZE; ++i) { result += (a[i] * a[i]); }
 
     result = static_cast<T>(std::sqrt(result));
 
@@ -579,7 +528,7 @@ Evaluation_Weights<double> Evaluation_Weights<T>::to_double() const
 {
     Evaluation_Weights<double> result;
 
-    for (std::size_t i = 0; i < m_weight_ref_array.size; ++i)
+    for (std::size_t i = 0; i < SIZE; ++i)
     {
         result[i] = static_cast<double>((*this)[i].to_double());
     }
@@ -593,7 +542,7 @@ Evaluation_Weights<T>::to_matrex_fp_int() const
 {
     Evaluation_Weights<Matrex_FP_Int> result;
 
-    for (std::size_t i = 0; i < m_weight_ref_array.size; ++i)
+    for (std::size_t i = 0; i < SIZE; ++i)
     {
         result[i] = Matrex_FP_Int::from_double((*this)[i]);
     }
@@ -622,11 +571,19 @@ template <typename T>
 template <typename U>
 std::size_t Evaluation_Weights<T>::get_index_of(const U& ref) const
 {
-    return m_weight_ref_array.get_index_of(ref);
+    const T* weight = reinterpret_cast<const T*>(&ref);
+
+    if ((weight < data()) || (weight >= (data() + SIZE)))
+    {
+        throw std::out_of_range(
+            "Evaluation_Weights ERROR: Reference not found!");
+    }
+
+    return static_cast<std::size_t>(weight - data());
 }
 
 template <typename T>
 std::size_t Evaluation_Weights<T>::get_size() const
 {
-    return m_weight_ref_array.size;
+    return SIZE;
 }
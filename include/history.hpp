@@ -26,6 +26,18 @@ constexpr History_Score_Storage_Type MAX_CAPTURE_HISTORY_BONUS = 128;
 constexpr std::size_t QUIET_CONTINUATION_HISTORY_LOOKBACK_DEPTH   = 4;
 constexpr std::size_t CAPTURE_CONTINUATION_HISTORY_LOOKBACK_DEPTH = 2;
 
+// Number of quiet moves that caused a beta cutoff remembered per ply.
+constexpr std::size_t NUM_OF_KILLER_MOVES = 2;
+
+// Applies a bonus, or a penalty if it is a malus, to a history entry. The bonus
+// is clamped to the given range and then saturated by history gravity, which
+// every history table shares.
+template <bool is_malus>
+void history_gravity_update(History_Score_Storage_Type&      selected_entry,
+                            const History_Score_Storage_Type change,
+                            const History_Score_Storage_Type min_bonus,
+                            const History_Score_Storage_Type max_bonus);
+
 class Quiet_History_Table
 {
   public:
@@ -80,7 +92,9 @@ class Quiet_Continuation_History_Stack
     void bind_to_history_table(Quiet_History_Table& table,
                                const std::size_t    index);
 
-    History_Score_Storage_Type get_score(const Chess_Move& move) const;
+    // The sum of the entries of the move over the lookback plies, it can be
+    // outside the range of a single entry so, it is summed in 32 bits.
+    int32_t get_score(const Chess_Move& move) const;
 
     Partially_Filled_Array<Optional_Reference<Quiet_History_Table>, STACK_SIZE>
         stack;
@@ -141,23 +155,101 @@ class Capture_Continuation_History_Stack
     void bind_to_history_table(Capture_History_Table& table,
                                const std::size_t      index);
 
-    History_Score_Storage_Type get_score(const Chess_Move& move) const;
+    // The sum of the entries of the move over the lookback plies, it can be
+    // outside the range of a single entry so, it is summed in 32 bits.
+    int32_t get_score(const Chess_Move& move) const;
 
     Partially_Filled_Array<Optional_Reference<Capture_History_Table>,
                            STACK_SIZE>
         stack;
 };
 
-template <bool is_malus>
-void Quiet_History_Table::gravity_update(
-    const Chess_Move&                move,
-    const History_Score_Storage_Type change)
+// The main (butterfly) history of quiet moves indexed by the side to move and
+// the move's source and destination squares. Unlike the continuation histories
+// it does not depend on the previous moves so, it orders the quiets of every
+// ply including the first plies of the search.
+class Butterfly_History_Table
 {
-    auto& selected_entry = m_table[move.moving_piece][move.destination_square];
+  public:
+
+    Butterfly_History_Table();
+
+    History_Score_Storage_Type get(const PIECE_COLOR side_to_move,
+                                   const Chess_Move& move) const;
+
+    template <bool is_malus>
+    void gravity_update(const PIECE_COLOR                side_to_move,
+                        const Chess_Move&                move,
+                        const History_Score_Storage_Type change);
+
+    void clear();
+
+  private:
+
+    Multi_Array<History_Score_Storage_Type,
+                NUM_OF_PLAYERS,
+                NUM_OF_SQUARES_ON_CHESS_BOARD, // Source square
+                NUM_OF_SQUARES_ON_CHESS_BOARD> // Destination square
+        m_table;
+};
+
+// The most recent quiet moves that caused a beta cutoff at a ply, newest first.
+// Positions at the same ply are often refuted by the same move so, they are
+// searched before the other quiet moves.
+class Killer_Moves
+{
+  public:
+
+    Killer_Moves();
+
+    void update(const Chess_Move& move);
+
+    // Returns the slot of the move or NUM_OF_KILLER_MOVES if it is not a killer
+    // move.
+    std::size_t find(const Chess_Move& move) const;
+
+    void clear();
+
+  private:
+
+    Multi_Array<Chess_Move, NUM_OF_KILLER_MOVES> m_moves;
+};
+
+// The quiet move that last caused a beta cutoff in reply to a previous move,
+// indexed by the side to move and the previous move's moving piece and
+// destination square.
+class Counter_Move_Table
+{
+  public:
+
+    Counter_Move_Table();
+
+    Chess_Move& get(const PIECE_COLOR side_to_move,
+                    const Chess_Move& previous_move);
+
+    const Chess_Move& get(const PIECE_COLOR side_to_move,
+                          const Chess_Move& previous_move) const;
+
+    void clear();
 
+  private:
+
+    Multi_Array<Chess_Move,
+                NUM_OF_PLAYERS,
+                NUM_OF_UNIQUE_PIECES_PER_PLAYER, // Previous moving piece
+                NUM_OF_SQUARES_ON_CHESS_BOARD>   // Previous destination square
+        m_table;
+};
+
+template <bool is_malus>
+void history_gravity_update(History_Score_Storage_Type&      selected_entry,
+                            const History_Score_Storage_Type change,
+                            const History_Score_Storage_Type min_bonus,
+                            const History_Score_Storage_Type max_bonus)
+{
     // Clamp the bonus before gravity is applied.
     const History_Score_Storage_Type clamped_change =
-        std::clamp(change, MIN_QUIET_HISTORY_BONUS, MAX_QUIET_HISTORY_BONUS);
+        std::clamp(change, min_bonus, max_bonus);
 
     // History gravity is simply the closer you are to the max history value,
     // the more the update is saturated.
@@ -177,6 +269,34 @@ void Quiet_History_Table::gravity_update(
     }
 }
 
+template <bool is_malus>
+void Quiet_History_Table::gravity_update(
+    const Chess_Move&                move,
+    const History_Score_Storage_Type change)
+{
+    auto& selected_entry = m_table[move.moving_piece][move.destination_square];
+
+    history_gravity_update<is_malus>(selected_entry,
+                                     change,
+                                     MIN_QUIET_HISTORY_BONUS,
+                                     MAX_QUIET_HISTORY_BONUS);
+}
+
+template <bool is_malus>
+void Butterfly_History_Table::gravity_update(
+    const PIECE_COLOR                side_to_move,
+    const Chess_Move&                move,
+    const History_Score_Storage_Type change)
+{
+    auto& selected_entry =
+        m_table[side_to_move][move.source_square][move.destination_square];
+
+    history_gravity_update<is_malus>(selected_entry,
+                                     change,
+                                     MIN_QUIET_HISTORY_BONUS,
+                                     MAX_QUIET_HISTORY_BONUS);
+}
+
 template <bool is_malus>
 void Capture_History_Table::gravity_update(
     const Chess_Move&                move,
@@ -185,28 +305,10 @@ void Capture_History_Table::gravity_update(
     auto& selected_entry = m_table[move.moving_piece][move.destination_square]
                                   [move.captured_piece];
 
-    // Clamp the bonus before gravity is applied.
-    const History_Score_Storage_Type clamped_change =
-        std::clamp(change,
-                   MIN_CAPTURE_HISTORY_BONUS,
-                   MAX_CAPTURE_HISTORY_BONUS);
-
-    // History gravity is simply the closer you are to the max history value,
-    // the more the update is saturated.
-    const History_Score_Storage_Type gravitized_change =
-        static_cast<History_Score_Storage_Type>(
-            static_cast<double>(clamped_change)
-            * (1.0
-               - std::abs(static_cast<double>(std::abs(selected_entry))
-                          / static_cast<double>(is_malus ? MIN_HISTORY
-                                                         : MAX_HISTORY))));
-
-    // Select whether the bonus is applied as a penalty or not at compile-time.
-    if constexpr (is_malus) { selected_entry -= gravitized_change; }
-    else
-    {
-        selected_entry += gravitized_change;
-    }
+    history_gravity_update<is_malus>(selected_entry,
+                                     change,
+                                     MIN_CAPTURE_HISTORY_BONUS,
+                                     MAX_CAPTURE_HISTORY_BONUS);
 }
 
 template <std::size_t STACK_SIZE>
@@ -223,8 +325,7 @@ void Quiet_Continuation_History_Stack<STACK_SIZE>::bind_to_history_table(
 }
 
 template <std::size_t STACK_SIZE>
-History_Score_Storage_Type
-Quiet_Continuation_History_Stack<STACK_SIZE>::get_score(
+int32_t Quiet_Continuation_History_Stack<STACK_SIZE>::get_score(
     const Chess_Move& move) const
 {
     const std::size_t ply = stack.size();
@@ -236,7 +337,7 @@ Quiet_Continuation_History_Stack<STACK_SIZE>::get_score(
                                 - static_cast<int64_t>(
                                     QUIET_CONTINUATION_HISTORY_LOOKBACK_DEPTH);
 
-    History_Score_Storage_Type score = 0;
+    int32_t score = 0;
     if ((start >= 0) && (end >= 0))
     {
         for (int64_t i = start; i >= end; --i)
@@ -264,8 +365,7 @@ void Capture_Continuation_History_Stack<STACK_SIZE>::bind_to_history_table(
 }
 
 template <std::size_t STACK_SIZE>
-History_Score_Storage_Type
-Capture_Continuation_History_Stack<STACK_SIZE>::get_score(
+int32_t Capture_Continuation_History_Stack<STACK_SIZE>::get_score(
     const Chess_Move& move) const
 {
     const std::size_t ply = stack.size();
@@ -278,7 +378,7 @@ Capture_Continuation_History_Stack<STACK_SIZE>::get_score(
                   - static_cast<int64_t>(
                       CAPTURE_CONTINUATION_HISTORY_LOOKBACK_DEPTH);
 
-    History_Score_Storage_Type score = 0;
+    int32_t score = 0;
     if ((start >= 0) && (end >= 0))
     {
         for (int64_t i = start; i >= end; --i)
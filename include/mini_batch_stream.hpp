@@ -0,0 +1,102 @@
+#pragma once
+
+#include <future>
+#include <istream>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "batch_evaluate.hpp"
+#include "dataset.hpp"
+
+// The evaluation features of the positions are extracted once when the dataset
+// is loaded so, the tuner never needs the positions themselves.
+struct Mini_Batch
+{
+    Evaluation_Batch    features;
+    std::vector<double> scores;
+};
+
+// The bytes a position takes in a mini-batch, its features and its score.
+constexpr std::size_t MINI_BATCH_BYTES_PER_POSITION =
+    (NUM_OF_PLAYERS * NUM_OF_UNIQUE_PIECES_PER_PLAYER
+     * (sizeof(uint64_t) + (NUM_OF_MOBILITY_TERMS * sizeof(uint8_t))))
+    + sizeof(PIECE_COLOR) + sizeof(double);
+
+// Extracts the evaluation features and the scores of the positions.
+Mini_Batch create_mini_batch(const std::span<const Packed_Position> positions);
+
+// =============================================================================
+// Mini-Batch Stream Class
+//
+// Streams the mini-batches of a range of positions of a binary dataset without
+// ever holding more than a window of packed positions and the mini-batches of
+// features in memory. While the caller trains on its mini-batches, the next one
+// is prefetched on a background thread. The memory budget covers the window,
+// the prefetched mini-batch and the given number of mini-batches the caller
+// holds at once, the rest of it is split into windows. A shuffled pass visits
+// the windows in a random order and shuffles the positions within every window.
+//
+// Several streams may read the same dataset, the reads are serialized by the
+// dataset's mutex.
+// =============================================================================
+class Mini_Batch_Stream
+{
+  public:
+
+    // Throws if the memory budget doesn't fit a window of one mini-batch.
+    Mini_Batch_Stream(std::istream&     dataset,
+                      std::mutex&       dataset_mutex,
+                      const uint64_t    first_position,
+                      const uint64_t    num_of_positions,
+                      const std::size_t mini_batch_size,
+                      const std::size_t memory_budget,
+                      const std::size_t num_of_mini_batches_held = 1);
+
+    // Waits for the prefetch in progress (if any) since it uses the stream.
+    ~Mini_Batch_Stream();
+
+    Mini_Batch_Stream(const Mini_Batch_Stream&)            = delete;
+    Mini_Batch_Stream& operator=(const Mini_Batch_Stream&) = delete;
+
+    uint64_t    get_num_of_positions() const { return m_num_of_positions; }
+    std::size_t get_num_of_mini_batches() const;
+
+    // Starts a pass over the positions at the given mini-batch of the pass.
+    // The order of a shuffled pass is fully determined by the seed such that,
+    // a pass started again with the same seed yields the same mini-batches.
+    void start_pass(const bool        shuffle_pass,
+                    const uint64_t    seed,
+                    const std::size_t first_mini_batch = 0);
+
+    // Moves the next mini-batch of the pass into the given mini-batch. Returns
+    // false once the pass is over.
+    bool next(Mini_Batch& mini_batch);
+
+  private:
+
+    std::istream& m_dataset;
+    std::mutex&   m_dataset_mutex;
+    uint64_t      m_first_position;
+    uint64_t      m_num_of_positions;
+    std::size_t   m_mini_batch_size;
+    std::size_t   m_window_size; // In positions, a multiple of the mini-batch.
+
+    bool                         m_shuffle;
+    uint64_t                     m_seed;
+    std::vector<std::size_t>     m_window_order;
+    std::size_t                  m_next_window;
+    std::vector<Packed_Position> m_window;
+    std::size_t                  m_next_position_in_window;
+
+    std::future<std::optional<Mini_Batch>> m_prefetch;
+
+    std::size_t get_num_of_windows() const;
+    std::size_t get_num_of_positions_in_window(const std::size_t window) const;
+
+    void                      load_window(const std::size_t window);
+    std::optional<Mini_Batch> load_next_mini_batch();
+    void                      prefetch_next_mini_batch();
+    void                      wait_for_prefetch();
+};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+
 #include "chess_board.hpp"
 #include "chess_move.hpp"
 #include "globals.hpp"
@@ -27,7 +29,10 @@ class Move_Ordering
         const Quiet_Continuation_History_Stack<CONT_HIST_STACK_SIZE>&
             q_cont_hist_stack,
         const Capture_Continuation_History_Stack<CONT_HIST_STACK_SIZE>&
-            c_cont_hist_stack);
+                                       c_cont_hist_stack,
+        const Butterfly_History_Table& main_history,
+        const Killer_Moves&            killer_moves,
+        const Chess_Move&              counter_move);
 
     Move_Generation_List&  get_sorted_moves();
     Moves_Bitboard_Matrix& get_moves_matrix();
@@ -49,10 +54,17 @@ class Move_Ordering
     const Optional_Reference<
         const Capture_Continuation_History_Stack<CONT_HIST_STACK_SIZE>>
         m_c_cont_hist_stack;
+    const Optional_Reference<const Butterfly_History_Table> m_main_history;
+    const Optional_Reference<const Killer_Moves>            m_killer_moves;
+    Chess_Move                                              m_counter_move;
 
     static mvv_lva_array generate_mvv_lva_array();
     void                 move_scorer();
 
+    // Killer moves rank by their slot and the counter move ranks after them.
+    std::size_t get_refutation_rank(const Chess_Move& move) const;
+    void        order_refutations();
+
     inline static mvv_lva_array m_mvv_lva_array =
         Move_Ordering<CONT_HIST_STACK_SIZE>::generate_mvv_lva_array();
 };
@@ -72,12 +84,18 @@ Move_Ordering<CONT_HIST_STACK_SIZE>::Move_Ordering(
     const Quiet_Continuation_History_Stack<CONT_HIST_STACK_SIZE>&
         q_cont_hist_stack,
     const Capture_Continuation_History_Stack<CONT_HIST_STACK_SIZE>&
-        c_cont_hist_stack) :
+                                   c_cont_hist_stack,
+    const Butterfly_History_Table& main_history,
+    const Killer_Moves&            killer_moves,
+    const Chess_Move&              counter_move) :
     m_chess_board(cb),
     m_hash_move(hash_move),
     m_see(cb),
     m_q_cont_hist_stack(q_cont_hist_stack),
-    m_c_cont_hist_stack(c_cont_hist_stack)
+    m_c_cont_hist_stack(c_cont_hist_stack),
+    m_main_history(main_history),
+    m_killer_moves(killer_moves),
+    m_counter_move(counter_move)
 {
 }
 
@@ -113,6 +131,8 @@ Move_Generation_List& Move_Ordering<CONT_HIST_STACK_SIZE>::get_sorted_moves()
     {
         move_scorer();
         m_move_list.sort();
+
+        if (m_killer_moves.has_ref()) { order_refutations(); }
     }
     return m_move_list;
 }
@@ -145,13 +165,20 @@ mvv_lva_array Move_Ordering<CONT_HIST_STACK_SIZE>::generate_mvv_lva_array()
 template <std::size_t CONT_HIST_STACK_SIZE>
 void Move_Ordering<CONT_HIST_STACK_SIZE>::move_scorer()
 {
+    // The score of the hash move is above every other score.
+    constexpr int32_t MAX_NON_HASH_MOVE_SCORE =
+        (std::numeric_limits<Move_Score>::max() - 1);
+
     for (Chess_Move& move : m_move_list)
     {
+        // The history terms are summed in 32 bits since, their sum can be
+        // outside the range of a move score.
+        int32_t score = move.score;
+
         // For capture moves, apply MVV LVA score.
         if (move.is_capture)
         {
-            move.score =
-                m_mvv_lva_array[move.moving_piece][move.captured_piece];
+            score = m_mvv_lva_array[move.moving_piece][move.captured_piece];
 
             // move.score +=
             //     m_see.evaluate(move.destination_square, move.moving_piece,
@@ -162,23 +189,38 @@ void Move_Ordering<CONT_HIST_STACK_SIZE>::move_scorer()
         // same as the victim, both are pawns.
         if (move.is_en_passant)
         {
-            move.score = m_mvv_lva_array[move.moving_piece][move.moving_piece];
+            score = m_mvv_lva_array[move.moving_piece][move.moving_piece];
         }
 
         // For quiet moves that induce a beta cutoff, apply continuation history
         // score.
         if (move.is_quiet_move() && m_q_cont_hist_stack.has_ref())
         {
-            move.score += m_q_cont_hist_stack.get_ref().get_score(move);
+            score += m_q_cont_hist_stack.get_ref().get_score(move);
+        }
+
+        // For quiet moves, apply the main history score of the side to move
+        // which, unlike continuation history, is available at every ply.
+        if (move.is_quiet_move() && m_main_history.has_ref())
+        {
+            score += m_main_history.get_ref().get(
+                m_chess_board.get_side_to_move(),
+                move);
         }
 
         // For capture moves that induce a beta cutoff, apply continuation
         // history score.
         if (move.is_capture && m_c_cont_hist_stack.has_ref())
         {
-            move.score += m_c_cont_hist_stack.get_ref().get_score(move);
+            score += m_c_cont_hist_stack.get_ref().get_score(move);
         }
 
+        // The sum is saturated below the hash move's score.
+        move.score = static_cast<Move_Score>(
+            std::clamp<int32_t>(score,
+                                std::numeric_limits<Move_Score>::min(),
+                                MAX_NON_HASH_MOVE_SCORE));
+
         // For the hash move, give it the maximum score to ensure it is sorted
         // to the front. If the hash move is not found, it won't be scored (e.g.
         // if move is Chess_Move()).
@@ -189,6 +231,53 @@ void Move_Ordering<CONT_HIST_STACK_SIZE>::move_scorer()
     }
 }
 
+template <std::size_t CONT_HIST_STACK_SIZE>
+std::size_t Move_Ordering<CONT_HIST_STACK_SIZE>::get_refutation_rank(
+    const Chess_Move& move) const
+{
+    if (!move.is_quiet_move()) { return (NUM_OF_KILLER_MOVES + 1); }
+
+    const std::size_t killer_slot = m_killer_moves.get_ref().find(move);
+    if (killer_slot != NUM_OF_KILLER_MOVES) { return killer_slot; }
+
+    if (move.is_same_move(m_counter_move)) { return NUM_OF_KILLER_MOVES; }
+
+    return (NUM_OF_KILLER_MOVES + 1);
+}
+
+// The killer and counter moves are a stage of their own - they are moved in
+// front of the first quiet move (other than the hash move) of the sorted list
+// such that, the likely refutations of the ply are searched before the quiets
+// ordered by history.
+template <std::size_t CONT_HIST_STACK_SIZE>
+void Move_Ordering<CONT_HIST_STACK_SIZE>::order_refutations()
+{
+    constexpr std::size_t NOT_A_REFUTATION = (NUM_OF_KILLER_MOVES + 1);
+
+    Chess_Move* const first_quiet =
+        std::find_if(m_move_list.begin(),
+                     m_move_list.end(),
+                     [this](const Chess_Move& move)
+                     {
+                         return move.is_quiet_move()
+                             && (!move.is_same_move(m_hash_move));
+                     });
+
+    Chess_Move* const refutations_end = std::stable_partition(
+        first_quiet,
+        m_move_list.end(),
+        [this](const Chess_Move& move)
+        { return (get_refutation_rank(move) != NOT_A_REFUTATION); });
+
+    std::stable_sort(first_quiet,
+                     refutations_end,
+                     [this](const Chess_Move& a, const Chess_Move& b)
+                     {
+                         return (get_refutation_rank(a)
+                                 < get_refutation_rank(b));
+                     });
+}
+
 template <std::size_t CONT_HIST_STACK_SIZE>
 bool Move_Ordering<CONT_HIST_STACK_SIZE>::is_side_to_move_in_check() const
 {
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#if defined(__AVX512BW__) || defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+#include "bitboard.hpp"
+#include "globals.hpp"
+#include "square.hpp"
+
+// =============================================================================
+// Efficiently Updatable Neural Network (NNUE) Architecture
+// =============================================================================
+// The network is a (768 -> N)x2 -> 1 perceptron. The 768 input features are
+// every (color, piece, square) triple from the perspective of one side; the
+// feature transformer maps them to N hidden neurons per perspective. The side
+// to move's accumulator is concatenated with the opposing side's accumulator,
+// passed through a clipped ReLU and reduced to a single output neuron.
+constexpr std::size_t NNUE_INPUT_SIZE = (NUM_OF_PLAYERS
+                                         * NUM_OF_UNIQUE_PIECES_PER_PLAYER
+                                         * NUM_OF_SQUARES_ON_CHESS_BOARD);
+constexpr std::size_t NNUE_HIDDEN_SIZE = 256;
+
+// Quantization factors of the feature transformer (QA) and the output layer
+// (QB) and the scale of the output neuron in centipawns.
+constexpr int32_t NNUE_QA         = 255;
+constexpr int32_t NNUE_QB         = 64;
+constexpr int32_t NNUE_EVAL_SCALE = 400;
+
+using NNUE_Accumulator_Storage_Type = int16_t;
+using NNUE_Weight_Storage_Type      = int16_t;
+
+// =============================================================================
+// Network File Header
+// =============================================================================
+// The parameters of a network file are preceded by the magic number and the
+// input and hidden sizes of the network (little-endian) such that, a file of
+// another format or architecture is rejected instead of being read as weights.
+// "MTRXNNUE" when written in little-endian byte order.
+constexpr uint64_t NNUE_FILE_MAGIC = 0x45554E4E5852544D;
+
+struct NNUE_File_Header
+{
+    uint64_t magic       = NNUE_FILE_MAGIC;
+    uint32_t input_size  = NNUE_INPUT_SIZE;
+    uint32_t hidden_size = NNUE_HIDDEN_SIZE;
+};
+
+static_assert(sizeof(NNUE_File_Header) == 16,
+              "The network file header must not be padded.");
+
+// =============================================================================
+// Network Parameters
+// =============================================================================
+// Parameters are stored in the same order as they are laid out in the binary
+// network file after its header: feature weights, feature biases, output
+// weights and the output bias - all little-endian 16-bit integers. Square
+// indices in the file assume a1 = 0 (opposite to this engine's a8 = 0
+// convention) which is accounted for in NNUE_Accumulator::feature_index.
+struct NNUE_Network
+{
+    CACHE_ALIGN Multi_Array<NNUE_Weight_Storage_Type,
+                            NNUE_INPUT_SIZE,
+                            NNUE_HIDDEN_SIZE> feature_weights;
+    CACHE_ALIGN Multi_Array<NNUE_Weight_Storage_Type, NNUE_HIDDEN_SIZE>
+                feature_biases;
+    CACHE_ALIGN Multi_Array<NNUE_Weight_Storage_Type,
+                            NUM_OF_PLAYERS,
+                            NNUE_HIDDEN_SIZE> output_weights;
+    NNUE_Weight_Storage_Type                  output_bias;
+};
+
+// =============================================================================
+// Class:       NNUE
+// Description: Owner of the process-wide network. The network is loaded from a
+//              file given by the EvalFile UCI option; until a network is loaded
+//              the accumulators are not maintained and the hand-crafted
+//              evaluator remains the only available evaluator.
+// =============================================================================
+class NNUE
+{
+  public:
+
+    static bool load(const std::string& path);
+    static void unload();
+
+    static bool is_loaded() { return (s_network != nullptr); }
+
+    static const NNUE_Network& get_network() { return *s_network; }
+
+  private:
+
+    inline static std::unique_ptr<NNUE_Network> s_network = nullptr;
+};
+
+// =============================================================================
+// Class:       NNUE_Accumulator
+// Description: The output of the feature transformer for both perspectives.
+//              Since, a move only adds or removes a handful of features, the
+//              accumulator is incrementally updated by adding or subtracting
+//              the feature weight columns of the pieces that moved instead of
+//              recomputing the whole transformation.
+// =============================================================================
+class NNUE_Accumulator
+{
+  public:
+
+    void refresh(const Multi_Array<Bitboard,
+                                   NUM_OF_PLAYERS,
+                                   NUM_OF_UNIQUE_PIECES_PER_PLAYER>& pieces);
+
+    template <bool is_addition>
+    FORCE_INLINE void update_piece(const PIECE_COLOR color,
+                                   const PIECES      piece,
+                                   const Square      square);
+
+    int32_t forward(const PIECE_COLOR side_to_move) const;
+
+    bool operator==(const NNUE_Accumulator& other) const
+    {
+        return (m_values == other.m_values);
+    }
+
+  private:
+
+    CACHE_ALIGN Multi_Array<NNUE_Accumulator_Storage_Type,
+                            NUM_OF_PLAYERS,
+                            NNUE_HIDDEN_SIZE> m_values;
+
+    FORCE_INLINE static std::size_t feature_index(const PIECE_COLOR perspective,
+                                                  const PIECE_COLOR color,
+                                                  const PIECES      piece,
+                                                  const Square      square);
+};
+
+FORCE_INLINE std::size_t
+NNUE_Accumulator::feature_index(const PIECE_COLOR perspective,
+                                const PIECE_COLOR color,
+                                const PIECES      piece,
+                                const Square      square)
+{
+    // The network sees every position from the perspective's point of view -
+    // its own pieces come first and the board is flipped vertically for black.
+    // White's perspective flips too because the network file uses a1 = 0.
+    const std::size_t relative_color = (color != perspective);
+    const std::size_t relative_square =
+        (perspective == PIECE_COLOR::WHITE) ? (square.get_index() ^ 56)
+                                            : square.get_index();
+
+    return ((((relative_color * NUM_OF_UNIQUE_PIECES_PER_PLAYER) + piece)
+             * NUM_OF_SQUARES_ON_CHESS_BOARD)
+            + relative_square);
+}
+
+template <bool is_addition>
+FORCE_INLINE void NNUE_Accumulator::update_piece(const PIECE_COLOR color,
+                                                 const PIECES      piece,
+                                                 const Square      square)
+{
+    const NNUE_Network& network = NNUE::get_network();
+
+    for (uint8_t perspective = PIECE_COLOR::WHITE;
+         perspective <= PIECE_COLOR::BLACK;
+         ++perspective)
+    {
+        const std::size_t index =
+            feature_index((PIECE_COLOR) perspective, color, piece, square);
+
+        NNUE_Accumulator_Storage_Type* values = m_values[perspective].data.data();
+        const NNUE_Weight_Storage_Type* weights =
+            network.feature_weights[index].data.data();
+
+#if defined(__AVX512BW__)
+        for (std::size_t i = 0; i < NNUE_HIDDEN_SIZE; i += 32)
+        {
+            const __m512i v = _mm512_load_si512(values + i);
+            const __m512i w = _mm512_loadu_si512(weights + i);
+            _mm512_store_si512(values + i,
+                               is_addition ? _mm512_add_epi16(v, w)
+                                           : _mm512_sub_epi16(v, w));
+        }
+#elif defined(__AVX2__)
+        for (std::size_t i = 0; i < NNUE_HIDDEN_SIZE; i += 16)
+        {
+            const __m256i v =
+                _mm256_load_si256(reinterpret_cast<const __m256i*>(values + i));
+            const __m256i w = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(weights + i));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(values + i),
+                               is_addition ? _mm256_add_epi16(v, w)
+                                           : _mm256_sub_epi16(v, w));
+        }
+#else
+        for (std::size_t i = 0; i < NNUE_HIDDEN_SIZE; ++i)
+        {
+            if constexpr (is_addition) { values[i] += weights[i]; }
+            else
+            {
+                values[i] -= weights[i];
+            }
+        }
+#endif
+    }
+}
@@ -51,6 +51,14 @@ struct NLR_Parameters // NLR = Non-Linear Response
 constexpr double NON_LINEAR_RESPONSE_EPSILON = Matrex_FP_Int::precision();
 constexpr double NON_LINEAR_RESPONSE_T       = Matrex_FP_Int::safe_maximum();
 
+// A conversative clamp of the input of function G such that the shifts used in
+// calculating exp2() doesn't produce undefined behavior. This does not result
+// in changing the partials since the exponent clamp is large enough that it's
+// in the saturating region of sigmoid - where the derivatives are close to
+// zero.
+constexpr double NON_LINEAR_RESPONSE_G_EXPONENT_CLAMP =
+    15.0 / static_cast<double>(NON_LINEAR_RESPONSE_T);
+
 template <typename T>
 class Non_Linear_Response
 {
@@ -140,38 +148,28 @@ T Non_Linear_Response<T>::calculate_function_G(const T F) const
 {
     const T u = calculate_u(F);
 
-    // A conversative clamp such that the shifts used in calculating exp2()
-    // doesn't produce undefined behavior. This does not result in changing the
-    // partials since the exponent clamp is large enough that it's in the
-    // saturating region of sigmoid - where the derivatives are close to zero.
-    constexpr double G_EXPONENT_CLAMP =
-        15.0 / static_cast<double>(NON_LINEAR_RESPONSE_T);
+    constexpr double G_EXPONENT_CLAMP = NON_LINEAR_RESPONSE_G_EXPONENT_CLAMP;
 
     const T negative_u = -u;
 
+    // The clamp is recorded on the tape as a single node rather than taking
+    // a branch so, the structure of the graph doesn't depend on the position
+    // and it can be replayed by an AD_Compiled_Graph.
+    if constexpr (std::is_same_v<T, AD_Value>)
+    {
+        return (negative_u * NON_LINEAR_RESPONSE_T)
+            .clamped_logistic(G_EXPONENT_CLAMP * NON_LINEAR_RESPONSE_T);
+    }
+
     // -u > (positive clamp) means u is negative thus the denominator of
     // function G gets large and goes to zero.
     if (negative_u >= G_EXPONENT_CLAMP)
     {
-        if constexpr (std::is_same_v<T, AD_Value>)
-        {
-            return AD_Value::constant(u.tape, 0.0);
-        }
-        else
-        {
-            return explicit_fp_double_conversion<T>(0.0);
-        }
+        return explicit_fp_double_conversion<T>(0.0);
     }
     else if (negative_u <= -G_EXPONENT_CLAMP)
     {
-        if constexpr (std::is_same_v<T, AD_Value>)
-        {
-            return AD_Value::constant(u.tape, 1.0);
-        }
-        else
-        {
-            return explicit_fp_double_conversion<T>(1.0);
-        }
+        return explicit_fp_double_conversion<T>(1.0);
     }
 
     const T exponent = (negative_u * NON_LINEAR_RESPONSE_T);
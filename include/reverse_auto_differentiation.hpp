@@ -1,7 +1,9 @@
 #pragma once
 
-#include <memory>
-#include <deque>
+#include <bit>
+#include <cmath>
+#include <span>
+#include <vector>
 
 #include "globals.hpp"
 
@@ -42,234 +44,116 @@
 // tuner which needs to calculate the gradient of the evaluation function.
 // =============================================================================
 
-class AD_Node;
-
-//==============================================================================
-// Automatic Differentiation Adjoint Class
-//
-// This class is an abstraction of an adjoint update - it takes references to
-// the parent nodes and when called as a functor performs the backpropagation.
-// Notice, this class is just the parent class of the derived classes which
-// specify the functor definition depending on the operation in the
-// computational graph (e.g. pow, tanh, addition, multiplication, etc).
-//==============================================================================
-class AD_Adjoint
+// Every operation of the computational graph is one of these opcodes. The
+// backward pass switches on them rather than dispatching to per-operation
+// adjoint objects.
+enum class AD_OPCODE : uint8_t
 {
-  public:
-
-    AD_Adjoint();
-
-    AD_Adjoint(const double value);
-
-    AD_Adjoint(Optional_Reference<AD_Node> parent_node);
-
-    AD_Adjoint(Optional_Reference<AD_Node> left_node,
-               Optional_Reference<AD_Node> right_node);
-
-    virtual void operator()(MAYBE_UNUSED std::initializer_list<double> args) {};
-
-    double& value() { return m_value; } // Value of this node's adjoint.
-
-    const double& value() const { return m_value; }
-
-    auto& left_node() // Value of the left parent's adjoint.
-    {
-        MATREX_ASSERT(m_left_node.has_ref(),
-                      "Accessed AD Adjoint's left node that has an optional "
-                      "reference of no value.");
-        return m_left_node.get_ref();
-    }
-
-    auto& right_node() // Value of the right parent's adjoint.
-    {
-        MATREX_ASSERT(m_right_node.has_ref(),
-                      "Accessed AD Adjoint's right node that has an optional "
-                      "reference of no value.");
-        return m_right_node.get_ref();
-    }
-
-    void set_value(const double value);
-
-    AD_Adjoint operator+=(const AD_Adjoint& other);
-    AD_Adjoint operator-=(const AD_Adjoint& other);
-
-  private:
-
-    double                      m_value = 0.0;
-    Optional_Reference<AD_Node> m_left_node;
-    Optional_Reference<AD_Node> m_right_node;
-};
-
-class AD_Adjoint_No_Op : public AD_Adjoint
-{
-  public:
-
-    using AD_Adjoint::AD_Adjoint;
-
-    virtual void operator()(
-        MAYBE_UNUSED const std::initializer_list<double> args = {}) override;
-};
-
-class AD_Adjoint_Addition : public AD_Adjoint
-{
-  public:
-
-    using AD_Adjoint::AD_Adjoint;
-
-    virtual void operator()(
-        MAYBE_UNUSED const std::initializer_list<double> args = {}) override;
+    CONSTANT,
+    VARIABLE,
+    ADDITION,
+    SUBTRACTION,
+    MULTIPLICATION,
+    DIVISION,
+    NEGATION,
+    TANH,
+    EXP,
+    SQRT,
+    POW,
+    // A per-position scalar leaf; left holds the input slot.
+    INPUT,
+    // The sum of the 64 consecutive nodes starting at left over the squares
+    // of the bitboard in the sparse input slot held by right.
+    SPARSE_SUM,
+    // 1 / (exp(x) + 1) of left which saturates to exactly 0 or 1 once |x|
+    // reaches the value of the constant node right.
+    CLAMPED_LOGISTIC
 };
 
-class AD_Adjoint_Subtraction : public AD_Adjoint
-{
-  public:
-
-    using AD_Adjoint::AD_Adjoint;
+using AD_Node_Index = uint32_t;
 
-    virtual void operator()(
-        MAYBE_UNUSED const std::initializer_list<double> args = {}) override;
-};
+constexpr AD_Node_Index AD_NO_NODE = UINT32_MAX;
 
-class AD_Adjoint_Multiplication : public AD_Adjoint
-{
-  public:
-
-    using AD_Adjoint::AD_Adjoint;
-
-    virtual void operator()(
-        MAYBE_UNUSED const std::initializer_list<double> args = {}) override;
-};
-
-class AD_Adjoint_Division : public AD_Adjoint
-{
-  public:
-
-    using AD_Adjoint::AD_Adjoint;
-
-    virtual void operator()(
-        MAYBE_UNUSED const std::initializer_list<double> args = {}) override;
-};
-
-class AD_Adjoint_Negation : public AD_Adjoint
-{
-  public:
-
-    using AD_Adjoint::AD_Adjoint;
-
-    virtual void operator()(
-        MAYBE_UNUSED const std::initializer_list<double> args = {}) override;
-};
-
-class AD_Adjoint_Tanh : public AD_Adjoint
-{
-  public:
-
-    using AD_Adjoint::AD_Adjoint;
-
-    virtual void
-    operator()(MAYBE_UNUSED const std::initializer_list<double> args) override;
-};
-
-class AD_Adjoint_Exp : public AD_Adjoint
-{
-  public:
-
-    using AD_Adjoint::AD_Adjoint;
-
-    virtual void
-    operator()(MAYBE_UNUSED const std::initializer_list<double> args) override;
-};
-
-class AD_Adjoint_Sqrt : public AD_Adjoint
-{
-  public:
-
-    using AD_Adjoint::AD_Adjoint;
-
-    virtual void
-    operator()(MAYBE_UNUSED const std::initializer_list<double> args) override;
-};
-
-class AD_Adjoint_Pow : public AD_Adjoint
+//==============================================================================
+// Automatic Differentiation Node Struct
+//
+// A plain-old-data node of the computational graph; it's value, the adjoint
+// (partial derivative of the output with respect to this node) and the indices
+// of it's parent nodes on the tape.
+//==============================================================================
+struct AD_Node
 {
-  public:
-
-    using AD_Adjoint::AD_Adjoint;
-
-    virtual void
-    operator()(MAYBE_UNUSED const std::initializer_list<double> args) override;
+    double        value   = 0.0;
+    double        adjoint = 0.0;
+    AD_Node_Index left    = AD_NO_NODE;
+    AD_Node_Index right   = AD_NO_NODE;
+    AD_OPCODE     opcode  = AD_OPCODE::CONSTANT;
 };
 
-using AD_Adjoint_Pointer = std::unique_ptr<AD_Adjoint>;
-
 //==============================================================================
-// Automatic Differentiation Node Class
+// Automatic Differentiation Tape Class
 //
-// This class is an abstraction of a computational graph's node which is an
-// element of the AD Tape class.
+// This class is an abstraction of a computational graph. The nodes live in a
+// contiguous arena which keeps it's capacity when the tape is cleared or
+// rewound so, recording the graph of the next position does not allocate.
+// Nodes reference each other by index since the arena may reallocate.
 //==============================================================================
-class AD_Node
+class AD_Tape
 {
   public:
 
-    AD_Node();
-
-    AD_Node(const double value);
-
-    AD_Node(const double value, AD_Adjoint_Pointer adjoint);
-
-    AD_Node(const double       value,
-            AD_Adjoint_Pointer adjoint,
-            const std::size_t  weight_index);
-
-    double& value();
-
-    const double& value() const;
+    AD_Tape();
 
-    auto& adjoint() { return (*m_adjoint); }
+    AD_Node_Index push(const AD_OPCODE     opcode,
+                       const double        value,
+                       const AD_Node_Index left  = AD_NO_NODE,
+                       const AD_Node_Index right = AD_NO_NODE);
 
-    const auto& adjoint() const { return (*m_adjoint); }
+    // Propagates the adjoints from the output node back to the start of the
+    // tape.
+    void backward(const AD_Node_Index output);
 
-    const auto& weight_index() const { return m_weight_index; }
+    // Removes every node recorded after the first size nodes and zeroes the
+    // adjoints of the remaining nodes. Used to keep the weight variables on
+    // the tape between positions.
+    void rewind(const std::size_t size);
 
-  private:
+    void reserve(const std::size_t capacity);
 
-    double             m_value   = 0.0;
-    AD_Adjoint_Pointer m_adjoint = nullptr;
+    void clear();
 
-    int64_t m_weight_index = -1;
-};
+    void set_sparse_input(const uint32_t slot, const uint64_t bitboard);
 
-//==============================================================================
-// Automatic Differentiation Node Class
-//
-// This class is an abstraction of a computational graph.
-//==============================================================================
-class AD_Tape
-{
-  public:
+    uint64_t get_sparse_input(const uint32_t slot) const
+    {
+        return m_sparse_inputs[slot];
+    }
 
-    AD_Tape();
+    std::size_t size() const { return m_nodes.size(); }
 
-    std::reference_wrapper<AD_Node> push(AD_Node&& node);
+    AD_Node& operator[](const AD_Node_Index index) { return m_nodes[index]; }
 
-    void clear();
+    const AD_Node& operator[](const AD_Node_Index index) const
+    {
+        return m_nodes[index];
+    }
 
-    auto begin() { return m_tape.begin(); }
+    auto begin() { return m_nodes.begin(); }
 
-    auto end() { return m_tape.end(); }
+    auto end() { return m_nodes.end(); }
 
-    auto begin() const { return m_tape.begin(); }
+    auto begin() const { return m_nodes.begin(); }
 
-    auto end() const { return m_tape.end(); }
+    auto end() const { return m_nodes.end(); }
 
   private:
 
-    std::deque<AD_Node> m_tape;
+    std::vector<AD_Node>  m_nodes;
+    std::vector<uint64_t> m_sparse_inputs;
 };
 
 //==============================================================================
-// Automatic Differentiation Node Class
+// Automatic Differentiation Value Struct
 //
 // This class is the data type for each evaluation weight when passed into the
 // evaluator. Through operator and function overloading, it automatically fills
@@ -279,94 +163,132 @@ class AD_Tape
 struct AD_Value
 {
     mutable Optional_Reference<AD_Tape> tape;
-    Optional_Reference<AD_Node>         node;
+    AD_Node_Index                       node = AD_NO_NODE;
 
     double& value()
     {
         MATREX_ASSERT(
-            node.has_ref(),
+            (node != AD_NO_NODE),
             "Tried to access a node's value via AD Value but it has no value.");
 
-        return node.get_ref().value();
+        return tape.get_ref()[node].value;
     }
 
     const double& value() const
     {
         MATREX_ASSERT(
-            node.has_ref(),
+            (node != AD_NO_NODE),
             "Tried to access a node's value via AD Value but it has no value.");
 
-        return node.get_ref().value();
+        return tape.get_ref()[node].value;
     }
 
     static AD_Value constant(Optional_Reference<AD_Tape> tape, double value)
     {
         return {.tape = tape,
-                .node = tape.get_ref().push(
-                    AD_Node(value, std::make_unique<AD_Adjoint_No_Op>()))};
+                .node = tape.get_ref().push(AD_OPCODE::CONSTANT, value)};
     }
 
-    static AD_Value variable(Optional_Reference<AD_Tape> tape,
-                             double                      value,
-                             std::size_t                 weight_index)
+    static AD_Value variable(Optional_Reference<AD_Tape> tape, double value)
     {
         return {.tape = tape,
-                .node = tape.get_ref().push(
-                    AD_Node(value,
-                            std::make_unique<AD_Adjoint_No_Op>(),
-                            weight_index))};
+                .node = tape.get_ref().push(AD_OPCODE::VARIABLE, value)};
     }
 
-    AD_Value operator+(const AD_Value& other) const
+    // A leaf whose value is replaced per position when the graph is replayed
+    // by an AD_Compiled_Graph.
+    static AD_Value
+    input(Optional_Reference<AD_Tape> tape, double value, uint32_t slot)
+    {
+        return {.tape = tape,
+                .node = tape.get_ref().push(AD_OPCODE::INPUT, value, slot)};
+    }
+
+    // The sum of the 64 values following (and including) this one over the
+    // squares of the bitboard. The bitboard is a per-position input like the
+    // leaves created by input().
+    AD_Value sparse_sum(const uint64_t bitboard, const uint32_t slot) const
     {
-        double result_value = value() + other.value();
+        AD_Tape& t = tape.get_ref();
+
+        double sum = 0.0;
+        for (uint64_t bits = bitboard; bits != 0; bits &= (bits - 1))
+        {
+            sum += t[node + std::countr_zero(bits)].value;
+        }
+
+        t.set_sparse_input(slot, bitboard);
 
         return {.tape = this->tape,
-                .node = tape.get_ref().push(AD_Node(
-                    result_value,
-                    std::make_unique<AD_Adjoint_Addition>(node, other.node)))};
+                .node = t.push(AD_OPCODE::SPARSE_SUM, sum, node, slot)};
     }
 
-    AD_Value operator-(const AD_Value& other) const
+    // Branch free (on the tape) version of 1 / (exp(x) + 1) that saturates
+    // once |x| >= clamp.
+    AD_Value clamped_logistic(const double clamp) const
     {
-        double result_value = value() - other.value();
+        const double x = value();
+        double       result;
+
+        if (x >= clamp) { result = 0.0; }
+        else if (x <= -clamp) { result = 1.0; }
+        else
+        {
+            result = 1.0 / (std::exp(x) + 1.0);
+        }
+
+        return binary_operation(AD_OPCODE::CLAMPED_LOGISTIC,
+                                result,
+                                AD_Value::constant(this->tape, clamp));
+    }
 
-        return {
-            .tape = this->tape,
-            .node = tape.get_ref().push(AD_Node(
-                result_value,
-                std::make_unique<AD_Adjoint_Subtraction>(node, other.node)))};
+    AD_Value operator+(const AD_Value& other) const
+    {
+        return binary_operation(AD_OPCODE::ADDITION,
+                                value() + other.value(),
+                                other);
     }
 
-    AD_Value operator/(const AD_Value& other) const
+    AD_Value operator-(const AD_Value& other) const
     {
-        double result_value = value() / other.value();
+        return binary_operation(AD_OPCODE::SUBTRACTION,
+                                value() - other.value(),
+                                other);
+    }
 
-        return {.tape = this->tape,
-                .node = tape.get_ref().push(AD_Node(
-                    result_value,
-                    std::make_unique<AD_Adjoint_Division>(node, other.node)))};
+    AD_Value operator/(const AD_Value& other) const
+    {
+        return binary_operation(AD_OPCODE::DIVISION,
+                                value() / other.value(),
+                                other);
     }
 
     AD_Value operator*(const AD_Value& other) const
     {
-        double result_value = value() * other.value();
-
-        return {.tape = this->tape,
-                .node = tape.get_ref().push(AD_Node(
-                    result_value,
-                    std::make_unique<AD_Adjoint_Multiplication>(node,
-                                                                other.node)))};
+        return binary_operation(AD_OPCODE::MULTIPLICATION,
+                                value() * other.value(),
+                                other);
     }
 
     AD_Value operator-() const
     {
-        double result_value = -value();
+        return unary_operation(AD_OPCODE::NEGATION, -value());
+    }
 
+    AD_Value unary_operation(const AD_OPCODE opcode,
+                             const double    result_value) const
+    {
         return {.tape = this->tape,
-                .node = tape.get_ref().push(
-                    AD_Node(result_value,
-                            std::make_unique<AD_Adjoint_Negation>(node)))};
+                .node = tape.get_ref().push(opcode, result_value, node)};
+    }
+
+    AD_Value binary_operation(const AD_OPCODE opcode,
+                              const double    result_value,
+                              const AD_Value& other) const
+    {
+        return {
+            .tape = this->tape,
+            .node = tape.get_ref().push(opcode, result_value, node, other.node)};
     }
 
     AD_Value operator+=(const AD_Value& other)
@@ -515,3 +437,82 @@ constexpr AD_Value operator*(const T other, const AD_Value& value)
 {
     return AD_Value::constant(value.tape, other) * value;
 }
+
+// Number of positions a compiled graph evaluates per replay.
+constexpr std::size_t AD_COMPILED_GRAPH_LANES = 64;
+
+// The value and adjoint of node i of a compiled graph for lane j are at
+// [(i * AD_COMPILED_GRAPH_LANES) + j], the inputs are laid out the same way by
+// their slot.
+struct AD_Replay_Buffers
+{
+    std::vector<double>   values;
+    std::vector<double>   adjoints;
+    std::vector<double>   inputs;
+    std::vector<uint64_t> sparse_inputs;
+};
+
+//==============================================================================
+// Automatic Differentiation Compiled Graph Class
+//
+// A tape recorded once and replayed for many positions. The structure of the
+// recorded graph must not depend on the position - every per-position value
+// has to enter the graph as an INPUT or SPARSE_SUM node - so, the opcodes and
+// operand indices are reused and only the values change. Each replay sweeps
+// every node over AD_COMPILED_GRAPH_LANES positions at once with loops the
+// compiler can vectorize. The variables must be the first nodes of the tape.
+//==============================================================================
+class AD_Compiled_Graph
+{
+  public:
+
+    AD_Compiled_Graph();
+
+    AD_Compiled_Graph(const AD_Tape&      tape,
+                      const std::size_t   num_of_variables,
+                      const AD_Node_Index output);
+
+    AD_Replay_Buffers create_buffers() const;
+
+    // Broadcasts the variables to every lane.
+    void load_variables(const std::span<const double> variables,
+                        AD_Replay_Buffers&            buffers) const;
+
+    void forward(AD_Replay_Buffers& buffers) const;
+
+    // Seeds the output adjoint of every lane, propagates them back and sums
+    // the adjoints of the variables across the lanes into variable_adjoints.
+    void backward(AD_Replay_Buffers&            buffers,
+                  const std::span<const double> output_adjoints,
+                  const std::span<double>       variable_adjoints) const;
+
+    const double* output(const AD_Replay_Buffers& buffers) const
+    {
+        return &buffers.values[m_output * AD_COMPILED_GRAPH_LANES];
+    }
+
+    std::size_t num_of_variables() const { return m_num_of_variables; }
+
+    std::size_t num_of_inputs() const { return m_num_of_inputs; }
+
+    std::size_t num_of_sparse_inputs() const { return m_num_of_sparse_inputs; }
+
+  private:
+
+    std::vector<AD_Node> m_program;
+    std::size_t          m_num_of_variables     = 0;
+    std::size_t          m_num_of_inputs        = 0;
+    std::size_t          m_num_of_sparse_inputs = 0;
+    AD_Node_Index        m_output               = 0;
+
+    // The row of the node for every lane, operands that aren't nodes (no node
+    // or an input slot past the end of the program) have no row.
+    template <typename T>
+    T* operand(T* const rows, const AD_Node_Index index) const
+    {
+        return (index < m_program.size())
+                 ? &rows[static_cast<std::size_t>(index)
+                         * AD_COMPILED_GRAPH_LANES]
+                 : nullptr;
+    }
+};
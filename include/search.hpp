@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <string_view>
 
 #include "chess_board.hpp"
 #include "chess_move.hpp"
@@ -11,11 +12,11 @@
 #include "timer.hpp"
 #include "transposition_table.hpp"
 #include "correction_history_table.hpp"
+#include "evaluate.hpp"
 #include "history.hpp"
 
-// 5898.5 is the theoritical maximum number of moves (2-ply) in a chess game.
-constexpr uint16_t MAX_SEARCH_DEPTH = (5899 * NUM_OF_PLAYERS);
-
+// The deepest ply the search stacks hold, nodes at it are resolved by
+// quiescence search.
 constexpr uint16_t MAX_SEARCH_DEPTH_SOFT_LIMIT = 256;
 
 constexpr uint16_t QUIESCENCE_SEARCH_DEPTH = 0;
@@ -27,6 +28,94 @@ constexpr std::size_t CORRECTION_HISTORY_TABLE_SIZE = 16384;
 constexpr History_Score_Storage_Type QUIET_HISTORY_PRUNING_THRESHOLD   = -50;
 constexpr History_Score_Storage_Type CAPTURE_HISTORY_PRUNING_THRESHOLD = -35;
 
+// The null move is searched with a reduction of NULL_MOVE_BASE_REDUCTION plus
+// one ply for every NULL_MOVE_DEPTH_REDUCTION_DIVISOR plies of depth.
+constexpr uint16_t NULL_MOVE_PRUNING_MIN_DEPTH       = 3;
+constexpr uint16_t NULL_MOVE_BASE_REDUCTION          = 3;
+constexpr uint16_t NULL_MOVE_DEPTH_REDUCTION_DIVISOR = 4;
+
+// From this depth on, a null move cutoff is only trusted once a reduced search
+// of the position without null moves fails high too.
+constexpr uint16_t NULL_MOVE_VERIFICATION_MIN_DEPTH = 12;
+
+// The late move reduction of a quiet move is
+// LATE_MOVE_REDUCTION_BASE + ln(depth) * ln(move number) /
+// LATE_MOVE_REDUCTION_DIVISOR plies, one ply less in PV nodes and one ply less
+// or more for every LATE_MOVE_REDUCTION_HISTORY_DIVISOR of history.
+constexpr double   LATE_MOVE_REDUCTION_BASE               = 0.75;
+constexpr double   LATE_MOVE_REDUCTION_DIVISOR            = 2.25;
+constexpr uint16_t LATE_MOVE_REDUCTION_MIN_DEPTH          = 3;
+constexpr uint16_t LATE_MOVE_REDUCTION_MIN_MOVES_SEARCHED = 2;
+constexpr int32_t  LATE_MOVE_REDUCTION_HISTORY_DIVISOR    = 8192;
+
+// From this depth on, a node without a transposition table move is searched one
+// ply shallower.
+constexpr uint16_t INTERNAL_ITERATIVE_REDUCTION_MIN_DEPTH = 4;
+
+// From ASPIRATION_WINDOW_MIN_DEPTH on, iterative deepening searches a window of
+// ASPIRATION_WINDOW_INITIAL_DELTA on each side of the previous iteration's
+// score. The delta doubles every time the search fails outside the window.
+constexpr uint16_t      ASPIRATION_WINDOW_MIN_DEPTH = 4;
+constexpr Matrex_FP_Int ASPIRATION_WINDOW_INITIAL_DELTA =
+    Matrex_FP_Int::from_integer(25);
+
+// The margins of the pruning stages before the move loop. Every parameter is a
+// UCI spin option such that, they can be tuned by SPSA. A stage with a maximum
+// depth of 0 is disabled.
+enum SEARCH_PARAMETER : uint8_t
+{
+    REVERSE_FUTILITY_PRUNING_MAX_DEPTH,
+    REVERSE_FUTILITY_PRUNING_QUADRATIC_MARGIN,
+    REVERSE_FUTILITY_PRUNING_LINEAR_MARGIN,
+    REVERSE_FUTILITY_PRUNING_CONSTANT_MARGIN,
+    RAZORING_MAX_DEPTH,
+    RAZORING_LINEAR_MARGIN,
+    RAZORING_CONSTANT_MARGIN,
+    NUM_OF_SEARCH_PARAMETERS
+};
+
+struct Search_Parameter_Definition
+{
+    std::string_view name; // The name of the UCI option.
+    int32_t          default_value;
+    int32_t          min;
+    int32_t          max;
+};
+
+constexpr Multi_Array<Search_Parameter_Definition, NUM_OF_SEARCH_PARAMETERS>
+    SEARCH_PARAMETER_DEFINITIONS = {
+        {"RFPMaxDepth", 6, 0, 16},
+        {"RFPQuadraticMargin", 2, 0, 64},
+        {"RFPLinearMargin", 32, 0, 256},
+        {"RFPConstantMargin", 16, 0, 256},
+        {"RazoringMaxDepth", 3, 0, 8},
+        {"RazoringLinearMargin", 200, 0, 1024},
+        {"RazoringConstantMargin", 250, 0, 1024}
+};
+
+class Search_Parameters
+{
+  public:
+
+    Search_Parameters();
+
+    int32_t operator[](const SEARCH_PARAMETER parameter) const
+    {
+        return m_values[parameter];
+    }
+
+    // Whether there is a parameter with the given name.
+    static bool contains(const std::string_view name);
+
+    // Sets the parameter with the given name to the value clamped to it's
+    // range. Returns false if there is no parameter with the given name.
+    bool set(const std::string_view name, const int32_t value);
+
+  private:
+
+    Multi_Array<int32_t, NUM_OF_SEARCH_PARAMETERS> m_values;
+};
+
 struct Time_Control
 {
     uint64_t time_remaining; // Time in milliseconds.
@@ -39,28 +128,49 @@ struct Search_Constraints
     bool                                      should_ignore_time;
     Multi_Array<Time_Control, NUM_OF_PLAYERS> time_controls;
     uint64_t                                  transposition_table_size;
+    bool                                      use_nnue_evaluation = false;
+    uint64_t                                  nodes               = 0;
+    bool                                      should_print_info   = true;
+    Search_Parameters                         parameters;
 
     bool is_depth_search() { return (depth > 0); }
+
+    // The node limit is soft - it is checked between iterations of iterative
+    // deepening so, a search never returns the result of a partial iteration.
+    bool is_node_search() { return (nodes > 0); }
+};
+
+// How many times an iteration's search failed outside it's aspiration window
+// and the delta of the window it finally searched, 0 for the full window.
+struct Aspiration_Window_Statistics
+{
+    uint16_t                     num_of_fail_highs = 0;
+    uint16_t                     num_of_fail_lows  = 0;
+    Fixed_Point_Int_Storage_Type delta             = 0;
 };
 
 struct UCI_Search_Information
 {
-    uint16_t&                 depth;
-    uint64_t&                 time;
-    uint64_t&                 node_count;
-    Principal_Variation_List& principal_variation;
-    Score&                    score;
-
-    UCI_Search_Information(uint16_t&                 search_depth,
-                           uint64_t&                 search_time,
-                           uint64_t&                 search_node_count,
-                           Principal_Variation_List& search_principal_variation,
-                           Score&                    search_score) :
+    uint16_t&                           depth;
+    uint64_t&                           time;
+    uint64_t&                           node_count;
+    Principal_Variation_List&           principal_variation;
+    Score&                              score;
+    const Aspiration_Window_Statistics& aspiration_window_statistics;
+
+    UCI_Search_Information(
+        uint16_t&                           search_depth,
+        uint64_t&                           search_time,
+        uint64_t&                           search_node_count,
+        Principal_Variation_List&           search_principal_variation,
+        Score&                              search_score,
+        const Aspiration_Window_Statistics& search_aspiration_statistics) :
         depth(search_depth),
         time(search_time),
         node_count(search_node_count),
         principal_variation(search_principal_variation),
-        score(search_score)
+        score(search_score),
+        aspiration_window_statistics(search_aspiration_statistics)
     {
     }
 
@@ -78,6 +188,17 @@ struct UCI_Search_Information
         os << " time " << time_ms;
         os << " nps " << nps;
         os << " score cp " << score_cp;
+
+#ifndef NDEBUG
+        // Not a UCI field so, only printed by debug builds.
+        const Aspiration_Window_Statistics& aspiration =
+            search_info.aspiration_window_statistics;
+        os << " aspiration fail high " << aspiration.num_of_fail_highs;
+        os << " fail low " << aspiration.num_of_fail_lows;
+        os << " delta "
+           << Matrex_FP_Int::from_value(aspiration.delta).get_integer();
+#endif
+
         os << " pv" << search_info.principal_variation;
 
         return os;
@@ -91,6 +212,39 @@ using Search_Quiet_Cont_Hist_Stack =
 using Search_Capture_Cont_Hist_Stack =
     Capture_Continuation_History_Stack<MAX_SEARCH_DEPTH_SOFT_LIMIT>;
 
+// The state of a ply of the search that the plies below it read.
+struct Search_Stack_Entry
+{
+    Chess_Move   move; // The move being searched from this ply.
+    Killer_Moves killer_moves;
+};
+
+// The base late move reductions indexed by depth and move number.
+using Late_Move_Reduction_Table =
+    Multi_Array<uint8_t,
+                (MAX_SEARCH_DEPTH_SOFT_LIMIT + 1),
+                MAXIMUM_NUM_OF_MOVES_IN_A_POSITION>;
+
+// One entry more than the deepest ply such that, a node can always clear the
+// entry of it's children.
+using Search_Stack =
+    Multi_Array<Search_Stack_Entry, (MAX_SEARCH_DEPTH_SOFT_LIMIT + 1)>;
+
+Late_Move_Reduction_Table create_late_move_reduction_table();
+
+// The bound of an aspiration window that is delta away from the score. A bound
+// outside of the non-mating evaluations is widened to infinity since, mate
+// scores are only found with an unbounded window.
+Score get_aspiration_window_bound(const Score                        score,
+                                  const Fixed_Point_Int_Storage_Type delta);
+
+inline bool should_do_internal_iterative_reduction(
+    const bool                       is_hit,
+    const Transposition_Table_Entry& entry,
+    const bool                       is_side_to_move_in_check,
+    const uint16_t                   depth,
+    const uint16_t                   ply);
+
 class Search_Engine
 {
   public:
@@ -102,8 +256,20 @@ class Search_Engine
     Search_Engine_Result search(const Chess_Board&        cb,
                                 const Search_Constraints& constraints);
 
+    // Returns the static evaluation and the quiescence search score of the
+    // position, both from the side to move's point of view. Only the
+    // evaluation and the transposition table size of the constraints are used.
+    std::pair<Score, Score>
+    static_and_quiescence_scores(const Chess_Board&        cb,
+                                 const Search_Constraints& constraints);
+
     inline uint64_t get_node_count();
 
+    // Number of beta cutoffs in the last search and how many of them were
+    // caused by the first move searched, a measure of the move ordering.
+    inline uint64_t get_beta_cutoff_count() const;
+    inline uint64_t get_first_move_beta_cutoff_count() const;
+
     const Transposition_Table_Statistics& get_tt_statistics() const;
 
   private:
@@ -115,17 +281,32 @@ class Search_Engine
     Timer                    m_timer;
     bool                     m_timer_expired_during_search;
     uint64_t                 m_num_of_nodes_searched;
+    uint64_t                 m_num_of_beta_cutoffs;
+    uint64_t                 m_num_of_first_move_beta_cutoffs;
     uint16_t                 m_current_search_depth;
+    bool                     m_is_verifying_null_move;
     Principal_Variation_List m_principal_variation;
     const Cuckoo_RM_Table    m_cuckoo_rm_table;
     Correction_History_Tables<CORRECTION_HISTORY_TABLE_SIZE>
         m_correction_history;
+    Evaluation_Statistics m_evaluation_statistics;
 
     Quiet_Continuation_History_Table   m_q_cont_hist_table;
     Search_Quiet_Cont_Hist_Stack       m_q_cont_hist_stack;
     Capture_Continuation_History_Table m_c_cont_hist_table;
     Search_Capture_Cont_Hist_Stack     m_c_cont_hist_stack;
 
+    // The continuation histories of the null move's subtree.
+    Quiet_History_Table   m_null_move_q_hist_table;
+    Capture_History_Table m_null_move_c_hist_table;
+
+    Butterfly_History_Table m_main_history;
+    Search_Stack            m_search_stack;
+    Counter_Move_Table      m_counter_move_table;
+
+    // Computed once at startup.
+    static const Late_Move_Reduction_Table LATE_MOVE_REDUCTIONS;
+
     constexpr static Multi_Array<Matrex_FP_Int,
                                  (NUM_OF_UNIQUE_PIECES_PER_PLAYER - 1)>
         FUTILITY_PRUNING_MATERIAL_WEIGHTS = {
@@ -149,6 +330,18 @@ class Search_Engine
     quiescence(Chess_Board& position, uint16_t ply, Score alpha, Score beta);
     Search_Engine_Result iterative_deepening();
 
+    void prepare_search(const Chess_Board&        cb,
+                        const Search_Constraints& constraints);
+
+    Score evaluate_position(const Chess_Board&           position,
+                            const Moves_Bitboard_Matrix& moving_side_matrix);
+
+    Score evaluate_position(const Chess_Board&           position,
+                            const Moves_Bitboard_Matrix& moving_side_matrix,
+                            const Score                  alpha,
+                            const Score                  beta,
+                            bool&                        is_lazy);
+
     template <std::size_t CONT_HIST_STACK_SIZE>
     inline Score get_mate_score(const Move_Ordering<CONT_HIST_STACK_SIZE>& mo,
                                 uint16_t                                   ply);
@@ -203,6 +396,18 @@ class Search_Engine
         const uint16_t                  depth,
         const Move_Generation_List&     captures_to_malus);
 
+    void update_main_history(const Chess_Board&          position,
+                             const Chess_Move&           move,
+                             const uint32_t              depth_squared,
+                             const Move_Generation_List& quiets_to_malus);
+
+    void update_refutations(const Chess_Board& position,
+                            const Chess_Move&  move,
+                            const uint16_t     ply);
+
+    Chess_Move get_counter_move(const Chess_Board& position,
+                                const uint16_t     ply) const;
+
     inline bool should_do_move_loop_pruning(const Score best_score,
                                             const bool is_side_to_move_in_check,
                                             const bool is_first_move);
@@ -249,9 +454,40 @@ class Search_Engine
                                        const bool  is_first_move);
 
     inline bool
-    should_do_reverse_futility_pruning(const bool  is_side_to_move_in_check,
-                                       const Score evaluation_with_margin,
-                                       const Score beta);
+    should_do_reverse_futility_pruning(const bool     is_pv_node,
+                                       const bool     is_side_to_move_in_check,
+                                       const uint16_t depth,
+                                       const Score    evaluation_with_margin,
+                                       const Score    beta);
+
+    inline bool should_do_razoring(const bool     is_pv_node,
+                                   const bool     is_side_to_move_in_check,
+                                   const uint16_t depth,
+                                   const Score    evaluation_with_margin,
+                                   const Score    alpha);
+
+    inline bool
+    should_do_late_move_reduction(const Chess_Move& move,
+                                  const bool        is_side_to_move_in_check,
+                                  const uint16_t    depth,
+                                  const uint16_t    num_of_moves_searched);
+
+    uint16_t get_late_move_reduction(
+        const Chess_Board&                  position,
+        const Search_Quiet_Cont_Hist_Stack& q_cont_hist_stack,
+        const Chess_Move&                   move,
+        const bool                          is_pv_node,
+        const uint16_t                      depth,
+        const uint16_t                      num_of_moves_searched) const;
+
+    inline bool
+    should_do_null_move_pruning(const Chess_Board& position,
+                                const bool         is_pv_node,
+                                const bool         is_side_to_move_in_check,
+                                const uint16_t     depth,
+                                const uint16_t     ply,
+                                const Score        static_evaluation,
+                                const Score        beta) const;
 };
 
 inline uint64_t Search_Engine::get_node_count()
@@ -259,6 +495,16 @@ inline uint64_t Search_Engine::get_node_count()
     return m_num_of_nodes_searched;
 }
 
+inline uint64_t Search_Engine::get_beta_cutoff_count() const
+{
+    return m_num_of_beta_cutoffs;
+}
+
+inline uint64_t Search_Engine::get_first_move_beta_cutoff_count() const
+{
+    return m_num_of_first_move_beta_cutoffs;
+}
+
 template <std::size_t CONT_HIST_STACK_SIZE>
 inline Score
 Search_Engine::get_mate_score(const Move_Ordering<CONT_HIST_STACK_SIZE>& mo,
@@ -454,9 +700,81 @@ inline bool Search_Engine::should_do_capture_futility_pruning(
 }
 
 inline bool Search_Engine::should_do_reverse_futility_pruning(
-    const bool  is_side_to_move_in_check,
-    const Score evaluation_with_margin,
-    const Score beta)
+    const bool     is_pv_node,
+    const bool     is_side_to_move_in_check,
+    const uint16_t depth,
+    const Score    evaluation_with_margin,
+    const Score    beta)
+{
+    const int32_t max_depth = m_constraints.parameters
+        [SEARCH_PARAMETER::REVERSE_FUTILITY_PRUNING_MAX_DEPTH];
+
+    return ((!is_pv_node) && (!is_side_to_move_in_check) && (depth <= max_depth)
+            && (evaluation_with_margin >= beta) && (!beta.is_mating_score()));
+}
+
+inline bool
+Search_Engine::should_do_razoring(const bool     is_pv_node,
+                                  const bool     is_side_to_move_in_check,
+                                  const uint16_t depth,
+                                  const Score    evaluation_with_margin,
+                                  const Score    alpha)
+{
+    const int32_t max_depth =
+        m_constraints.parameters[SEARCH_PARAMETER::RAZORING_MAX_DEPTH];
+
+    return ((!is_pv_node) && (!is_side_to_move_in_check) && (depth <= max_depth)
+            && (evaluation_with_margin < alpha) && (!alpha.is_mating_score()));
+}
+
+// Only quiet moves are reduced since, captures and promotions are likely to
+// change the evaluation and check evasions are forced.
+inline bool Search_Engine::should_do_late_move_reduction(
+    const Chess_Move& move,
+    const bool        is_side_to_move_in_check,
+    const uint16_t    depth,
+    const uint16_t    num_of_moves_searched)
+{
+    return (move.is_quiet_move() && (!is_side_to_move_in_check)
+            && (depth >= LATE_MOVE_REDUCTION_MIN_DEPTH)
+            && (num_of_moves_searched
+                >= LATE_MOVE_REDUCTION_MIN_MOVES_SEARCHED));
+}
+
+// A node the transposition table knows no best move for was either never
+// searched or failed low everywhere so, the move ordering has no trusted first
+// move and a shallower search is cheaper. The root always searches the depth
+// of it's iteration.
+inline bool should_do_internal_iterative_reduction(
+    const bool                       is_hit,
+    const Transposition_Table_Entry& entry,
+    const bool                       is_side_to_move_in_check,
+    const uint16_t                   depth,
+    const uint16_t                   ply)
+{
+    const bool has_transposition_table_move =
+        is_hit && (!entry.best_move.is_same_move(Chess_Move()));
+
+    return ((!has_transposition_table_move) && (!is_side_to_move_in_check)
+            && (depth >= INTERNAL_ITERATIVE_REDUCTION_MIN_DEPTH) && (ply > 0));
+}
+
+// Passing the turn is never better than the best move except in zugzwang which,
+// is rare unless the side to move is left with only pawns. Two null moves in a
+// row would only search the same position at a lower depth.
+inline bool Search_Engine::should_do_null_move_pruning(
+    const Chess_Board& position,
+    const bool         is_pv_node,
+    const bool         is_side_to_move_in_check,
+    const uint16_t     depth,
+    const uint16_t     ply,
+    const Score        static_evaluation,
+    const Score        beta) const
 {
-    return ((evaluation_with_margin >= beta) && (!is_side_to_move_in_check));
+    return ((!is_pv_node) && (!is_side_to_move_in_check)
+            && (!m_is_verifying_null_move)
+            && (depth >= NULL_MOVE_PRUNING_MIN_DEPTH) && (ply > 0)
+            && (!m_search_stack[ply - 1].move.is_same_move(Chess_Move()))
+            && (static_evaluation >= beta) && (!beta.is_mating_score())
+            && position.has_non_pawn_material(position.get_side_to_move()));
 }
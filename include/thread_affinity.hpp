@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// =============================================================================
+// Thread Affinity
+//
+// Pinning of threads to CPUs such that threads do not migrate across NUMA nodes
+// (sockets). Memory is placed on the node of the thread that first touches it
+// so, a pinned thread that allocates and initializes its own hot data keeps
+// that data on its local node. On platforms without affinity support pinning
+// is a no-op that reports failure.
+// =============================================================================
+
+// The CPUs of every NUMA node of the machine that the process may run on (its
+// affinity mask at startup). If the topology can not be read, every such CPU is
+// treated as part of a single node.
+struct Numa_Topology
+{
+    std::vector<std::vector<uint32_t>> node_cpus;
+};
+
+Numa_Topology read_numa_topology();
+
+// All CPUs ordered such that consecutive threads alternate between the NUMA
+// nodes, i.e. thread i is pinned to element (i % size) to spread threads evenly
+// across the nodes.
+std::vector<uint32_t> cpus_spread_across_numa_nodes();
+
+// Pins the calling thread to the given CPU, returns false if the thread could
+// not be pinned.
+bool pin_current_thread_to_cpu(const uint32_t cpu);
+
+// Restores the affinity of the calling thread to the affinity mask of the
+// process at startup, returns false if the affinity could not be reset.
+bool unpin_current_thread();
+
+// The CPU the calling thread is currently running on, if it can be queried.
+std::optional<uint32_t> current_cpu();
@@ -1,16 +1,24 @@
 #pragma once
 
+#include <algorithm>
 #include <any>
+#include <atomic>
 #include <condition_variable>
 #include <cstddef>
+#include <deque>
+#include <exception>
 #include <functional>
+#include <future>
+#include <latch>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include "globals.hpp"
+#include "thread_affinity.hpp"
 
 // =============================================================================
 // Threads Shared Data Class
@@ -95,6 +103,9 @@ class Thread_Job
     {
     }
 
+    // Constructor for jobs without untyped shared data (see Typed_Thread_Job).
+    Thread_Job() = default;
+
     // Default destructor.
     virtual ~Thread_Job() = default;
 
@@ -114,9 +125,8 @@ class Thread_Job
     // A method to obtain if a job has been marked completed.
     bool is_complete() const { return m_complete.load(); }
 
-    // If the job is assigned to a thread, it will carry the thread ID with
-    // it. The ID is -1 if unassigned - telling the dispatcher it may need
-    // to assign a thread this job.
+    // Once a worker runs the job, the job carries the ID of the worker with
+    // it. The ID is -1 until then.
     bool has_assigned_thread_id() const { return (m_assigned_thread_id != -1); }
 
     // Set the ID of the thread assigned this job.
@@ -165,14 +175,14 @@ class Thread_Job
     template <typename T>
     std::size_t write_to_shared_data(std::reference_wrapper<T> data)
     {
-        return m_shared_data.get().write(data);
+        return m_shared_data.get_ref().write(data);
     }
 
     // Any job needs to be able to read from shared data.
     template <typename T>
     auto read_shared_data(std::size_t index)
     {
-        return m_shared_data.get().read<T>(index);
+        return m_shared_data.get_ref().template read<T>(index);
     }
 
     // Any job needs to be able to call functions on shared data.
@@ -181,268 +191,513 @@ class Thread_Job
     template <typename Expected_Obj_Type, typename Function_Type>
     decltype(auto) call_shared_data(std::size_t index, Function_Type&& func)
     {
-        return m_shared_data.get().call<Expected_Obj_Type>(index, func);
+        return m_shared_data.get_ref().template call<Expected_Obj_Type>(index,
+                                                                       func);
     }
 
   private:
 
-    int64_t                                     m_assigned_thread_id = -1;
-    std::atomic<bool>                           m_complete {false};
-    std::vector<std::unique_ptr<std::any>>      m_private_data;
-    std::reference_wrapper<Threads_Shared_Data> m_shared_data;
+    int64_t                                 m_assigned_thread_id = -1;
+    std::atomic<bool>                       m_complete {false};
+    std::vector<std::unique_ptr<std::any>>  m_private_data;
+    Optional_Reference<Threads_Shared_Data> m_shared_data;
 };
 
 // =============================================================================
-// Thread Worker Class
+// Shared Snapshot Class
 //
-// An abstraction of a thread from the C++ standard library's thread.
+// Read-mostly data shared between threads in the style of read-copy-update.
+// Readers take a snapshot (a shared pointer to an immutable version) without
+// locking or copying the data, a writer publishes a whole new version which
+// readers holding an older snapshot are unaffected by.
 // =============================================================================
-class Thread_Worker
+template <typename T>
+class Shared_Snapshot
 {
   public:
 
-    // Construct the thread worker - mainly, assign the worker thread the task
-    // of the worker loop.
-    Thread_Worker(std::size_t id) :
-        m_id(id), m_thread([this](std::stop_token stop) { worker_loop(stop); })
+    explicit Shared_Snapshot(T initial) :
+        m_current(std::make_shared<const T>(std::move(initial)))
     {
     }
 
-    // An overloaded constructor to assign an initial job to the worker thread.
-    Thread_Worker(std::size_t id, Thread_Job& job) :
-        m_id(id),
-        m_job(job),
-        m_thread([this](std::stop_token stop) { worker_loop(stop); })
+    std::shared_ptr<const T> read() const
     {
+        return m_current.load(std::memory_order_acquire);
     }
 
-    // Assigns an incomplete valid job to the thread.
-    void assign_job(std::reference_wrapper<Thread_Job> job)
+    void publish(T value)
     {
-        if (job.get().has_job() && (!job.get().is_complete()))
-        {
-            std::scoped_lock lock(m_job_assignment_mutex);
-            m_job = std::move(job);
+        m_current.store(std::make_shared<const T>(std::move(value)),
+                        std::memory_order_release);
+    }
 
-            m_conditional_variable.notify_one();
-        }
+  private:
+
+    std::atomic<std::shared_ptr<const T>> m_current;
+};
+
+// =============================================================================
+// Thread Result Slots Class
+//
+// A slot per worker for the results of the worker's job. Every slot is only
+// ever written by one worker so, no lock is needed and the slots are cache line
+// aligned such that workers writing neighbouring slots do not false share.
+// =============================================================================
+template <typename T>
+class Thread_Result_Slots
+{
+  public:
+
+    explicit Thread_Result_Slots(std::size_t num_of_slots) :
+        m_slots(num_of_slots)
+    {
     }
 
-    // Stops the worker loop and terminates the thread.
-    auto stop() { return m_thread.request_stop(); }
+    T& operator[](std::size_t index) { return m_slots[index].value; }
 
-    // A check for if the worker currently has a job.
-    bool has_job()
+    const T& operator[](std::size_t index) const
     {
-        std::unique_lock lock(m_job_status_mutex);
-        return (m_job.has_ref() && m_job.get_ref().has_job()
-                && (!m_job.get_ref().is_complete()));
+        return m_slots[index].value;
     }
 
+    std::size_t size() const { return m_slots.size(); }
+
   private:
 
-    // Identifier for the thread worker normally assigned by the dispatcher
-    // based on what place in it's threads vector it is placed.
-    std::size_t m_id;
+    struct CACHE_ALIGN Slot
+    {
+        T value {};
+    };
 
-    // The thread for the worker and it's job.
-    Optional_Reference<Thread_Job> m_job;
-    std::jthread                   m_thread;
+    std::vector<Slot> m_slots;
+};
 
-    // Mutex and conditional variable for when the thread is being assigned a
-    // job or is waiting for a job to be assigned.
-    std::mutex                  m_job_assignment_mutex;
-    std::condition_variable_any m_conditional_variable;
+// =============================================================================
+// Typed Thread Job Class
+//
+// A job whose shared data is a single object of a known type rather than the
+// untyped, mutex guarded Threads Shared Data. The shared type is expected to be
+// made of snapshots, result slots, and data that is read-only while the jobs
+// run so, the jobs access it without locking.
+// =============================================================================
+template <typename Shared_Type>
+class Typed_Thread_Job : public Thread_Job
+{
+  public:
+
+    explicit Typed_Thread_Job(Shared_Type& shared) : m_shared(shared) {}
 
-    // Mutex for any reading and/or manipulation of the status (like has_job or
-    // complete) of a job.
-    std::mutex m_job_status_mutex;
+  protected:
 
-    // Discards the job by assigning no value through the optional.
-    void discard_job() { m_job.unbound_ref(); }
+    Shared_Type& shared() { return m_shared.get(); }
+
+  private:
 
-    void worker_loop(std::stop_token stop)
+    std::reference_wrapper<Shared_Type> m_shared;
+};
+
+// =============================================================================
+// Thread Task Struct
+//
+// A job pushed to the thread pool along with the promise of its result, the
+// future of which is returned to whoever pushed the job.
+// =============================================================================
+struct Thread_Task
+{
+    std::unique_ptr<Thread_Job> job;
+    std::promise<std::any>      result;
+    bool                        is_bound = false;
+};
+
+// =============================================================================
+// Thread Worker Class
+//
+// An abstraction of a thread from the C++ standard library's thread along with
+// its own deque of tasks. The owner of the deque works from the back while,
+// other workers steal from the front so, the owner and thieves rarely contend
+// for the same end of the deque.
+// =============================================================================
+class Thread_Worker
+{
+  public:
+
+    explicit Thread_Worker(std::size_t id) : m_id(id) {}
+
+    // Starts the thread running the given worker loop. The thread is started
+    // separately from construction such that every worker's deque exists
+    // before any worker starts stealing.
+    template <typename Function_Type>
+    void start(Function_Type&& worker_loop)
     {
-        // Loop until the thread is requested to terminate.
-        while (!stop.stop_requested())
-        {
-            // Block for mutex lock which is necessary to prevent the "Lost
-            // Wakeup" problem.
-            {
-                std::unique_lock lock(m_job_assignment_mutex);
-
-                // Wait for a job that has an actual job and is not complete.
-                m_conditional_variable.wait(
-                    lock,
-                    stop,
-                    [&]
-                    {
-                        return (m_job.has_ref() && m_job.get_ref().has_job()
-                                && (!m_job.get_ref().is_complete()));
-                    });
-
-                // If a stop is requested before the job is run, stop.
-                if (stop.stop_requested()) { return; }
-            }
+        m_thread = std::jthread(std::forward<Function_Type>(worker_loop));
+    }
 
-            // Run the job.
-            m_job.get_ref()(stop);
+    // Pushes a task to the back of the deque.
+    void push(Thread_Task task)
+    {
+        std::scoped_lock lock(m_tasks_mutex);
+        m_tasks.push_back(std::move(task));
+    }
 
-            // Atomically manipulate m_job.
-            {
-                std::scoped_lock lock(m_job_status_mutex);
+    // The owner pops the most recently pushed task from the back of the deque.
+    std::optional<Thread_Task> pop()
+    {
+        std::scoped_lock lock(m_tasks_mutex);
 
-                // Set the job to complete.
-                m_job.get_ref().set_complete(true);
+        if (m_tasks.empty()) { return std::nullopt; }
 
-                // Discard the job from the thread.
-                discard_job();
-            }
-        }
+        Thread_Task task = std::move(m_tasks.back());
+        m_tasks.pop_back();
+
+        return task;
     }
+
+    // Other workers steal the oldest task from the front of the deque that is
+    // not bound to this worker.
+    std::optional<Thread_Task> steal()
+    {
+        std::scoped_lock lock(m_tasks_mutex);
+
+        const auto it = std::find_if(m_tasks.begin(),
+                                     m_tasks.end(),
+                                     [](const Thread_Task& task)
+                                     { return !task.is_bound; });
+
+        if (it == m_tasks.end()) { return std::nullopt; }
+
+        Thread_Task task = std::move(*it);
+        m_tasks.erase(it);
+
+        return task;
+    }
+
+    // Stops the worker loop and terminates the thread.
+    auto stop() { return m_thread.request_stop(); }
+
+    // Waits for the thread to exit the worker loop.
+    void join()
+    {
+        if (m_thread.joinable()) { m_thread.join(); }
+    }
+
+    std::size_t get_id() const { return m_id; }
+
+    // The number of tasks in the deque bound to this worker, raised before the
+    // task is pushed and lowered once the worker popped it.
+    std::atomic<std::size_t>& num_of_bound_tasks()
+    {
+        return m_num_of_bound_tasks;
+    }
+
+  private:
+
+    // Identifier for the thread worker assigned by the thread pool based on
+    // what place in it's threads vector it is placed.
+    std::size_t m_id;
+
+    std::mutex              m_tasks_mutex;
+    std::deque<Thread_Task> m_tasks;
+
+    std::atomic<std::size_t> m_num_of_bound_tasks {0};
+
+    std::jthread m_thread;
 };
 
 // =============================================================================
 // Thread Pool Class
 //
-// An abstraction for multiple instantiated threads and multiple available jobs
-// which has a dedicated thread known as the dispatcher for assigning jobs and
-// managing the threads & jobs vectors.
+// An abstraction for multiple instantiated threads, each with a deque of
+// tasks. Pushed jobs are spread over the deques, a worker runs the tasks of its
+// own deque and steals from the deques of other workers when its deque is
+// empty. A job bound to a worker is never stolen. Workers with nothing to run
+// or steal park on a conditional variable instead of spinning.
 // =============================================================================
 class Thread_Pool
 {
   public:
 
-    // Construct the thread pool - mainly, assign the dispatcher thread the task
-    // of the dispatcher loop.
+    // Construct the thread pool - mainly, create the workers and start their
+    // worker loops. If the workers are pinned, worker i is pinned to the i-th
+    // CPU of a list alternating between the NUMA nodes so, the workers are
+    // spread evenly across the nodes.
     Thread_Pool(
-        std::size_t max_num_of_threads = std::jthread::hardware_concurrency()) :
-        m_max_num_of_threads(max_num_of_threads),
-        m_dispatcher([this](std::stop_token stop) { dispatcher_loop(stop); })
+        std::size_t max_num_of_threads = std::jthread::hardware_concurrency(),
+        bool        pin_workers        = false) :
+        m_max_num_of_threads(std::max<std::size_t>(max_num_of_threads, 1))
     {
+        if (pin_workers) { m_worker_cpus = cpus_spread_across_numa_nodes(); }
+
+        for (std::size_t i = 0; i < m_max_num_of_threads; ++i)
+        {
+            m_threads.emplace_back(std::make_unique<Thread_Worker>(i));
+        }
+
+        // The pool is only constructed once every worker has tried to pin
+        // itself such that, the number of pinned workers is known.
+        std::latch workers_started(
+            static_cast<std::ptrdiff_t>(m_threads.size()));
+
+        for (auto& worker : m_threads)
+        {
+            worker->start(
+                [this, id = worker->get_id(), &workers_started](
+                    std::stop_token stop)
+                { worker_loop(id, stop, workers_started); });
+        }
+
+        workers_started.wait();
     }
 
-    // Allows pushing a job to the job vector for the dispatcher to assign to a
-    // thread.
-    void push_job(std::unique_ptr<Thread_Job> job)
+    // Pushes a job to a worker's deque and returns the future of the job's
+    // result. A job pushed from a worker of this pool goes to the worker's own
+    // deque, otherwise the deques are chosen round-robin.
+    std::future<std::any> push_job(std::unique_ptr<Thread_Job> job)
     {
-        std::scoped_lock lock(m_jobs_mutex);
-        m_are_jobs_done.store(false);
-        m_jobs.push_back(std::move(job));
+        const std::size_t worker_id =
+            (tl_pool == this)
+                ? tl_worker_id
+                : (m_next_worker.fetch_add(1) % m_max_num_of_threads);
+
+        return push_task(std::move(job), worker_id, false);
+    }
+
+    // Pushes a job that only the given worker runs, it is never stolen. A job
+    // bound to the same worker every time runs on the same (pinned) thread such
+    // that, the data it allocates stays on that thread's NUMA node.
+    std::future<std::any> push_job_to_worker(std::unique_ptr<Thread_Job> job,
+                                             const std::size_t           worker)
+    {
+        return push_task(std::move(job), (worker % m_max_num_of_threads), true);
+    }
+
+    // The number of workers pinned to a CPU, less than the number of workers if
+    // pinning was requested and some of the workers could not be pinned.
+    std::size_t get_num_of_pinned_workers() const
+    {
+        return m_num_of_pinned_workers.load();
     }
 
-    // Terminate all workers and the dispatcher thread.
+    std::size_t get_num_of_workers() const { return m_max_num_of_threads; }
+
+
+    // Terminate all workers.
     void terminate_all()
     {
         for (auto& worker : m_threads) { worker->stop(); }
+    }
 
-        m_dispatcher.request_stop();
+    // Waits for all pushed jobs to complete. The pending jobs count acts as a
+    // reusable latch, it is counted down by every completed job and the
+    // waiting thread blocks on it until it reaches zero. The first exception
+    // thrown by a job since the last wait is then rethrown.
+    void wait_for_jobs_to_complete()
+    {
+        std::size_t pending = m_num_of_pending_jobs.load();
+
+        while (pending != 0)
+        {
+            m_num_of_pending_jobs.wait(pending);
+            pending = m_num_of_pending_jobs.load();
+        }
+
+        std::exception_ptr exception;
+        {
+            std::scoped_lock lock(m_exception_mutex);
+            exception = std::exchange(m_first_exception, nullptr);
+        }
+
+        if (exception) { std::rethrow_exception(exception); }
     }
 
-    // Waits for all pushed jobs to complete.
-    void wait_for_jobs_to_complete() { m_are_jobs_done.wait(false); }
+    // Upon destruction of the pool, terminate all the threads and wait for
+    // them to exit before their deques are destroyed.
+    ~Thread_Pool()
+    {
+        terminate_all();
 
-    // Upon destruction of the pool, terminate all the threads.
-    ~Thread_Pool() { terminate_all(); }
+        for (auto& worker : m_threads) { worker->join(); }
+    }
 
   private:
 
-    // Atomic signifying if the dispatcher has an empty job queue and all jobs
-    // requested are complete.
-    std::atomic<bool> m_are_jobs_done {false};
+    // The pool and ID of the worker running on the current thread (if any),
+    // used to push jobs pushed by a running job to the worker's own deque.
+    inline static thread_local const Thread_Pool* tl_pool      = nullptr;
+    inline static thread_local std::size_t        tl_worker_id = 0;
+
+    // The number of jobs pushed but not yet completed and the number of tasks
+    // sitting in the deques waiting to be popped or stolen by any worker. The
+    // tasks bound to a worker are counted by the worker.
+    std::atomic<std::size_t> m_num_of_pending_jobs {0};
+    std::atomic<std::size_t> m_num_of_stealable_jobs {0};
 
-    // The threads vector and the maximum number of threads allowed to be
-    // spawned concurrently.
+    std::atomic<std::size_t> m_num_of_pinned_workers {0};
+
+    // Round-robin counter for jobs pushed from outside of the pool.
+    std::atomic<std::size_t> m_next_worker {0};
+
+    // The first exception thrown by a job since the last wait for the jobs to
+    // complete.
+    std::mutex         m_exception_mutex;
+    std::exception_ptr m_first_exception;
+
+    // Mutex and conditional variable idle workers park on.
+    std::mutex                  m_park_mutex;
+    std::condition_variable_any m_park_conditional_variable;
+
+    // The CPUs the workers are pinned to, empty if the workers are not pinned.
+    std::vector<uint32_t> m_worker_cpus;
+
+    // The threads vector and the number of threads in the pool.
     std::size_t                                 m_max_num_of_threads;
     std::vector<std::unique_ptr<Thread_Worker>> m_threads;
 
-    // The jobs vector and its respective mutex because the dispatcher has to
-    // manipulate the jobs vector while, we are able to push jobs.
-    std::mutex                               m_jobs_mutex;
-    std::vector<std::unique_ptr<Thread_Job>> m_jobs;
+    std::future<std::any> push_task(std::unique_ptr<Thread_Job> job,
+                                    const std::size_t           worker_id,
+                                    const bool                  is_bound)
+    {
+        Thread_Task task {.job      = std::move(job),
+                          .result   = {},
+                          .is_bound = is_bound};
+        std::future<std::any> future = task.result.get_future();
 
-    // The primary thread in the thread pool which is responsible for
-    // distributing jobs to threads and managing the threads & jobs vectors.
-    std::jthread m_dispatcher;
+        // A job that has no job or is already complete is never run.
+        if ((!task.job->has_job()) || task.job->is_complete())
+        {
+            task.result.set_value(std::any {});
+            return future;
+        }
 
-    void dispatcher_loop(std::stop_token stop)
-    {
-        while (!stop.stop_requested())
+        m_num_of_pending_jobs.fetch_add(1);
+
+        // The queued count is raised under the park mutex before the task is
+        // visible such that a parking worker can not miss the wakeup.
         {
-            // We need the jobs mutex to be unlocked for the dispatcher to do
-            // its loop which involves manipulating the jobs vector.
-            std::scoped_lock lock(m_jobs_mutex);
-
-            // Discard all jobs in the jobs vector that are labeled complete
-            // or do not have a job.
-            std::erase_if(
-                m_jobs,
-                [](auto& job)
-                { return (job->is_complete() || (!job->has_job())); });
-
-            // Check if there is a job in the jobs vector that is not mapped
-            // to a thread.
-            auto next_job_iterator = std::ranges::find_if(
-                m_jobs,
-                [](const auto& job)
-                { return (!job->has_assigned_thread_id()); });
-
-            // If there is no job that needs to be assigned and the jobs vector
-            // is empty, ensure the jobs done atomic boolean is set true and all
-            // threads (that may be waiting based on this atomic) are notified.
-            // Otherwise, set it to false.
-            if ((next_job_iterator == m_jobs.end()) && (m_jobs.size() == 0))
+            std::scoped_lock lock(m_park_mutex);
+            if (is_bound)
             {
-                m_are_jobs_done.store(true);
-                m_are_jobs_done.notify_all();
+                m_threads[worker_id]->num_of_bound_tasks().fetch_add(1);
             }
             else
             {
-                m_are_jobs_done.store(false);
+                m_num_of_stealable_jobs.fetch_add(1);
             }
+        }
 
-            // If there is no job that needs to be assigned, do nothing.
-            if (next_job_iterator == m_jobs.end()) { continue; }
+        m_threads[worker_id]->push(std::move(task));
 
-            // Find the first thread in the threads vector that doesn't have
-            // a job.
-            auto next_thread_iterator = std::ranges::find_if(
-                m_threads,
-                [](auto& worker) { return (!worker->has_job()); });
+        // A bound task can only be run by its worker, every parked worker is
+        // woken since the wakeup may otherwise go to a worker that can't run
+        // it.
+        if (is_bound) { m_park_conditional_variable.notify_all(); }
+        else
+        {
+            m_park_conditional_variable.notify_one();
+        }
 
-            // If all threads are busy and the thread vector is at the
-            // maximum number of threads allowed, do nothing.
-            if ((m_threads.size() == m_max_num_of_threads)
-                && (next_thread_iterator == m_threads.end()))
-            {
-                continue;
-            }
+        return future;
+    }
 
-            // Get the indices to the next available thread and the next
-            // job that needs to be assigned.
-            std::size_t next_job_index =
-                std::distance(m_jobs.begin(), next_job_iterator);
-            std::size_t next_thread_index =
-                std::distance(m_threads.begin(), next_thread_iterator);
+    // A worker first pops from its own deque and then, tries to steal from
+    // the other workers starting at its neighbour.
+    std::optional<Thread_Task> find_task(std::size_t id)
+    {
+        std::optional<Thread_Task> task = m_threads[id]->pop();
 
-            // There is no free thread, create one and assign it the next
-            // job.
-            if (next_thread_iterator == m_threads.end())
+        for (std::size_t i = 1;
+             (!task.has_value()) && (i < m_max_num_of_threads);
+             ++i)
+        {
+            task = m_threads[(id + i) % m_max_num_of_threads]->steal();
+        }
+
+        return task;
+    }
+
+    void run_task(std::size_t id, Thread_Task task, std::stop_token stop)
+    {
+        task.job->set_assigned_thread_id(id);
+
+        try
+        {
+            std::any result = (*task.job)(stop);
+            task.job->set_complete(true);
+            task.result.set_value(std::move(result));
+        }
+        catch (...)
+        {
+            task.job->set_complete(true);
+            task.result.set_exception(std::current_exception());
+
+            // Kept such that, callers that wait for the jobs rather than on
+            // their futures don't lose it.
+            std::scoped_lock lock(m_exception_mutex);
+            if (!m_first_exception)
             {
-                m_jobs.at(next_job_index)
-                    ->set_assigned_thread_id(m_threads.size());
-                m_threads.emplace_back(std::make_unique<Thread_Worker>(
-                    next_thread_index,
-                    *m_jobs.at(next_job_index)));
+                m_first_exception = std::current_exception();
             }
-            // There is a free thread, assign it the next job.
-            else
+        }
+
+        // The job is destroyed before it is counted as complete, nothing of
+        // the job outlives the wait for the jobs to complete.
+        task.job.reset();
+
+        if (m_num_of_pending_jobs.fetch_sub(1) == 1)
+        {
+            m_num_of_pending_jobs.notify_all();
+        }
+    }
+
+    // The latch is counted down once the worker tried to pin itself, it is
+    // not touched afterwards since it only lives as long as the constructor.
+    void worker_loop(std::size_t id, std::stop_token stop, std::latch& started)
+    {
+        tl_pool      = this;
+        tl_worker_id = id;
+
+        // Pin before the worker touches any memory such that everything the
+        // worker allocates is placed on its own NUMA node.
+        if ((!m_worker_cpus.empty())
+            && pin_current_thread_to_cpu(
+                m_worker_cpus[id % m_worker_cpus.size()]))
+        {
+            m_num_of_pinned_workers.fetch_add(1);
+        }
+
+        started.count_down();
+
+        std::atomic<std::size_t>& num_of_bound_tasks =
+            m_threads[id]->num_of_bound_tasks();
+
+        // Loop until the thread is requested to terminate.
+        while (!stop.stop_requested())
+        {
+            std::optional<Thread_Task> task = find_task(id);
+
+            if (task.has_value())
             {
-                m_jobs.at(next_job_index)
-                    ->set_assigned_thread_id(next_thread_index);
-                m_threads.at(next_thread_index)
-                    ->assign_job(*m_jobs.at(next_job_index));
+                if (task->is_bound) { num_of_bound_tasks.fetch_sub(1); }
+                else
+                {
+                    m_num_of_stealable_jobs.fetch_sub(1);
+                }
+
+                run_task(id, std::move(*task), stop);
+                continue;
             }
+
+            // Nothing to run or steal, park until a job this worker can run is
+            // queued or a stop is requested.
+            std::unique_lock lock(m_park_mutex);
+            m_park_conditional_variable.wait(
+                lock,
+                stop,
+                [&]
+                {
+                    return (m_num_of_stealable_jobs.load() > 0)
+                        || (num_of_bound_tasks.load() > 0);
+                });
         }
     }
 };
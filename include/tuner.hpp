@@ -1,17 +1,31 @@
 #pragma once
 
+#include <filesystem>
 #include <fstream>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <ostream>
+#include <random>
+#include <span>
+#include <string>
 #include <vector>
 
+#include "batch_evaluate.hpp"
+#include "dataset.hpp"
 #include "evaluate.hpp"
 #include "globals.hpp"
+#include "mini_batch_stream.hpp"
 #include "threads.hpp"
 
-constexpr uint64_t TUNER_NUM_OF_THREADS      = 4;
-constexpr double   TUNER_BLOCK_LEARNING_RATE = 1;
-constexpr double   TUNER_BLOCK_MOMENTUM =
-    1.0 - (1.0 / static_cast<double>(TUNER_NUM_OF_THREADS));
+constexpr uint64_t TUNER_DEFAULT_NUM_OF_THREADS = 4;
+constexpr double   TUNER_BLOCK_LEARNING_RATE    = 1;
+
+constexpr double tuner_block_momentum(const std::size_t num_of_threads)
+{
+    return 1.0 - (1.0 / static_cast<double>(num_of_threads));
+}
 
 constexpr uint64_t TUNER_MAX_EPOCHS       = 30;
 constexpr uint64_t TUNER_MINI_BATCH_SIZE  = 16384;
@@ -41,16 +55,41 @@ constexpr double  TUNER_LOSS_IMPROVEMENT_CUTOFF = 1e-6;
 constexpr double  TUNER_WEIGHT_UPDATE_CUTOFF    = 1e-4;
 constexpr uint8_t TUNER_PATIENCE                = 7;
 
-struct Mini_Batch
+// The optimizers the tuner can minimize the loss with. NADAM steps on
+// mini-batches, L-BFGS steps on the gradient of the whole training dataset.
+enum class Tuner_Optimizer : uint8_t
 {
-    std::vector<std::string> fens;
-    std::vector<double>      scores;
+    NADAM,
+    LBFGS
 };
 
-struct Worker_Batches
-{
-    Multi_Array<Mini_Batch, TUNER_NUM_OF_THREADS> batches;
-};
+// Number of the most recent weight and gradient changes L-BFGS approximates
+// the inverse Hessian with.
+constexpr std::size_t TUNER_LBFGS_HISTORY_SIZE = 10;
+constexpr uint64_t    TUNER_LBFGS_MAX_ITERATIONS = 500;
+
+// The backtracking line search halves the step until the loss decreases by at
+// least the Armijo constant times the decrease predicted by the gradient.
+constexpr uint8_t TUNER_LBFGS_MAX_LINE_SEARCH_STEPS = 20;
+constexpr double  TUNER_LBFGS_ARMIJO_CONSTANT       = 1e-4;
+
+// Length of the first step (and of any step after the history was reset) along
+// the normalized gradient since, there is no curvature information yet.
+constexpr double TUNER_LBFGS_INITIAL_STEP = 1e-2;
+
+// A checkpoint is written every this many timesteps and at the end of every
+// epoch.
+constexpr uint64_t TUNER_CHECKPOINT_INTERVAL = 1000;
+
+// "MTRXCKPT" when written in little-endian byte order.
+constexpr uint64_t TUNER_CHECKPOINT_MAGIC   = 0x54504B435852544D;
+constexpr uint32_t TUNER_CHECKPOINT_VERSION = 3;
+
+// The random number generator's state is written as text, every word of the
+// state and its index as a decimal number of at most 20 digits and a space.
+constexpr uint64_t TUNER_CHECKPOINT_MAX_RNG_STATE_SIZE =
+    ((std::mt19937_64::state_size + 1)
+     * (std::numeric_limits<uint64_t>::digits10 + 2));
 
 struct Dataset
 {
@@ -58,30 +97,64 @@ struct Dataset
     std::size_t             size;
 };
 
-struct Tuner_Eval_Params
-{
-    std::vector<Chess_Board>           boards;
-    std::vector<Moves_Bitboard_Matrix> moving_side_matrices;
-    std::vector<Moves_Bitboard_Matrix> opposing_side_matrices;
-};
+struct Tuner_Checkpoint;
 
 class Tuner
 {
   public:
 
-    Tuner(std::ostream&  logging,
-          std::ifstream& dataset_file,
-          std::ofstream& output);
-    Evaluation_Weights<double> tune();
+    // If the threads are pinned, the worker threads are pinned to CPUs spread
+    // across the NUMA nodes of the machine. If a checkpoint path is given, the
+    // state of the tuning is periodically written to it. If a memory budget
+    // (in bytes of the packed positions and features of both dataset splits)
+    // is given, the dataset is streamed from the file instead of being loaded
+    // into memory, the file must then outlive the tuner.
+    Tuner(std::ostream&                logging,
+          std::ifstream&               dataset_file,
+          std::ofstream&               output,
+          const std::size_t            num_of_threads =
+              TUNER_DEFAULT_NUM_OF_THREADS,
+          const bool                   pin_threads     = false,
+          const std::filesystem::path& checkpoint_path = {},
+          const std::size_t            memory_budget   = 0);
+
+    // When resuming, the tuning continues from the state of the checkpoint
+    // exactly where it left off instead of starting from random weights.
+    Evaluation_Weights<double> tune(const bool resume = false);
+
+    // Full-batch L-BFGS, the iterates are kept inside the valid range of the
+    // weights the same way as NADAM's steps. There is no checkpointing since,
+    // it converges in far fewer passes over the dataset. The dataset must be
+    // in memory.
+    Evaluation_Weights<double> tune_lbfgs();
+
+    std::size_t get_num_of_threads() const { return m_num_of_threads; }
+
+    bool is_streaming() const { return (m_training_stream != nullptr); }
+
+    // The split of the mini-batch the given worker steps on. The split is
+    // created by the worker itself such that it is allocated on the worker's
+    // NUMA node.
+    Mini_Batch create_worker_batch(const Mini_Batch& mini_batch,
+                                   const std::size_t worker) const;
 
     Evaluation_Weights<double>
     compute_gradient(const Evaluation_Weights<double>& weights,
                      const Mini_Batch&                 mini_batch) const;
 
+    // Sum of the losses of the positions of the mini-batch.
+    double
+    compute_mini_batch_loss(const Mini_Batch&                 mini_batch,
+                            const Evaluation_Weights<double>& weights) const;
+
+    double projected_gradient(const double weight,
+                              const double gradient) const;
     Evaluation_Weights<double>
     projected_gradient(const Evaluation_Weights<double>& weights,
                        const Evaluation_Weights<double>& gradient) const;
 
+    double projected_weight_change(const double weight,
+                                   const double weight_update) const;
     Evaluation_Weights<double> projected_weight_change(
         const Evaluation_Weights<double>& weights,
         const Evaluation_Weights<double>& weight_update) const;
@@ -93,8 +166,25 @@ class Tuner
     Dataset        m_validation_dataset;
     std::ofstream& m_output;
 
+    // Only set when the dataset is streamed, both streams read the same file.
+    std::mutex                         m_dataset_mutex;
+    std::unique_ptr<Mini_Batch_Stream> m_training_stream;
+    std::unique_ptr<Mini_Batch_Stream> m_validation_stream;
+
+    // Zero when the dataset is in memory.
+    std::size_t m_memory_budget;
+
+    std::size_t m_num_of_threads;
     Thread_Pool m_thread_pool;
 
+    std::filesystem::path m_checkpoint_path;
+
+    // Generates the order of the mini-batches of every epoch. It's state is a
+    // part of the checkpoints such that, a resumed tuning sees the same order.
+    std::mt19937_64 m_rng;
+
+    AD_Compiled_Graph m_gradient_graph;
+
     double                 perturb(const double mean);
     NLR_Parameters<double> random_nlr(const double h_mean);
 
@@ -102,36 +192,62 @@ class Tuner
 
     double learning_rate_scheduler(const uint64_t epoch) const;
 
+    void             write_checkpoint(const Tuner_Checkpoint& checkpoint) const;
+    Tuner_Checkpoint read_checkpoint() const;
+
     void parse_dataset_file(std::ifstream& dataset_file,
                             Dataset&       training_dataset,
                             Dataset&       validation_dataset);
 
-    Dataset create_mini_batches(const Mini_Batch& aggregate_batch);
-
-    Worker_Batches create_worker_batches(const Mini_Batch& mini_batch);
+    void open_dataset_streams(std::ifstream&    dataset_file,
+                              const std::size_t memory_budget);
 
-    Tuner_Eval_Params compute_eval_params(const Mini_Batch& mini_batch) const;
+    Dataset create_mini_batches(const std::span<const Packed_Position> positions);
 
     auto create_ad_weights(AD_Tape&                          tape,
                            const Evaluation_Weights<double>& weights) const
     {
+        MATREX_ASSERT((tape.size() == 0),
+                      "The AD weights must be the first nodes on the tape.");
+
         Evaluation_Weights<AD_Value> output;
 
         for (std::size_t i = 0; i < weights.get_size(); ++i)
         {
-            output[i] = AD_Value::variable(tape, weights[i], i);
+            output[i] = AD_Value::variable(tape, weights[i]);
         }
 
         return output;
     }
 
-    Evaluation_Weights<double> ad_backward_pass(AD_Tape& tape,
-                                                AD_Value output) const;
+    // Records the graph of the evaluation with respect to the weights once,
+    // every gradient replays it with the features of the positions.
+    AD_Compiled_Graph compile_gradient_graph(const Evaluation_Batch& batch) const;
 
     double compute_loss(const Dataset&                    d,
                         const Evaluation_Weights<double>& weights);
 
+    // The mini-batches of the stream are evaluated num_of_threads at a time
+    // such that, the loss jobs are as parallel as for a dataset in memory.
+    double compute_loss(Mini_Batch_Stream&                stream,
+                        const Evaluation_Weights<double>& weights);
+
+    double compute_training_loss(const Evaluation_Weights<double>& weights);
+    double compute_validation_loss(const Evaluation_Weights<double>& weights);
+
+    // Gradient of the loss of the whole dataset.
+    Evaluation_Weights<double>
+    compute_full_batch_gradient(const Dataset&                    d,
+                                const Evaluation_Weights<double>& weights);
+
     double compute_max_data_loss(const Dataset& d);
+    double compute_max_data_loss(Mini_Batch_Stream& stream);
+
+    void count_results(const Mini_Batch& mini_batch,
+                       std::size_t&      num_of_decisive_games,
+                       std::size_t&      num_of_draws) const;
+    double max_data_loss(const std::size_t num_of_decisive_games,
+                         const std::size_t num_of_draws) const;
 
     void print_element_as_cpp(std::ofstream& ofs, const double scalar);
     void print_element_as_cpp(std::ofstream&                ofs,
@@ -161,137 +277,399 @@ struct Tuner_Step_State
     Evaluation_Weights<double> weights;
 };
 
-using Tuner_Step_States_Array =
-    Multi_Array<Tuner_Step_State, TUNER_NUM_OF_THREADS>;
+// Everything needed to continue a tuning exactly where it left off. The random
+// number generator's state is the state at the start of the epoch in progress
+// such that, the epoch's order of mini-batches can be generated again. The
+// mini-batches are split between the threads so, a checkpoint is only resumed
+// with the number of threads it was written with. The windows of a streamed
+// dataset decide the order of its mini-batches so, a checkpoint is only resumed
+// with the memory budget it was written with, zero if the dataset was in
+// memory.
+struct Tuner_Checkpoint
+{
+    uint64_t                   num_of_threads                 = 0;
+    uint64_t                   memory_budget                  = 0;
+    uint64_t                   epoch                          = 1;
+    uint64_t                   next_mini_batch                = 0;
+    uint64_t                   timestep                       = 1;
+    double                     weight_update_magnitude_sum    = 0;
+    double                     previous_epoch_training_loss   = 0;
+    double                     previous_epoch_validation_loss = 0;
+    uint64_t                   epoch_patience_count           = 0;
+    std::string                rng_state;
+    Tuner_Step_State           state;
+    Evaluation_Weights<double> best_weights;
+
+    void                    write(std::ostream& os) const;
+    static Tuner_Checkpoint read(std::istream&  is,
+                                 const uint64_t num_of_threads,
+                                 const uint64_t memory_budget);
+};
 
-class Tuner_Step : public Thread_Job
+// The shared data of the jobs of a tuner step. The global state is read as a
+// snapshot, every step job writes only to its own slots and every reduce job
+// writes only to its own slice of the next global state so, no job takes a
+// lock. The local states are averaged weighted by the sizes of their splits
+// such that, the empty splits of a mini-batch smaller than the number of
+// threads don't count. The local states outlive the step, every worker
+// allocates its own on its first step.
+struct Tuner_Step_Shared_Data
 {
-  private:
+    using Local_States = Thread_Result_Slots<std::unique_ptr<Tuner_Step_State>>;
+
+    double                                   learning_rate;
+    uint64_t                                 timestep;
+    const Shared_Snapshot<Tuner_Step_State>& global_state;
+    Local_States&                            local_states;
+    Thread_Result_Slots<std::size_t>         split_sizes;
+    Thread_Result_Slots<double>              weight_update_magnitudes;
+    Tuner_Step_State                         next_global_state;
+};
+
+// The shared data of the jobs computing the loss of a dataset, every mini-batch
+// has it's own loss slot.
+struct Tuner_Loss_Shared_Data
+{
+    const Dataset&                    dataset;
+    const Evaluation_Weights<double>& weights;
+    std::vector<double>               mini_batch_losses;
+};
 
-    constexpr static std::size_t m_index_to_global_learning_rate            = 0;
-    constexpr static std::size_t m_index_to_global_state                    = 1;
-    constexpr static std::size_t m_index_to_local_states                    = 2;
-    constexpr static std::size_t m_index_to_weight_update_magnitude_average = 3;
-    constexpr static std::size_t m_index_to_timestep                        = 4;
+// The shared data of the jobs computing the gradient of a whole dataset, every
+// job sums the gradients of it's mini-batches (weighted by their sizes) into
+// it's own slot.
+struct Tuner_Gradient_Shared_Data
+{
+    const Dataset&                                  dataset;
+    const Evaluation_Weights<double>&               weights;
+    Thread_Result_Slots<Evaluation_Weights<double>> gradient_sums;
+};
+
+class Tuner_Step : public Typed_Thread_Job<Tuner_Step_Shared_Data>
+{
+  private:
 
     std::size_t m_index_to_tuner;
     std::size_t m_index_to_data;
+    std::size_t m_index_to_worker;
 
   public:
 
-    Tuner_Step(Threads_Shared_Data& shared_data,
-               const Tuner&         tuner_instance,
-               const Mini_Batch&    worker_batch) :
-        Thread_Job(shared_data)
+    // The worker index selects the split of the mini-batch the job steps on
+    // and the local state the job commits to. The job is bound to the pool
+    // worker of the same index such that, a worker's split and local state are
+    // always allocated and touched by the same (pinned) thread.
+    Tuner_Step(Tuner_Step_Shared_Data& shared_data,
+               const Tuner&            tuner_instance,
+               const Mini_Batch&       mini_batch,
+               const std::size_t       worker) :
+        Typed_Thread_Job(shared_data)
     {
-        m_index_to_tuner = write_reference_to_private_data(tuner_instance);
-        m_index_to_data  = write_reference_to_private_data(worker_batch);
+        m_index_to_tuner  = write_reference_to_private_data(tuner_instance);
+        m_index_to_data   = write_reference_to_private_data(mini_batch);
+        m_index_to_worker = write_to_private_data<std::size_t>(worker);
     }
 
     virtual bool has_job() const override { return true; }
 
     virtual std::any operator()(std::stop_token) override
     {
-        // Grab necessary shared data.
-        const auto global_learning_rate =
-            read_shared_data<double>(m_index_to_global_learning_rate).get();
-        const auto global_state =
-            read_shared_data<Tuner_Step_State>(m_index_to_global_state).get();
-        const auto global_timestep =
-            read_shared_data<uint64_t>(m_index_to_timestep).get();
+        // Grab necessary shared data, the global state is a snapshot so, it is
+        // neither locked nor copied.
+        const double   global_learning_rate = shared().learning_rate;
+        const uint64_t global_timestep      = shared().timestep;
+        const std::shared_ptr<const Tuner_Step_State> global_state_snapshot =
+            shared().global_state.read();
+        const Tuner_Step_State& global_state = *global_state_snapshot;
 
         // Grab necessary private data.
         const auto& tuner_instance =
             std::any_cast<std::reference_wrapper<const Tuner>>(
                 read_private_data(m_index_to_tuner))
                 .get();
-        const auto& batch =
+        const auto& mini_batch =
             std::any_cast<std::reference_wrapper<const Mini_Batch>>(
                 read_private_data(m_index_to_data))
                 .get();
+        const auto worker =
+            std::any_cast<std::size_t>(read_private_data(m_index_to_worker));
+
+        const Mini_Batch batch =
+            tuner_instance.create_worker_batch(mini_batch, worker);
+
+        shared().split_sizes[worker]              = batch.features.size;
+        shared().weight_update_magnitudes[worker] = 0.0;
+
+        // There are more threads than positions in the mini-batch, the state
+        // of this worker isn't part of the average.
+        if (batch.features.size == 0) { return true; }
+
+        // This worker's local state, no other worker writes to it. It is
+        // allocated by the worker such that, it is placed on the worker's NUMA
+        // node.
+        std::unique_ptr<Tuner_Step_State>& local_state_slot =
+            shared().local_states[worker];
+        if (!local_state_slot)
+        {
+            local_state_slot = std::make_unique<Tuner_Step_State>();
+        }
+        Tuner_Step_State& local_state = *local_state_slot;
 
         // Calculate the local gradient using the global state's weights.
-        Evaluation_Weights<double> gradient =
+        const Evaluation_Weights<double> gradient =
             tuner_instance.compute_gradient(global_state.weights, batch);
-        gradient =
-            tuner_instance.projected_gradient(global_state.weights, gradient);
-
-        // Local first moment calculation based on global first moment.
-        const Evaluation_Weights<double> first_moment =
-            (global_state.first_moment * TUNER_DECAY_FACTOR)
-            + (gradient * (1.0L - TUNER_DECAY_FACTOR));
-
-        // Commit the calculated local first moment to this thread's local
-        // state in shared memory.
-        call_shared_data<Tuner_Step_States_Array>(
-            m_index_to_local_states,
-            [&](Tuner_Step_States_Array& states)
-            { states[get_assigned_thread_id()].first_moment = first_moment; });
-
-        // Second moment calculation
-        const Evaluation_Weights<double> second_moment =
-            (global_state.second_moment * TUNER_NU)
-            + ((gradient * gradient) * (1.0L - TUNER_NU));
-
-        // Commit the calculated local second moment to this thread's local
-        // state in shared memory.
-        call_shared_data<Tuner_Step_States_Array>(
-            m_index_to_local_states,
-            [&](Tuner_Step_States_Array& states)
+
+        // The bias corrections only depend on the timestep.
+        const double first_moment_correction =
+            1.0 - std::pow(TUNER_DECAY_FACTOR, (global_timestep + 1));
+        const double gradient_correction =
+            1.0 - std::pow(TUNER_DECAY_FACTOR, global_timestep);
+        const double second_moment_correction =
+            1.0 - std::pow(TUNER_NU, global_timestep);
+
+        const double* global_first_moment  = global_state.first_moment.data();
+        const double* global_second_moment = global_state.second_moment.data();
+        const double* global_weights       = global_state.weights.data();
+        const double* local_gradient       = gradient.data();
+
+        // Committed straight to this worker's local state.
+        double* first_moment  = local_state.first_moment.data();
+        double* second_moment = local_state.second_moment.data();
+        double* weights       = local_state.weights.data();
+
+        double weight_update_magnitude_squared = 0.0;
+
+        // The whole NADAM step is one pass over the weights such that, no
+        // intermediate weights are materialized.
+        for (std::size_t i = 0; i < Evaluation_Weights<double>::SIZE; ++i)
+        {
+            const double g = tuner_instance.projected_gradient(
+                global_weights[i],
+                local_gradient[i]);
+
+            // Local first and second moment calculation based on the global
+            // moments.
+            first_moment[i] = (global_first_moment[i] * TUNER_DECAY_FACTOR)
+                            + (g * (1.0 - TUNER_DECAY_FACTOR));
+            second_moment[i] = (global_second_moment[i] * TUNER_NU)
+                             + ((g * g) * (1.0 - TUNER_NU));
+
+            // Bias-corrected first moment calculation - notice that the extra
+            // gradient term in the bias-correct first moment is where NADAM
+            // comes into play. This addition is algebraically equivalent to
+            // considering the previous momentum into the calculation of this
+            // iteration's gradient.
+            const double first_moment_corrected =
+                ((first_moment[i] * TUNER_DECAY_FACTOR)
+                 / first_moment_correction)
+                + ((g * (1.0 - TUNER_DECAY_FACTOR)) / gradient_correction);
+
+            const double second_moment_corrected =
+                (second_moment[i] * TUNER_NU) / second_moment_correction;
+
+            // Weight update with respect to the gradient and moments.
+            const double weight_update =
+                (global_learning_rate
+                 / std::sqrt(second_moment_corrected + TUNER_EPSILON))
+                * first_moment_corrected;
+
+            weight_update_magnitude_squared += (weight_update * weight_update);
+
+            // Decoupled weight decay (concept from AdamW) added to the update.
+            const double weight_decay_update =
+                global_weights[i] * TUNER_REGULARIZATION_LAMBDA
+                * global_learning_rate;
+
+            weights[i] = tuner_instance.projected_weight_change(
+                global_weights[i],
+                (weight_update + weight_decay_update));
+        }
+
+        // The magnitudes of all workers are summed into the weight update
+        // magnitude average - this is used in one of the methods to terminate
+        // the tuning.
+        shared().weight_update_magnitudes[worker] =
+            std::sqrt(weight_update_magnitude_squared);
+
+        return true;
+    }
+};
+
+class Tuner_Reduce : public Typed_Thread_Job<Tuner_Step_Shared_Data>
+{
+  private:
+
+    std::size_t m_index_to_begin;
+    std::size_t m_index_to_end;
+
+  public:
+
+    // The job averages the weights in [begin, end) of every local state,
+    // weighted by the size of its split, into the next global state. Every job
+    // owns a disjoint slice of the weights so, the work of a job does not grow
+    // with the number of threads and no job copies a full state.
+    Tuner_Reduce(Tuner_Step_Shared_Data& shared_data,
+                 const std::size_t       begin,
+                 const std::size_t       end) :
+        Typed_Thread_Job(shared_data)
+    {
+        m_index_to_begin = write_to_private_data<std::size_t>(begin);
+        m_index_to_end   = write_to_private_data<std::size_t>(end);
+    }
+
+    virtual bool has_job() const override { return true; }
+
+    virtual std::any operator()(std::stop_token) override
+    {
+        const Tuner_Step_Shared_Data::Local_States& states =
+            shared().local_states;
+        Tuner_Step_State& next_global_state = shared().next_global_state;
+
+        const auto begin =
+            std::any_cast<std::size_t>(read_private_data(m_index_to_begin));
+        const auto end =
+            std::any_cast<std::size_t>(read_private_data(m_index_to_end));
+
+        const Thread_Result_Slots<std::size_t>& split_sizes =
+            shared().split_sizes;
+
+        std::size_t num_of_positions = 0;
+        for (std::size_t worker = 0; worker < states.size(); ++worker)
+        {
+            num_of_positions += split_sizes[worker];
+        }
+
+        MATREX_ASSERT((num_of_positions > 0),
+                      "A tuner step is reduced without any positions.");
+
+        const double total_split_size = static_cast<double>(num_of_positions);
+
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            double first_moment  = 0.0L;
+            double second_moment = 0.0L;
+            double weight        = 0.0L;
+
+            // Summed in worker order such that the average is deterministic.
+            for (std::size_t worker = 0; worker < states.size(); ++worker)
             {
-                states[get_assigned_thread_id()].second_moment = second_moment;
-            });
-
-        // Bias-corrected first moment calculation - notice that the extra
-        // gradient term in the bias-correct first moment is where NADAM comes
-        // into play. This addition is algebraically equivalent to considering
-        // the previous momentum into the calculation of this iteration's
-        // gradient.
-        const Evaluation_Weights<double> first_moment_corrected =
-            ((first_moment * TUNER_DECAY_FACTOR)
-             / (1.0L - std::pow(TUNER_DECAY_FACTOR, (global_timestep + 1))))
-            + ((gradient * (1.0L - TUNER_DECAY_FACTOR))
-               / (1.0L - std::pow(TUNER_DECAY_FACTOR, global_timestep)));
-
-        // Bias-corrected second moment calculation
-        const Evaluation_Weights<double> second_moment_corrected =
-            (second_moment * TUNER_NU)
-            / (1.0L - std::pow(TUNER_NU, global_timestep));
-
-        // Weight update with respect to the gradient and moments.
-        const Evaluation_Weights<double> weight_update =
-            ((global_learning_rate
-              / (second_moment_corrected + TUNER_EPSILON).sqrt())
-             * first_moment_corrected);
-
-        // Calculate the magnitude of the weight update vector and then sum it
-        // into the global weight update magnitude - this is used in one of the
-        // methods to terminate the tuning.
-        const double weight_update_magnitude = weight_update.magnitude();
-        call_shared_data<double>(m_index_to_weight_update_magnitude_average,
-                                 [&](double& average)
-                                 { average += weight_update_magnitude; });
-
-        // Decoupled weight decay calculation (concept from AdamW)
-        const Evaluation_Weights<double> decoupled_weight_decay =
-            global_state.weights * TUNER_REGULARIZATION_LAMBDA;
-        const Evaluation_Weights<double> weight_decay_update =
-            decoupled_weight_decay * global_learning_rate;
-
-        // Total weight update
-        const Evaluation_Weights<double> total_weight_update =
-            weight_update + weight_decay_update;
-
-        // Calculate the final weights and commit them to this thread's local
-        // state in shared memory.
-        const Evaluation_Weights<double> weights =
-            tuner_instance.projected_weight_change(global_state.weights,
-                                                   total_weight_update);
-        call_shared_data<Tuner_Step_States_Array>(
-            m_index_to_local_states,
-            [&](Tuner_Step_States_Array& states)
-            { states[get_assigned_thread_id()].weights = weights; });
-
-        return weights;
+                if (split_sizes[worker] == 0) { continue; }
+
+                const double split_size =
+                    static_cast<double>(split_sizes[worker]);
+
+                first_moment  += states[worker]->first_moment[i] * split_size;
+                second_moment += states[worker]->second_moment[i] * split_size;
+                weight        += states[worker]->weights[i] * split_size;
+            }
+
+            next_global_state.first_moment[i] = first_moment / total_split_size;
+            next_global_state.second_moment[i] =
+                second_moment / total_split_size;
+            next_global_state.weights[i] = weight / total_split_size;
+        }
+
+        return true;
+    }
+};
+
+class Tuner_Loss : public Typed_Thread_Job<Tuner_Loss_Shared_Data>
+{
+  private:
+
+    std::size_t m_index_to_tuner;
+    std::size_t m_index_to_first_mini_batch;
+
+  public:
+
+    // The job computes the loss of every num_of_threads-th mini-batch of the
+    // dataset starting at first_mini_batch.
+    Tuner_Loss(Tuner_Loss_Shared_Data& shared_data,
+               const Tuner&            tuner_instance,
+               const std::size_t       first_mini_batch) :
+        Typed_Thread_Job(shared_data)
+    {
+        m_index_to_tuner = write_reference_to_private_data(tuner_instance);
+        m_index_to_first_mini_batch =
+            write_to_private_data<std::size_t>(first_mini_batch);
+    }
+
+    virtual bool has_job() const override { return true; }
+
+    virtual std::any operator()(std::stop_token) override
+    {
+        const auto& tuner_instance =
+            std::any_cast<std::reference_wrapper<const Tuner>>(
+                read_private_data(m_index_to_tuner))
+                .get();
+        const auto first_mini_batch = std::any_cast<std::size_t>(
+            read_private_data(m_index_to_first_mini_batch));
+
+        const Dataset&                    dataset = shared().dataset;
+        const Evaluation_Weights<double>& weights = shared().weights;
+
+        // Every mini-batch has it's own slot so, the jobs write without a lock
+        // and the reduction of the slots is independent of which thread
+        // computed them.
+        for (std::size_t i = first_mini_batch; i < dataset.mini_batches.size();
+             i += tuner_instance.get_num_of_threads())
+        {
+            shared().mini_batch_losses[i] =
+                tuner_instance.compute_mini_batch_loss(dataset.mini_batches[i],
+                                                       weights);
+        }
+
+        return true;
+    }
+};
+
+class Tuner_Gradient : public Typed_Thread_Job<Tuner_Gradient_Shared_Data>
+{
+  private:
+
+    std::size_t m_index_to_tuner;
+    std::size_t m_index_to_worker;
+
+  public:
+
+    // The job sums the gradients of every num_of_threads-th mini-batch of the
+    // dataset starting at the worker's index.
+    Tuner_Gradient(Tuner_Gradient_Shared_Data& shared_data,
+                   const Tuner&                tuner_instance,
+                   const std::size_t           worker) :
+        Typed_Thread_Job(shared_data)
+    {
+        m_index_to_tuner  = write_reference_to_private_data(tuner_instance);
+        m_index_to_worker = write_to_private_data<std::size_t>(worker);
+    }
+
+    virtual bool has_job() const override { return true; }
+
+    virtual std::any operator()(std::stop_token) override
+    {
+        const auto& tuner_instance =
+            std::any_cast<std::reference_wrapper<const Tuner>>(
+                read_private_data(m_index_to_tuner))
+                .get();
+        const auto worker =
+            std::any_cast<std::size_t>(read_private_data(m_index_to_worker));
+
+        const Dataset&                    dataset = shared().dataset;
+        const Evaluation_Weights<double>& weights = shared().weights;
+
+        // The mini-batches of a worker depend only on the worker's index so,
+        // the sum of the slots is independent of which thread computed them.
+        Evaluation_Weights<double>& gradient_sum =
+            shared().gradient_sums[worker];
+        for (std::size_t i = worker; i < dataset.mini_batches.size();
+             i += tuner_instance.get_num_of_threads())
+        {
+            const Mini_Batch& mini_batch = dataset.mini_batches[i];
+            gradient_sum +=
+                (tuner_instance.compute_gradient(weights, mini_batch)
+                 * static_cast<double>(mini_batch.features.size));
+        }
+
+        return true;
     }
 };
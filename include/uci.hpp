@@ -14,6 +14,14 @@ class UCI
 
     void loop();
 
+    // Handles a single line of UCI input.
+    void handle_command(const std::string& line);
+
+    const Search_Constraints& get_search_constraints() const
+    {
+        return m_search_constraints;
+    }
+
   private:
 
     Chess_Board m_chess_board;
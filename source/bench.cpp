@@ -43,8 +43,10 @@ double Performance_Bench::bench_search(const uint16_t depth)
     constraints.depth                    = depth;
     constraints.transposition_table_size = 128;
 
-    uint64_t total_node_count = 0;
-    uint64_t total_time       = 0;
+    uint64_t total_node_count                   = 0;
+    uint64_t total_time                         = 0;
+    uint64_t total_beta_cutoff_count            = 0;
+    uint64_t total_first_move_beta_cutoff_count = 0;
 
     Timer t;
     for (const auto& fen : M_BENCH_FENS)
@@ -57,15 +59,37 @@ double Performance_Bench::bench_search(const uint16_t depth)
 
         total_time       += t.elapsed();
         total_node_count += se.get_node_count();
+
+        total_beta_cutoff_count += se.get_beta_cutoff_count();
+        total_first_move_beta_cutoff_count +=
+            se.get_first_move_beta_cutoff_count();
     }
 
     const double nps = static_cast<double>(total_node_count)
                      / (static_cast<double>(total_time)
                         / static_cast<double>(NANOSECONDS_IN_SECOND));
 
+    // Every position is searched to the same depth so, the average time of a
+    // search is the time-to-depth.
+    const double average_time_to_depth_ms =
+        (static_cast<double>(total_time) / M_BENCH_FENS.size)
+        / static_cast<double>(NANOSECONDS_IN_MILLISECOND);
+
+    // The share of beta cutoffs caused by the first move searched, the better
+    // the move ordering the closer it is to 100%.
+    const double first_move_cutoff_rate =
+        (total_beta_cutoff_count == 0)
+            ? 0.0
+            : (100.0 * static_cast<double>(total_first_move_beta_cutoff_count)
+               / static_cast<double>(total_beta_cutoff_count));
+
     std::cout << "=== SEARCH BENCH FOR DEPTH " << depth << " ===" << std::endl;
     std::cout << "Total node count is " << total_node_count << std::endl;
     std::cout << "Total time taken (in ns) is " << total_time << std::endl;
+    std::cout << "Average time to depth (in ms) is " << average_time_to_depth_ms
+              << std::endl;
+    std::cout << "First move cutoff rate is " << first_move_cutoff_rate << "%"
+              << std::endl;
     std::cout << "NPS: " << nps << std::endl;
 
     return nps;
@@ -235,6 +235,11 @@ Undo_Chess_Move Chess_Board::make_move(const Chess_Move& move)
 
     calculate_next_board_state(m_state.side_to_move, move);
 
+    if (NNUE::is_loaded())
+    {
+        update_nnue_accumulator<false>(m_state.side_to_move, move);
+    }
+
     const bool is_move_irreversible =
         ((move.moving_piece == PIECES::PAWN) || (move.is_capture)
          || (move.is_en_passant));
@@ -389,6 +394,73 @@ void Chess_Board::undo_move(const Undo_Chess_Move& undo_move)
 
     calculate_next_board_state(opposing_side, undo_move.move);
 
+    if (NNUE::is_loaded())
+    {
+        update_nnue_accumulator<true>(opposing_side, undo_move.move);
+    }
+
+    if (opposing_side == PIECE_COLOR::BLACK)
+    {
+        m_state.full_move_count = m_state.full_move_count - 1;
+    }
+
+    m_state.side_to_move = opposing_side;
+    m_zobrist_hash.flip_side_to_move();
+
+    m_state.hash_history_start  = undo_move.hash_history_start;
+    m_state.hash_history_length = undo_move.hash_history_length;
+}
+
+Undo_Chess_Move Chess_Board::make_null_move()
+{
+    const Undo_Chess_Move undo_move = {
+        .move                = Chess_Move(),
+        .castling_rights     = m_state.castling_rights,
+        .half_move_clock     = m_state.half_move_clock,
+        .enpassant_square    = m_state.enpassant_square,
+        .hash_history_start  = m_state.hash_history_start,
+        .hash_history_length = m_state.hash_history_length};
+
+    // No piece moves so, the NNUE accumulator is left untouched.
+    m_state.half_move_clock = m_state.half_move_clock + 1;
+
+    if (m_state.side_to_move == PIECE_COLOR::BLACK)
+    {
+        m_state.full_move_count = m_state.full_move_count + 1;
+    }
+
+    // The en passant capture is only available on the very next move.
+    m_zobrist_hash.update_en_passant_square(Square(m_state.enpassant_square));
+    m_state.enpassant_square = ESQUARE::NO_SQUARE;
+    m_zobrist_hash.update_en_passant_square(Square(m_state.enpassant_square));
+
+    m_state.side_to_move = (PIECE_COLOR) ((~m_state.side_to_move) & 0x1);
+    m_zobrist_hash.flip_side_to_move();
+
+    // A position after a null move is not reachable by legal moves so, it must
+    // never repeat a position from before the null move.
+    if (!is_draw_by_fifty_move_rule())
+    {
+        m_state.hash_history_start                 = m_state.half_move_clock;
+        m_hash_history[m_state.hash_history_start] = m_zobrist_hash;
+        m_state.hash_history_length                = 1;
+    }
+    else { m_state.hash_history_length = 0; }
+
+    return undo_move;
+}
+
+void Chess_Board::undo_null_move(const Undo_Chess_Move& undo_move)
+{
+    m_zobrist_hash.update_en_passant_square(Square(m_state.enpassant_square));
+
+    m_state.half_move_clock  = undo_move.half_move_clock;
+    m_state.enpassant_square = undo_move.enpassant_square;
+
+    m_zobrist_hash.update_en_passant_square(Square(m_state.enpassant_square));
+
+    const PIECE_COLOR opposing_side = ~m_state.side_to_move;
+
     if (opposing_side == PIECE_COLOR::BLACK)
     {
         m_state.full_move_count = m_state.full_move_count - 1;
@@ -637,6 +709,8 @@ void Chess_Board::set_from_fen(const std::string& fen)
     m_hash_history[m_state.half_move_clock] = m_zobrist_hash;
     m_state.hash_history_start              = m_state.half_move_clock;
     m_state.hash_history_length             = 1;
+
+    if (NNUE::is_loaded()) { refresh_nnue_accumulator(); }
 }
 
 std::string Chess_Board::to_fen()
@@ -768,6 +842,113 @@ std::string Chess_Board::to_fen()
     return fen;
 }
 
+void Chess_Board::set_from_packed_position(const Packed_Position& packed)
+{
+    m_piece_bitboards           = {};
+    m_color_occupancy_bitboards = {};
+
+    m_zobrist_hash = Zobrist_Hash();
+
+    // The piece codes are in the same order as the occupied squares.
+    uint8_t piece_idx = 0;
+    for (const Square s : Bitboard(packed.occupancy))
+    {
+        const uint8_t code =
+            (packed.pieces[piece_idx >> 1] >> ((piece_idx & 0x1) << 2)) & 0xF;
+        const PIECE_COLOR color = (PIECE_COLOR) (code >> 3);
+        const PIECES      piece = (PIECES) (code & 0x7);
+
+        m_piece_bitboards[color][piece].set_square(s);
+        m_color_occupancy_bitboards[color].set_square(s);
+        m_zobrist_hash.update_piece(color, piece, s);
+
+        ++piece_idx;
+    }
+
+    m_state.side_to_move = (PIECE_COLOR) packed.side_to_move;
+    if (m_state.side_to_move == PIECE_COLOR::BLACK)
+    {
+        m_zobrist_hash.flip_side_to_move();
+    }
+
+    // Castling rook files are stored 3 bits each in the same order as the
+    // castling rights flags (white kingside, white queenside, black kingside,
+    // black queenside).
+    m_state.castling_rights = packed.castling_rights;
+    for (uint8_t flag_idx = 0; flag_idx < NUM_OF_CASTLING_RIGHTS_FLAGS;
+         ++flag_idx)
+    {
+        const PIECE_COLOR color = (PIECE_COLOR) (flag_idx >> 1);
+        const uint8_t rank = (color == PIECE_COLOR::WHITE)
+                               ? (NUM_OF_RANKS_ON_CHESS_BOARD - 1)
+                               : 0;
+        const uint8_t rook_file =
+            (packed.castling_rook_files >> (flag_idx * 3)) & 0x7;
+
+        if ((flag_idx & 0x1) == CASTLING_TYPE::KINGSIDE)
+        {
+            m_state.castling_rooks[color].kingside = Square(rank, rook_file);
+        }
+        else
+        {
+            m_state.castling_rooks[color].queenside = Square(rank, rook_file);
+        }
+    }
+    m_zobrist_hash.update_castling_rights(m_state.castling_rights);
+
+    m_state.enpassant_square = (ESQUARE) packed.enpassant_square;
+    m_zobrist_hash.update_en_passant_square(m_state.enpassant_square);
+
+    m_state.half_move_clock = packed.half_move_clock;
+    m_state.full_move_count = packed.full_move_count;
+
+    m_hash_history[m_state.half_move_clock] = m_zobrist_hash;
+    m_state.hash_history_start              = m_state.half_move_clock;
+    m_state.hash_history_length             = 1;
+
+    if (NNUE::is_loaded()) { refresh_nnue_accumulator(); }
+}
+
+Packed_Position Chess_Board::to_packed_position() const
+{
+    Packed_Position packed {};
+
+    packed.occupancy = get_both_color_occupancies().get_board();
+
+    uint8_t piece_idx = 0;
+    for (const Square s : get_both_color_occupancies())
+    {
+        const auto [color, piece] = what_piece_is_on_square(s);
+        const uint8_t code        = (color << 3) | piece;
+
+        packed.pieces[piece_idx >> 1] |= code << ((piece_idx & 0x1) << 2);
+
+        ++piece_idx;
+    }
+
+    packed.castling_rights = m_state.castling_rights;
+    for (uint8_t flag_idx = 0; flag_idx < NUM_OF_CASTLING_RIGHTS_FLAGS;
+         ++flag_idx)
+    {
+        const PIECE_COLOR color     = (PIECE_COLOR) (flag_idx >> 1);
+        const Square      rook      = ((flag_idx & 0x1) == CASTLING_TYPE::KINGSIDE)
+                                        ? m_state.castling_rooks[color].kingside
+                                        : m_state.castling_rooks[color].queenside;
+        const uint8_t     rook_file = ((m_state.castling_rights >> flag_idx) & 0x1)
+                                        ? rook.get_file()
+                                        : 0;
+
+        packed.castling_rook_files |= rook_file << (flag_idx * 3);
+    }
+
+    packed.side_to_move     = m_state.side_to_move;
+    packed.enpassant_square = m_state.enpassant_square;
+    packed.half_move_clock  = m_state.half_move_clock;
+    packed.full_move_count  = m_state.full_move_count;
+
+    return packed;
+}
+
 // Helper: take a substring describing a single rank (e.g. "rnbqkbnr" or
 // "p3pppp") and place the corresponding pieces into bitboards
 void Chess_Board::place_pieces_from_fen(const std::string& rank_description,
@@ -902,6 +1083,15 @@ bool Chess_Board::is_draw_by_fifty_move_rule() const
     return (m_state.half_move_clock >= HALF_MOVE_CLOCK_MAXIMUM);
 }
 
+bool Chess_Board::has_non_pawn_material(const PIECE_COLOR c) const
+{
+    const uint64_t pawns_and_king =
+        (get_piece_occupancies(c, PIECES::PAWN).get_board()
+         | get_piece_occupancies(c, PIECES::KING).get_board());
+
+    return ((get_color_occupancies(c).get_board() & ~pawns_and_king) != 0);
+}
+
 bool Chess_Board::has_insufficient_mating_material() const
 {
     const uint8_t total_pieces = get_both_color_occupancies().high_bit_count();
@@ -933,6 +1123,18 @@ bool Chess_Board::has_insufficient_mating_material() const
             && fourth_condition);
 }
 
+// Recomputes the NNUE accumulator from scratch - needed whenever the board is
+// set without going through make or undo move or a new network is loaded.
+void Chess_Board::refresh_nnue_accumulator()
+{
+    m_nnue_accumulator.refresh(m_piece_bitboards);
+}
+
+const NNUE_Accumulator& Chess_Board::get_nnue_accumulator() const
+{
+    return m_nnue_accumulator;
+}
+
 bool Chess_Board::operator==(const Chess_Board& other) const
 {
     return (other.m_state == m_state)
@@ -0,0 +1,255 @@
+#include "datagen.hpp"
+
+#include <chrono>
+#include <future>
+#include <stdexcept>
+
+#include "cuckoo_reversible_move_table.hpp"
+#include "move_generator.hpp"
+#include "timer.hpp"
+
+namespace
+{
+
+// Plays uniformly random legal moves from the start position. Returns false if
+// the random moves ended the game such that, the caller picks a new opening.
+bool play_random_opening(Chess_Board&          cb,
+                         Psuedo_RNG<uint64_t>& rng,
+                         const uint16_t        num_of_plies)
+{
+    cb.set_from_fen(std::string(START_POSITION_FEN));
+
+    for (uint16_t ply = 0; ply < num_of_plies; ++ply)
+    {
+        Move_Generator        mg(cb);
+        Move_Generation_List  moves;
+        Moves_Bitboard_Matrix matrix;
+        mg.generate_all_moves<MOVE_GENERATION_TYPE::ALL>(moves, matrix);
+
+        const int16_t num_of_moves = (moves.get_max_index() + 1);
+        if (num_of_moves == 0) { return false; }
+
+        cb.make_move(moves[rng.generate_random() % num_of_moves]);
+    }
+
+    return true;
+}
+
+} // namespace
+
+void play_self_play_game(Search_Engine&                engine,
+                         Psuedo_RNG<uint64_t>&         rng,
+                         const Datagen_Options&        options,
+                         std::vector<Packed_Position>& game_positions)
+{
+    Chess_Board cb;
+    while (!play_random_opening(cb, rng, DATAGEN_NUM_OF_RANDOM_OPENING_PLIES))
+    {
+    }
+
+    Search_Constraints constraints;
+    constraints.should_ignore_time       = true;
+    constraints.depth                    = options.depth;
+    constraints.nodes                    = options.nodes;
+    constraints.transposition_table_size = DATAGEN_TRANSPOSITION_TABLE_SIZE;
+    constraints.should_print_info        = false;
+
+    engine.new_game();
+
+    const Cuckoo_RM_Table rm_table;
+    const std::size_t     first_game_position = game_positions.size();
+
+    // Anything that ends the game without a decisive result (fifty move rule,
+    // repetition, insufficient material, stalemate, or the ply limit) is a
+    // draw.
+    PACKED_RESULT result = PACKED_RESULT::PACKED_DRAW;
+
+    for (uint16_t ply = 0; ply < options.max_game_plies; ++ply)
+    {
+        Move_Generator        mg(cb);
+        Move_Generation_List  moves;
+        Moves_Bitboard_Matrix matrix;
+        mg.generate_all_moves<MOVE_GENERATION_TYPE::ALL>(moves, matrix);
+
+        const PIECE_COLOR side_to_move = cb.get_side_to_move();
+
+        if (moves.get_max_index() == -1)
+        {
+            if (mg.is_side_to_move_in_check())
+            {
+                result = (side_to_move == PIECE_COLOR::WHITE)
+                           ? PACKED_RESULT::PACKED_LOSS
+                           : PACKED_RESULT::PACKED_WIN;
+            }
+
+            break;
+        }
+
+        bool is_three_fold_repetition = false;
+        rm_table.is_upcoming_repetition(cb, is_three_fold_repetition);
+
+        if (is_three_fold_repetition || cb.is_draw_by_fifty_move_rule()
+            || cb.has_insufficient_mating_material())
+        {
+            break;
+        }
+
+        const auto [best_move, score] = engine.search(cb, constraints);
+
+        // A found mate is played out by the engine anyway so, the game is
+        // adjudicated in favour of the mating side.
+        if (score.is_mating_score())
+        {
+            const bool is_white_winning =
+                ((score.to_int() > 0) == (side_to_move == PIECE_COLOR::WHITE));
+            result = is_white_winning ? PACKED_RESULT::PACKED_WIN
+                                      : PACKED_RESULT::PACKED_LOSS;
+            break;
+        }
+
+        const int16_t score_cp =
+            static_cast<int16_t>(score.to_fixed_point().get_integer());
+
+        Packed_Position packed = cb.to_packed_position();
+        packed.score = (side_to_move == PIECE_COLOR::WHITE) ? score_cp
+                                                            : -score_cp;
+        game_positions.push_back(packed);
+
+        cb.make_move(best_move);
+    }
+
+    for (std::size_t i = first_game_position; i < game_positions.size(); ++i)
+    {
+        game_positions[i].result = result;
+    }
+}
+
+Datagen::Datagen(std::ostream&   log,
+                 std::ostream&   output,
+                 Datagen_Options options) :
+    m_log(log),
+    m_output(output),
+    m_options(options),
+    m_thread_pool(options.num_of_threads, options.pin_threads)
+{
+    if (m_options.num_of_threads == 0)
+    {
+        throw std::invalid_argument(
+            "The data generator requires at least one thread.");
+    }
+
+    if ((m_options.depth <= 0) && (m_options.nodes == 0))
+    {
+        throw std::invalid_argument(
+            "The data generator requires a depth or a node limit.");
+    }
+
+    if (m_options.pin_threads
+        && (m_thread_pool.get_num_of_pinned_workers()
+            < m_options.num_of_threads))
+    {
+        m_log << "[INFO] Only " << m_thread_pool.get_num_of_pinned_workers()
+              << " of " << m_options.num_of_threads
+              << " threads could be pinned to a CPU." << std::endl;
+    }
+}
+
+uint64_t Datagen::generate()
+{
+    Datagen_Shared_Data shared_data {.options = m_options,
+                                     .output  = m_output};
+
+    Timer timer;
+    timer.start();
+
+    std::vector<std::future<std::any>> futures;
+    for (std::size_t i = 0; i < m_options.num_of_threads; ++i)
+    {
+        std::unique_ptr<Thread_Job> job =
+            std::make_unique<Datagen_Worker>(shared_data, i);
+
+        futures.push_back(m_thread_pool.push_job(std::move(job)));
+    }
+
+    // The main thread only reports progress while the workers play. Getting
+    // every future rethrows any exception a worker ran into.
+    for (std::future<std::any>& future : futures)
+    {
+        while (future.wait_for(std::chrono::milliseconds(
+                   DATAGEN_PROGRESS_INTERVAL_MS))
+               == std::future_status::timeout)
+        {
+            log_progress(shared_data, timer.elapsed());
+        }
+
+        future.get();
+    }
+
+    log_progress(shared_data, timer.elapsed());
+    m_output.flush();
+
+    return shared_data.num_of_positions.load();
+}
+
+void Datagen::log_progress(const Datagen_Shared_Data& shared_data,
+                           const uint64_t             elapsed_time)
+{
+    const uint64_t num_of_positions = shared_data.num_of_positions.load();
+    const double   elapsed_seconds =
+        static_cast<double>(elapsed_time) / NANOSECONDS_IN_SECOND;
+
+    const uint64_t positions_per_second =
+        (elapsed_seconds > 0.0L)
+            ? static_cast<uint64_t>(num_of_positions / elapsed_seconds)
+            : 0;
+
+    m_log << "[INFO] Games: " << shared_data.num_of_games_completed.load()
+          << "/" << m_options.num_of_games
+          << " Positions: " << num_of_positions << " Positions/s: "
+          << positions_per_second << std::endl;
+}
+
+std::any Datagen_Worker::operator()(std::stop_token)
+{
+    const auto worker =
+        std::any_cast<std::size_t>(read_private_data(m_index_to_worker));
+
+    const Datagen_Options& options = shared().options;
+
+    // The search engine is too large for a worker's stack. Every worker gets a
+    // distinct seed such that, no two workers play the same openings.
+    constexpr uint64_t WORKER_SEED_MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+
+    std::unique_ptr<Search_Engine> engine = std::make_unique<Search_Engine>();
+    Psuedo_RNG<uint64_t>           rng(options.seed
+                             ^ ((worker + 1) * WORKER_SEED_MULTIPLIER));
+
+    std::vector<Packed_Position> chunk;
+    chunk.reserve(DATASET_IO_CHUNK_SIZE + options.max_game_plies);
+
+    while (shared().next_game.fetch_add(1) < options.num_of_games)
+    {
+        const std::size_t num_of_buffered_positions = chunk.size();
+
+        play_self_play_game((*engine), rng, options, chunk);
+
+        shared().num_of_positions.fetch_add(
+            (chunk.size() - num_of_buffered_positions));
+        shared().num_of_games_completed.fetch_add(1);
+
+        if (chunk.size() >= DATASET_IO_CHUNK_SIZE) { flush_chunk(chunk); }
+    }
+
+    flush_chunk(chunk);
+
+    return {};
+}
+
+void Datagen_Worker::flush_chunk(std::vector<Packed_Position>& chunk)
+{
+    const std::lock_guard<std::mutex> lock(shared().output_mutex);
+
+    shared().output.write(reinterpret_cast<const char*>(chunk.data()),
+                          chunk.size() * sizeof(Packed_Position));
+    chunk.clear();
+}
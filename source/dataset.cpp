@@ -0,0 +1,81 @@
+#include "dataset.hpp"
+
+#include <string>
+
+uint64_t convert_text_dataset(std::istream& text_dataset,
+                              std::ostream& binary_dataset)
+{
+    std::vector<Packed_Position> chunk;
+    chunk.reserve(DATASET_IO_CHUNK_SIZE);
+
+    uint64_t num_of_positions = 0;
+
+    const auto flush_chunk = [&]()
+    {
+        binary_dataset.write(reinterpret_cast<const char*>(chunk.data()),
+                             chunk.size() * sizeof(Packed_Position));
+        num_of_positions += chunk.size();
+        chunk.clear();
+    };
+
+    Chess_Board cb;
+    std::string line;
+    while (std::getline(text_dataset, line))
+    {
+        const std::size_t last_space_pos = line.find_last_of(' ');
+        if (last_space_pos == std::string::npos) { continue; }
+
+        constexpr uint8_t MAX_SCORE_STRING_LENGTH = 3;
+        const double      score                   = std::stod(
+            line.substr((last_space_pos + 2),
+                        MAX_SCORE_STRING_LENGTH)); // +2 to skip space and
+                                                   // opening bracket
+
+        cb.set_from_fen(line.substr(0, last_space_pos));
+
+        Packed_Position packed = cb.to_packed_position();
+        packed.result          = score_to_packed_result(score);
+
+        chunk.push_back(packed);
+        if (chunk.size() == DATASET_IO_CHUNK_SIZE) { flush_chunk(); }
+    }
+
+    flush_chunk();
+    binary_dataset.flush();
+
+    return num_of_positions;
+}
+
+std::vector<Packed_Position> read_binary_dataset(std::istream& binary_dataset)
+{
+    binary_dataset.seekg(0, std::ios::end);
+    const std::streamoff file_size = binary_dataset.tellg();
+    binary_dataset.seekg(0, std::ios::beg);
+
+    if (file_size < 0)
+    {
+        throw std::runtime_error("Binary dataset size could not be read.");
+    }
+
+    if ((file_size % sizeof(Packed_Position)) != 0)
+    {
+        throw std::runtime_error(
+            "Binary dataset size is not a multiple of the packed position "
+            "size.");
+    }
+
+    // Packed positions are plain old data so, the file is read straight into
+    // the vector's storage without any parsing.
+    std::vector<Packed_Position> positions(file_size / sizeof(Packed_Position));
+    binary_dataset.read(reinterpret_cast<char*>(positions.data()), file_size);
+
+    // A short read would leave a partial record at the end such that, it
+    // would be parsed as a position.
+    if (binary_dataset.fail() || (binary_dataset.gcount() != file_size))
+    {
+        throw std::runtime_error(
+            "Binary dataset ended in the middle of a packed position.");
+    }
+
+    return positions;
+}
@@ -0,0 +1,321 @@
+#include "dataset_filter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+#include "move_generator.hpp"
+
+Dataset_Filter::Dataset_Filter(std::ostream&          log,
+                               Dataset_Filter_Options options) :
+    m_log(log),
+    m_options(std::move(options)),
+    m_thread_pool(m_options.num_of_threads)
+{
+    if (m_options.num_of_threads == 0)
+    {
+        throw std::invalid_argument(
+            "The dataset filter requires at least one thread.");
+    }
+
+    // The search engines are too large for the stack and are reused for every
+    // chunk such that, their tables are only allocated once.
+    for (std::size_t i = 0; i < m_options.num_of_threads; ++i)
+    {
+        m_engines.push_back(std::make_unique<Search_Engine>());
+    }
+}
+
+Dataset_Filter_Statistics Dataset_Filter::filter(std::istream& input,
+                                                 std::ostream& output)
+{
+    input.seekg(0, std::ios::end);
+    const std::streamoff file_size = input.tellg();
+    input.seekg(0, std::ios::beg);
+
+    if ((file_size % sizeof(Packed_Position)) != 0)
+    {
+        throw std::runtime_error(
+            "Binary dataset size is not a multiple of the packed position "
+            "size.");
+    }
+
+    const uint64_t num_of_input_positions =
+        (file_size / sizeof(Packed_Position));
+
+    // The kept positions are scattered to buckets by their hash which, are
+    // small enough to be deduplicated and shuffled in memory. The hash is
+    // independent of the input order so, concatenating the shuffled buckets in
+    // a random order gives a shuffled dataset.
+    const std::size_t num_of_buckets = std::max<std::size_t>(
+        1,
+        ((num_of_input_positions + DATASET_SHUFFLE_BUCKET_SIZE - 1)
+         / DATASET_SHUFFLE_BUCKET_SIZE));
+
+    const std::filesystem::path bucket_directory = create_bucket_directory();
+
+    std::vector<std::filesystem::path> bucket_paths;
+    std::vector<std::ofstream>         bucket_files;
+    for (std::size_t i = 0; i < num_of_buckets; ++i)
+    {
+        bucket_paths.push_back(bucket_directory
+                               / ("bucket_" + std::to_string(i) + ".bin"));
+        bucket_files.emplace_back(bucket_paths.back(),
+                                  (std::ios::binary | std::ios::trunc));
+
+        if (!bucket_files.back())
+        {
+            throw std::runtime_error("Failed to create a shuffle bucket file.");
+        }
+    }
+
+    std::vector<std::vector<Packed_Position>> bucket_buffers(num_of_buckets);
+
+    const auto flush_bucket = [&](const std::size_t bucket)
+    {
+        std::vector<Packed_Position>& buffer = bucket_buffers[bucket];
+        bucket_files[bucket].write(
+            reinterpret_cast<const char*>(buffer.data()),
+            buffer.size() * sizeof(Packed_Position));
+        buffer.clear();
+    };
+
+    Search_Constraints constraints;
+    constraints.should_ignore_time = true;
+    constraints.transposition_table_size =
+        DATASET_FILTER_TRANSPOSITION_TABLE_SIZE;
+    constraints.should_print_info = false;
+
+    Dataset_Filter_Statistics    statistics;
+    Psuedo_RNG<uint64_t>         rng(m_options.seed);
+    std::vector<Packed_Position> chunk;
+
+    while (statistics.num_of_positions_read < num_of_input_positions)
+    {
+        chunk.resize(std::min<uint64_t>(
+            DATASET_IO_CHUNK_SIZE,
+            (num_of_input_positions - statistics.num_of_positions_read)));
+        input.read(reinterpret_cast<char*>(chunk.data()),
+                   chunk.size() * sizeof(Packed_Position));
+
+        if (!input)
+        {
+            throw std::runtime_error("Failed to read a chunk of the dataset.");
+        }
+
+        statistics.num_of_positions_read += chunk.size();
+
+        Dataset_Filter_Shared_Data shared_data {
+            .chunk             = chunk,
+            .engines           = m_engines,
+            .constraints       = constraints,
+            .quiescence_margin = m_options.quiescence_margin,
+            .verdicts = std::vector<Dataset_Filter_Verdict>(chunk.size()),
+            .hashes   = std::vector<Zobrist_Hash_Storage_Type>(chunk.size())};
+
+        classify_chunk(shared_data);
+
+        // The positions are appended to the buckets in input order such that,
+        // the deduplication keeps the first occurrence of a position.
+        for (std::size_t i = 0; i < chunk.size(); ++i)
+        {
+            switch (shared_data.verdicts[i])
+            {
+                case Dataset_Filter_Verdict::IN_CHECK:
+                    ++statistics.num_of_positions_in_check;
+                    continue;
+                case Dataset_Filter_Verdict::NOT_QUIET:
+                    ++statistics.num_of_non_quiet_positions;
+                    continue;
+                case Dataset_Filter_Verdict::KEEP:
+                    break;
+            }
+
+            const std::size_t bucket =
+                (shared_data.hashes[i] % num_of_buckets);
+            bucket_buffers[bucket].push_back(chunk[i]);
+            if (bucket_buffers[bucket].size()
+                == DATASET_SHUFFLE_BUCKET_BUFFER_SIZE)
+            {
+                flush_bucket(bucket);
+            }
+        }
+
+        m_log << "[INFO] Filtered " << statistics.num_of_positions_read << "/"
+              << num_of_input_positions << " positions." << std::endl;
+    }
+
+    for (std::size_t i = 0; i < num_of_buckets; ++i)
+    {
+        flush_bucket(i);
+        bucket_files[i].close();
+    }
+
+    // Fisher-Yates shuffle of the order of the buckets.
+    for (std::size_t i = bucket_paths.size(); i > 1; --i)
+    {
+        std::swap(bucket_paths[i - 1],
+                  bucket_paths[rng.generate_random() % i]);
+    }
+
+    for (const std::filesystem::path& bucket_path : bucket_paths)
+    {
+        dedup_and_shuffle_bucket(bucket_path, rng, output, statistics);
+        std::filesystem::remove(bucket_path);
+    }
+
+    std::filesystem::remove(bucket_directory);
+
+    output.flush();
+
+    m_log << "[INFO] Positions read: " << statistics.num_of_positions_read
+          << " Duplicates: " << statistics.num_of_duplicates
+          << " In check: " << statistics.num_of_positions_in_check
+          << " Not quiet: " << statistics.num_of_non_quiet_positions
+          << " Positions written: " << statistics.num_of_positions_written
+          << std::endl;
+
+    return statistics;
+}
+
+void Dataset_Filter::classify_chunk(Dataset_Filter_Shared_Data& shared_data)
+{
+    for (std::size_t i = 0; i < m_options.num_of_threads; ++i)
+    {
+        std::unique_ptr<Thread_Job> job =
+            std::make_unique<Dataset_Filter_Worker>(shared_data, i);
+
+        m_thread_pool.push_job(std::move(job));
+    }
+
+    m_thread_pool.wait_for_jobs_to_complete();
+}
+
+std::filesystem::path Dataset_Filter::create_bucket_directory() const
+{
+    // Concurrent runs start from different times and create_directory fails
+    // if the directory exists so, no two runs ever share a directory.
+    uint64_t run_id = static_cast<uint64_t>(
+        std::chrono::steady_clock::now().time_since_epoch().count());
+
+    constexpr std::size_t MAX_ATTEMPTS = 1024;
+    for (std::size_t attempt = 0; attempt < MAX_ATTEMPTS; ++attempt, ++run_id)
+    {
+        const std::filesystem::path bucket_directory =
+            m_options.bucket_directory
+            / ("matrex_shuffle_" + std::to_string(run_id));
+
+        if (std::filesystem::create_directory(bucket_directory))
+        {
+            return bucket_directory;
+        }
+    }
+
+    throw std::runtime_error("Failed to create a shuffle bucket directory.");
+}
+
+void Dataset_Filter::dedup_and_shuffle_bucket(
+    const std::filesystem::path& bucket_path,
+    Psuedo_RNG<uint64_t>&        rng,
+    std::ostream&                output,
+    Dataset_Filter_Statistics&   statistics)
+{
+    std::ifstream bucket_file(bucket_path, std::ios::binary);
+    std::vector<Packed_Position> positions = read_binary_dataset(bucket_file);
+
+    // Sorting the indices by hash groups the duplicates, the stable sort keeps
+    // the first occurrence of every position first in it's group.
+    std::vector<Zobrist_Hash_Storage_Type> hashes(positions.size());
+    Chess_Board                            cb;
+    for (std::size_t i = 0; i < positions.size(); ++i)
+    {
+        cb.set_from_packed_position(positions[i]);
+        hashes[i] = cb.get_zobrist_hash().get_hash_value();
+    }
+
+    std::vector<uint32_t> indices(positions.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::stable_sort(indices.begin(),
+                     indices.end(),
+                     [&](const uint32_t a, const uint32_t b)
+                     { return (hashes[a] < hashes[b]); });
+
+    // The duplicates are dropped in place such that, the bucket is never
+    // copied.
+    std::vector<bool> is_duplicate(positions.size(), false);
+    for (std::size_t i = 1; i < indices.size(); ++i)
+    {
+        if (hashes[indices[i]] == hashes[indices[i - 1]])
+        {
+            is_duplicate[indices[i]] = true;
+            ++statistics.num_of_duplicates;
+        }
+    }
+
+    std::size_t num_of_unique_positions = 0;
+    for (std::size_t i = 0; i < positions.size(); ++i)
+    {
+        if (!is_duplicate[i])
+        {
+            positions[num_of_unique_positions++] = positions[i];
+        }
+    }
+    positions.resize(num_of_unique_positions);
+
+    // Fisher-Yates shuffle.
+    for (std::size_t i = positions.size(); i > 1; --i)
+    {
+        std::swap(positions[i - 1], positions[rng.generate_random() % i]);
+    }
+
+    output.write(reinterpret_cast<const char*>(positions.data()),
+                 positions.size() * sizeof(Packed_Position));
+
+    statistics.num_of_positions_written += positions.size();
+}
+
+std::any Dataset_Filter_Worker::operator()(std::stop_token)
+{
+    const auto worker =
+        std::any_cast<std::size_t>(read_private_data(m_index_to_worker));
+
+    const std::vector<Packed_Position>& chunk = shared().chunk;
+    Search_Engine& engine = (*shared().engines[worker]);
+
+    // Every worker classifies a contiguous slice of the chunk.
+    const std::size_t num_of_workers = shared().engines.size();
+    const std::size_t begin = ((chunk.size() * worker) / num_of_workers);
+    const std::size_t end   = ((chunk.size() * (worker + 1)) / num_of_workers);
+
+    Chess_Board cb;
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        cb.set_from_packed_position(chunk[i]);
+        shared().hashes[i] = cb.get_zobrist_hash().get_hash_value();
+
+        Move_Generator mg(cb);
+        if (mg.is_side_to_move_in_check())
+        {
+            shared().verdicts[i] = Dataset_Filter_Verdict::IN_CHECK;
+            continue;
+        }
+
+        const auto [static_evaluation, quiescence_score] =
+            engine.static_and_quiescence_scores(cb, shared().constraints);
+
+        const int32_t quiescence_gain =
+            (quiescence_score.to_fixed_point().get_integer()
+             - static_evaluation.to_fixed_point().get_integer());
+
+        shared().verdicts[i] =
+            (std::abs(quiescence_gain) > shared().quiescence_margin)
+                ? Dataset_Filter_Verdict::NOT_QUIET
+                : Dataset_Filter_Verdict::KEEP;
+    }
+
+    return {};
+}
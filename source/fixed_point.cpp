@@ -15,42 +15,24 @@ namespace Matrex
 
     AD_Value tanh(AD_Value x)
     {
-        const double result_value = std::tanh(x.value());
-
-        return {.tape = x.tape,
-                .node = x.tape.get_ref().push(
-                    AD_Node(result_value,
-                            std::make_unique<AD_Adjoint_Tanh>(x.node)))};
+        return x.unary_operation(AD_OPCODE::TANH, std::tanh(x.value()));
     }
 
     AD_Value pow(AD_Value base, AD_Value exponent)
     {
-        const double result_value = std::pow(base.value(), exponent.value());
-
-        return {
-            .tape = base.tape,
-            .node = base.tape.get_ref().push(AD_Node(
-                result_value,
-                std::make_unique<AD_Adjoint_Pow>(base.node, exponent.node)))};
+        return base.binary_operation(
+            AD_OPCODE::POW,
+            std::pow(base.value(), exponent.value()),
+            exponent);
     }
 
     AD_Value sqrt(AD_Value x)
     {
-        const double result_value = std::sqrt(x.value());
-
-        return {.tape = x.tape,
-                .node = x.tape.get_ref().push(
-                    AD_Node(result_value,
-                            std::make_unique<AD_Adjoint_Sqrt>(x.node)))};
+        return x.unary_operation(AD_OPCODE::SQRT, std::sqrt(x.value()));
     }
 
     AD_Value exp(AD_Value x)
     {
-        const double result_value = std::exp(x.value());
-
-        return {.tape = x.tape,
-                .node = x.tape.get_ref().push(
-                    AD_Node(result_value,
-                            std::make_unique<AD_Adjoint_Exp>(x.node)))};
+        return x.unary_operation(AD_OPCODE::EXP, std::exp(x.value()));
     }
 } // namespace Matrex
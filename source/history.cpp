@@ -80,3 +80,60 @@ void Capture_Continuation_History_Table::clear()
         for (auto& inner_table : outer_table) { inner_table.clear(); }
     }
 }
+
+Butterfly_History_Table::Butterfly_History_Table() { clear(); }
+
+History_Score_Storage_Type
+Butterfly_History_Table::get(const PIECE_COLOR side_to_move,
+                             const Chess_Move& move) const
+{
+    return m_table[side_to_move][move.source_square][move.destination_square];
+}
+
+void Butterfly_History_Table::clear() { m_table.fill(0); }
+
+Killer_Moves::Killer_Moves() { clear(); }
+
+void Killer_Moves::update(const Chess_Move& move)
+{
+    // A move already in the first slot would only push out the other killer.
+    if (move.is_same_move(m_moves[0])) { return; }
+
+    for (std::size_t i = (NUM_OF_KILLER_MOVES - 1); i > 0; --i)
+    {
+        m_moves[i] = m_moves[i - 1];
+    }
+
+    m_moves[0] = move;
+}
+
+std::size_t Killer_Moves::find(const Chess_Move& move) const
+{
+    for (std::size_t i = 0; i < NUM_OF_KILLER_MOVES; ++i)
+    {
+        if (move.is_same_move(m_moves[i])) { return i; }
+    }
+
+    return NUM_OF_KILLER_MOVES;
+}
+
+void Killer_Moves::clear() { m_moves.fill(Chess_Move()); }
+
+Counter_Move_Table::Counter_Move_Table() { clear(); }
+
+Chess_Move& Counter_Move_Table::get(const PIECE_COLOR side_to_move,
+                                    const Chess_Move& previous_move)
+{
+    return m_table[side_to_move][previous_move.moving_piece]
+                  [previous_move.destination_square];
+}
+
+const Chess_Move&
+Counter_Move_Table::get(const PIECE_COLOR side_to_move,
+                        const Chess_Move& previous_move) const
+{
+    return m_table[side_to_move][previous_move.moving_piece]
+                  [previous_move.destination_square];
+}
+
+void Counter_Move_Table::clear() { m_table.fill(Chess_Move()); }
@@ -1,5 +1,8 @@
+#include <chrono>
 #include <iostream>
 
+#include "datagen.hpp"
+#include "dataset_filter.hpp"
 #include "tuner.hpp"
 #include "uci.hpp"
 #include "bench.hpp"
@@ -20,13 +23,118 @@ int main(int argc, char* argv[])
     {
         if (std::string(argv[1]) == "tune")
         {
-            std::ofstream log_file("../../../source/assets/tuner.log");
+            // Optional: tune [<number of threads>] [pin] [lbfgs] [--resume]
+            //               [stream <memory budget in MiB>]
+            std::size_t     num_of_threads = TUNER_DEFAULT_NUM_OF_THREADS;
+            bool            pin_threads    = false;
+            bool            resume         = false;
+            std::size_t     memory_budget  = 0;
+            Tuner_Optimizer optimizer      = Tuner_Optimizer::NADAM;
+            for (int i = 2; i < argc; ++i)
+            {
+                const std::string argument(argv[i]);
+                if (argument == "pin") { pin_threads = true; }
+                else if (argument == "--resume") { resume = true; }
+                else if (argument == "lbfgs")
+                {
+                    optimizer = Tuner_Optimizer::LBFGS;
+                }
+                else if ((argument == "stream") && ((i + 1) < argc))
+                {
+                    constexpr std::size_t BYTES_IN_MEBIBYTE = (1 << 20);
+                    memory_budget = std::stoull(argv[++i]) * BYTES_IN_MEBIBYTE;
+                }
+                else { num_of_threads = std::stoull(argument); }
+            }
+
+            if (resume && (optimizer == Tuner_Optimizer::LBFGS))
+            {
+                std::cerr << "Only NADAM tuning can be resumed." << std::endl;
+                return 1;
+            }
+
+            if ((memory_budget != 0) && (optimizer == Tuner_Optimizer::LBFGS))
+            {
+                std::cerr << "Only NADAM tuning can stream the dataset."
+                          << std::endl;
+                return 1;
+            }
+
+            // A resumed tuning continues the log of the interrupted one.
+            std::ofstream log_file("../../../source/assets/tuner.log",
+                                   resume ? std::ios::app : std::ios::out);
             std::ifstream dataset_file(
-                "../../../source/assets/lichess-big3-resolved.book");
+                "../../../source/assets/lichess-big3-resolved.bin",
+                std::ios::binary);
             std::ofstream output_file(
                 "../../../source/assets/evaluation_terms.hpp");
-            Tuner tuner(log_file, dataset_file, output_file);
-            tuner.tune();
+
+            Tuner tuner(log_file,
+                        dataset_file,
+                        output_file,
+                        num_of_threads,
+                        pin_threads,
+                        "../../../source/assets/tuner.ckpt",
+                        memory_budget);
+            if (optimizer == Tuner_Optimizer::LBFGS) { tuner.tune_lbfgs(); }
+            else { tuner.tune(resume); }
+        }
+        else if (std::string(argv[1]) == "convert")
+        {
+            std::ifstream text_dataset_file(
+                "../../../source/assets/lichess-big3-resolved.book");
+            std::ofstream binary_dataset_file(
+                "../../../source/assets/lichess-big3-resolved.bin",
+                std::ios::binary);
+            const uint64_t num_of_positions =
+                convert_text_dataset(text_dataset_file, binary_dataset_file);
+            std::cout << "Converted " << num_of_positions << " positions."
+                      << std::endl;
+        }
+        else if (std::string(argv[1]) == "datagen")
+        {
+            std::ofstream log_file("../../../source/assets/datagen.log");
+            std::ofstream binary_dataset_file(
+                "../../../source/assets/datagen.bin",
+                std::ios::binary | std::ios::app);
+
+            // Optional: datagen <number of threads> <number of games> <depth>
+            // <soft node limit> [pin]
+            Datagen_Options options;
+            if (argc > 2) { options.num_of_threads = std::stoull(argv[2]); }
+            if (argc > 3) { options.num_of_games = std::stoull(argv[3]); }
+            if (argc > 4) { options.depth = std::stoi(argv[4]); }
+            if (argc > 5) { options.nodes = std::stoull(argv[5]); }
+            options.pin_threads = (argc > 6) && (std::string(argv[6]) == "pin");
+
+            // Every run continues the same file so, every run needs different
+            // openings.
+            options.seed = static_cast<uint64_t>(
+                std::chrono::steady_clock::now().time_since_epoch().count());
+
+            Datagen datagen(log_file, binary_dataset_file, options);
+            const uint64_t num_of_positions = datagen.generate();
+            std::cout << "Generated " << num_of_positions << " positions."
+                      << std::endl;
+        }
+        else if (std::string(argv[1]) == "filter")
+        {
+            // Optional: filter <input dataset> <output dataset> <number of
+            // threads>
+            const std::string input_path =
+                (argc > 2) ? argv[2] : "../../../source/assets/datagen.bin";
+            const std::string output_path =
+                (argc > 3) ? argv[3]
+                           : "../../../source/assets/datagen-filtered.bin";
+
+            Dataset_Filter_Options options;
+            if (argc > 4) { options.num_of_threads = std::stoull(argv[4]); }
+
+            std::ifstream input_file(input_path, std::ios::binary);
+            std::ofstream output_file(output_path, std::ios::binary);
+
+            Dataset_Filter dataset_filter(std::cout, options);
+            dataset_filter.filter(input_file, output_file);
         }
         else if (std::string(argv[1]) == "bench")
         {
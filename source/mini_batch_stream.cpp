@@ -0,0 +1,254 @@
+#include "mini_batch_stream.hpp"
+
+#include <algorithm>
+#include <format>
+#include <numeric>
+#include <stdexcept>
+
+#include "psuedo_random_number_generator.hpp"
+
+Mini_Batch create_mini_batch(const std::span<const Packed_Position> positions)
+{
+    Mini_Batch mini_batch;
+
+    mini_batch.features.reserve(positions.size());
+    mini_batch.scores.reserve(positions.size());
+
+    Chess_Board cb;
+    for (const Packed_Position& packed : positions)
+    {
+        cb.set_from_packed_position(packed);
+
+        mini_batch.features.append(cb);
+        mini_batch.scores.push_back(packed_result_to_score(packed));
+    }
+
+    return mini_batch;
+}
+
+namespace
+{
+
+// The generator of a pass or of a window's shuffle. The xorshift state must
+// never be zero.
+Psuedo_RNG<uint64_t> create_shuffle_rng(const uint64_t seed,
+                                        const uint64_t stream)
+{
+    constexpr uint64_t STREAM_SEED_MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+
+    const uint64_t stream_seed = seed ^ (stream * STREAM_SEED_MULTIPLIER);
+    return Psuedo_RNG<uint64_t>((stream_seed != 0) ? stream_seed
+                                                   : GLOBAL_PRNG_DEFAULT_SEED);
+}
+
+template <typename T>
+void shuffle_in_place(std::vector<T>& values, Psuedo_RNG<uint64_t>& rng)
+{
+    // Fisher-Yates shuffle.
+    for (std::size_t i = values.size(); i > 1; --i)
+    {
+        std::swap(values[i - 1], values[rng.generate_random() % i]);
+    }
+}
+
+} // namespace
+
+Mini_Batch_Stream::Mini_Batch_Stream(
+    std::istream&     dataset,
+    std::mutex&       dataset_mutex,
+    const uint64_t    first_position,
+    const uint64_t    num_of_positions,
+    const std::size_t mini_batch_size,
+    const std::size_t memory_budget,
+    const std::size_t num_of_mini_batches_held) :
+    m_dataset(dataset),
+    m_dataset_mutex(dataset_mutex),
+    m_first_position(first_position),
+    m_num_of_positions(num_of_positions),
+    m_mini_batch_size(mini_batch_size),
+    m_shuffle(false),
+    m_seed(0),
+    m_next_window(0),
+    m_next_position_in_window(0)
+{
+    if ((m_num_of_positions == 0) || (m_mini_batch_size == 0))
+    {
+        throw std::invalid_argument(
+            "A mini-batch stream needs positions and a mini-batch size.");
+    }
+
+    // A mini-batch is never larger than the range.
+    const std::size_t num_of_positions_per_mini_batch =
+        std::min<uint64_t>(m_mini_batch_size, m_num_of_positions);
+
+    // The mini-batches held by the caller and the prefetched one.
+    const std::size_t features_size =
+        ((num_of_mini_batches_held + 1) * num_of_positions_per_mini_batch
+         * MINI_BATCH_BYTES_PER_POSITION);
+    const std::size_t mini_batch_window_size =
+        (num_of_positions_per_mini_batch * sizeof(Packed_Position));
+
+    if (memory_budget < (features_size + mini_batch_window_size))
+    {
+        throw std::invalid_argument(std::format(
+            "A memory budget of {} bytes is too small to stream mini-batches, "
+            "at least {} bytes are needed.",
+            memory_budget,
+            (features_size + mini_batch_window_size)));
+    }
+
+    // Windows are whole mini-batches such that, only the last mini-batch of the
+    // range is partial, the same as when the whole range is in memory.
+    const std::size_t num_of_mini_batches_per_window =
+        ((memory_budget - features_size) / mini_batch_window_size);
+    m_window_size = (num_of_mini_batches_per_window * m_mini_batch_size);
+
+    start_pass(false, 0);
+}
+
+Mini_Batch_Stream::~Mini_Batch_Stream() { wait_for_prefetch(); }
+
+std::size_t Mini_Batch_Stream::get_num_of_mini_batches() const
+{
+    return ((m_num_of_positions + m_mini_batch_size - 1) / m_mini_batch_size);
+}
+
+std::size_t Mini_Batch_Stream::get_num_of_windows() const
+{
+    return ((m_num_of_positions + m_window_size - 1) / m_window_size);
+}
+
+std::size_t
+Mini_Batch_Stream::get_num_of_positions_in_window(const std::size_t window) const
+{
+    return std::min<uint64_t>(m_window_size,
+                              (m_num_of_positions - (window * m_window_size)));
+}
+
+void Mini_Batch_Stream::start_pass(const bool        shuffle_pass,
+                                   const uint64_t    seed,
+                                   const std::size_t first_mini_batch)
+{
+    wait_for_prefetch();
+
+    m_shuffle = shuffle_pass;
+    m_seed    = seed;
+
+    m_window_order.resize(get_num_of_windows());
+    std::iota(m_window_order.begin(), m_window_order.end(), 0);
+    if (m_shuffle)
+    {
+        Psuedo_RNG<uint64_t> rng = create_shuffle_rng(m_seed, 0);
+        shuffle_in_place(m_window_order, rng);
+    }
+
+    // Skip the windows of the mini-batches before the first mini-batch without
+    // reading them.
+    std::size_t num_of_mini_batches_to_skip = first_mini_batch;
+    m_next_window                           = 0;
+    m_window.clear();
+    m_next_position_in_window = 0;
+
+    while ((num_of_mini_batches_to_skip > 0)
+           && (m_next_window < m_window_order.size()))
+    {
+        const std::size_t num_of_positions_in_window =
+            get_num_of_positions_in_window(m_window_order[m_next_window]);
+        const std::size_t num_of_mini_batches_in_window =
+            ((num_of_positions_in_window + m_mini_batch_size - 1)
+             / m_mini_batch_size);
+
+        if (num_of_mini_batches_to_skip < num_of_mini_batches_in_window)
+        {
+            load_window(m_next_window);
+            ++m_next_window;
+            m_next_position_in_window =
+                (num_of_mini_batches_to_skip * m_mini_batch_size);
+            break;
+        }
+
+        num_of_mini_batches_to_skip -= num_of_mini_batches_in_window;
+        ++m_next_window;
+    }
+
+    prefetch_next_mini_batch();
+}
+
+bool Mini_Batch_Stream::next(Mini_Batch& mini_batch)
+{
+    if (!m_prefetch.valid()) { return false; }
+
+    std::optional<Mini_Batch> prefetched = m_prefetch.get();
+    if (!prefetched.has_value()) { return false; }
+
+    mini_batch = std::move(*prefetched);
+
+    prefetch_next_mini_batch();
+
+    return true;
+}
+
+void Mini_Batch_Stream::load_window(const std::size_t window_index)
+{
+    const std::size_t window = m_window_order[window_index];
+
+    m_window.resize(get_num_of_positions_in_window(window));
+
+    {
+        const std::lock_guard<std::mutex> lock(m_dataset_mutex);
+
+        m_dataset.clear();
+        m_dataset.seekg(((m_first_position + (window * m_window_size))
+                         * sizeof(Packed_Position)),
+                        std::ios::beg);
+        m_dataset.read(reinterpret_cast<char*>(m_window.data()),
+                       m_window.size() * sizeof(Packed_Position));
+
+        if (!m_dataset)
+        {
+            throw std::runtime_error("Failed to read a window of the dataset.");
+        }
+    }
+
+    // Every window has it's own generator such that, a window's order does not
+    // depend on the windows read before it.
+    if (m_shuffle)
+    {
+        Psuedo_RNG<uint64_t> rng = create_shuffle_rng(m_seed, (window + 1));
+        shuffle_in_place(m_window, rng);
+    }
+}
+
+std::optional<Mini_Batch> Mini_Batch_Stream::load_next_mini_batch()
+{
+    if (m_next_position_in_window == m_window.size())
+    {
+        if (m_next_window == m_window_order.size()) { return std::nullopt; }
+
+        load_window(m_next_window);
+        ++m_next_window;
+        m_next_position_in_window = 0;
+    }
+
+    const std::size_t num_of_positions =
+        std::min(m_mini_batch_size,
+                 (m_window.size() - m_next_position_in_window));
+
+    const std::span<const Packed_Position> positions(
+        (m_window.data() + m_next_position_in_window),
+        num_of_positions);
+    m_next_position_in_window += num_of_positions;
+
+    return create_mini_batch(positions);
+}
+
+void Mini_Batch_Stream::prefetch_next_mini_batch()
+{
+    m_prefetch = std::async(std::launch::async,
+                            [this]() { return load_next_mini_batch(); });
+}
+
+void Mini_Batch_Stream::wait_for_prefetch()
+{
+    if (m_prefetch.valid()) { m_prefetch.wait(); }
+}
@@ -0,0 +1,171 @@
+#include "nnue.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+bool NNUE::load(const std::string& path)
+{
+    std::ifstream network_file(path, std::ios::binary | std::ios::ate);
+
+    if (!network_file.is_open()) { return false; }
+
+    constexpr std::streamsize expected_size =
+        sizeof(NNUE_File_Header)
+        + (((NNUE_INPUT_SIZE * NNUE_HIDDEN_SIZE) + NNUE_HIDDEN_SIZE
+            + (NUM_OF_PLAYERS * NNUE_HIDDEN_SIZE) + 1)
+           * sizeof(NNUE_Weight_Storage_Type));
+
+    if (network_file.tellg() != expected_size) { return false; }
+
+    network_file.seekg(0);
+
+    NNUE_File_Header header;
+    network_file.read(reinterpret_cast<char*>(&header.magic),
+                      sizeof(header.magic));
+    network_file.read(reinterpret_cast<char*>(&header.input_size),
+                      sizeof(header.input_size));
+    network_file.read(reinterpret_cast<char*>(&header.hidden_size),
+                      sizeof(header.hidden_size));
+
+    if ((!network_file) || (header.magic != NNUE_FILE_MAGIC)
+        || (header.input_size != NNUE_INPUT_SIZE)
+        || (header.hidden_size != NNUE_HIDDEN_SIZE))
+    {
+        return false;
+    }
+
+    auto network = std::make_unique<NNUE_Network>();
+
+    network_file.read(
+        reinterpret_cast<char*>(network->feature_weights.data.data()),
+        sizeof(network->feature_weights));
+    network_file.read(
+        reinterpret_cast<char*>(network->feature_biases.data.data()),
+        sizeof(network->feature_biases));
+    network_file.read(
+        reinterpret_cast<char*>(network->output_weights.data.data()),
+        sizeof(network->output_weights));
+    network_file.read(reinterpret_cast<char*>(&network->output_bias),
+                      sizeof(network->output_bias));
+
+    if (!network_file) { return false; }
+
+    s_network = std::move(network);
+
+    return true;
+}
+
+void NNUE::unload() { s_network.reset(); }
+
+void NNUE_Accumulator::refresh(
+    const Multi_Array<Bitboard, NUM_OF_PLAYERS, NUM_OF_UNIQUE_PIECES_PER_PLAYER>&
+        pieces)
+{
+    const NNUE_Network& network = NNUE::get_network();
+
+    m_values[PIECE_COLOR::WHITE] = network.feature_biases;
+    m_values[PIECE_COLOR::BLACK] = network.feature_biases;
+
+    for (uint8_t color = PIECE_COLOR::WHITE; color <= PIECE_COLOR::BLACK;
+         ++color)
+    {
+        for (uint8_t piece = PIECES::PAWN; piece <= PIECES::KING; ++piece)
+        {
+            for (const Square square : pieces[color][piece])
+            {
+                update_piece<true>((PIECE_COLOR) color, (PIECES) piece, square);
+            }
+        }
+    }
+}
+
+// Forward pass of the output layer - the clipped ReLU activations of both
+// perspectives dotted with the output weights. Returns the evaluation in
+// centipawns from the side to move's point of view.
+int32_t NNUE_Accumulator::forward(const PIECE_COLOR side_to_move) const
+{
+    const NNUE_Network& network = NNUE::get_network();
+
+    // Output weights for the side to move's accumulator come first.
+    const Multi_Array<const NNUE_Accumulator_Storage_Type*, NUM_OF_PLAYERS>
+        perspectives = {m_values[side_to_move].data.data(),
+                        m_values[(~side_to_move) & 0x1].data.data()};
+
+    int32_t output = 0;
+
+#if defined(__AVX512BW__)
+    const __m512i zero    = _mm512_setzero_si512();
+    const __m512i qa      = _mm512_set1_epi16(NNUE_QA);
+    __m512i       sum_vec = _mm512_setzero_si512();
+
+    for (std::size_t p = 0; p < NUM_OF_PLAYERS; ++p)
+    {
+        const NNUE_Weight_Storage_Type* weights =
+            network.output_weights[p].data.data();
+
+        for (std::size_t i = 0; i < NNUE_HIDDEN_SIZE; i += 32)
+        {
+            const __m512i v = _mm512_max_epi16(
+                _mm512_min_epi16(_mm512_load_si512(perspectives[p] + i), qa),
+                zero);
+            const __m512i w = _mm512_load_si512(weights + i);
+
+            // The activation is at most QA and each weight is a 16-bit integer
+            // so, the 32-bit pairwise sums from madd cannot overflow.
+            sum_vec = _mm512_add_epi32(sum_vec, _mm512_madd_epi16(v, w));
+        }
+    }
+
+    output = _mm512_reduce_add_epi32(sum_vec);
+#elif defined(__AVX2__)
+    const __m256i zero    = _mm256_setzero_si256();
+    const __m256i qa      = _mm256_set1_epi16(NNUE_QA);
+    __m256i       sum_vec = _mm256_setzero_si256();
+
+    for (std::size_t p = 0; p < NUM_OF_PLAYERS; ++p)
+    {
+        const NNUE_Weight_Storage_Type* weights =
+            network.output_weights[p].data.data();
+
+        for (std::size_t i = 0; i < NNUE_HIDDEN_SIZE; i += 16)
+        {
+            const __m256i v = _mm256_max_epi16(
+                _mm256_min_epi16(
+                    _mm256_load_si256(
+                        reinterpret_cast<const __m256i*>(perspectives[p] + i)),
+                    qa),
+                zero);
+            const __m256i w = _mm256_load_si256(
+                reinterpret_cast<const __m256i*>(weights + i));
+
+            sum_vec = _mm256_add_epi32(sum_vec, _mm256_madd_epi16(v, w));
+        }
+    }
+
+    const __m128i sum_128 = _mm_add_epi32(_mm256_castsi256_si128(sum_vec),
+                                          _mm256_extracti128_si256(sum_vec, 1));
+    const __m128i sum_64 =
+        _mm_add_epi32(sum_128, _mm_unpackhi_epi64(sum_128, sum_128));
+    const __m128i sum_32 = _mm_add_epi32(
+        sum_64,
+        _mm_shuffle_epi32(sum_64, _MM_SHUFFLE(2, 3, 0, 1)));
+    output = _mm_cvtsi128_si32(sum_32);
+#else
+    for (std::size_t p = 0; p < NUM_OF_PLAYERS; ++p)
+    {
+        for (std::size_t i = 0; i < NNUE_HIDDEN_SIZE; ++i)
+        {
+            const int32_t activation =
+                std::clamp(static_cast<int32_t>(perspectives[p][i]),
+                           0,
+                           NNUE_QA);
+            output += activation * network.output_weights[p][i];
+        }
+    }
+#endif
+
+    output += network.output_bias;
+
+    return static_cast<int32_t>((static_cast<int64_t>(output) * NNUE_EVAL_SCALE)
+                                / (NNUE_QA * NNUE_QB));
+}
@@ -1,156 +1,446 @@
+#include <algorithm>
+#include <bit>
 #include <cmath>
 #include "globals.hpp"
 
 #include "reverse_auto_differentiation.hpp"
 
-AD_Adjoint::AD_Adjoint() {}
-
-AD_Adjoint::AD_Adjoint(const double value) : m_value(value) {}
+AD_Tape::AD_Tape() {}
 
-AD_Adjoint::AD_Adjoint(Optional_Reference<AD_Node> parent_node) :
-    m_left_node(parent_node)
+AD_Node_Index AD_Tape::push(const AD_OPCODE     opcode,
+                            const double        value,
+                            const AD_Node_Index left,
+                            const AD_Node_Index right)
 {
+    m_nodes.push_back({.value   = value,
+                       .adjoint = 0.0,
+                       .left    = left,
+                       .right   = right,
+                       .opcode  = opcode});
+    return static_cast<AD_Node_Index>(m_nodes.size() - 1);
 }
 
-AD_Adjoint::AD_Adjoint(Optional_Reference<AD_Node> left_node,
-                       Optional_Reference<AD_Node> right_node) :
-    m_left_node(left_node), m_right_node(right_node)
+void AD_Tape::backward(const AD_Node_Index output)
 {
+    // The partial derivative of the output scalar with respect to itself is 1.
+    m_nodes[output].adjoint = 1.0;
+
+    // Each tape node backpropagates it's adjoint to it's parent(s) in reverse
+    // topological order - which is simply the reverse order of the tape.
+    for (std::size_t i = (static_cast<std::size_t>(output) + 1); i-- > 0;)
+    {
+        const AD_Node& node    = m_nodes[i];
+        const double   adjoint = node.adjoint;
+
+        // Nothing to propagate, this node does not contribute to the output.
+        if (adjoint == 0.0) { continue; }
+
+        switch (node.opcode)
+        {
+            case AD_OPCODE::CONSTANT:
+            case AD_OPCODE::VARIABLE:
+            case AD_OPCODE::INPUT: break;
+
+            case AD_OPCODE::ADDITION:
+                m_nodes[node.left].adjoint  += adjoint;
+                m_nodes[node.right].adjoint += adjoint;
+                break;
+
+            case AD_OPCODE::SUBTRACTION:
+                m_nodes[node.left].adjoint  += adjoint;
+                m_nodes[node.right].adjoint -= adjoint;
+                break;
+
+            case AD_OPCODE::MULTIPLICATION:
+            {
+                AD_Node& left   = m_nodes[node.left];
+                AD_Node& right  = m_nodes[node.right];
+                left.adjoint   += (adjoint * right.value);
+                right.adjoint  += (adjoint * left.value);
+                break;
+            }
+
+            case AD_OPCODE::DIVISION:
+            {
+                AD_Node& left   = m_nodes[node.left];
+                AD_Node& right  = m_nodes[node.right];
+                left.adjoint   += (adjoint / right.value);
+                right.adjoint  -= (adjoint * left.value)
+                               / (right.value * right.value);
+                break;
+            }
+
+            case AD_OPCODE::NEGATION:
+                m_nodes[node.left].adjoint -= adjoint;
+                break;
+
+            case AD_OPCODE::TANH:
+                m_nodes[node.left].adjoint +=
+                    (adjoint * (1.0 - (node.value * node.value)));
+                break;
+
+            case AD_OPCODE::EXP:
+                m_nodes[node.left].adjoint += (adjoint * node.value);
+                break;
+
+            case AD_OPCODE::SQRT:
+                m_nodes[node.left].adjoint += (adjoint / (2 * node.value));
+                break;
+
+            case AD_OPCODE::POW:
+            {
+                AD_Node& base      = m_nodes[node.left];
+                AD_Node& exponent  = m_nodes[node.right];
+                base.adjoint      += (adjoint * exponent.value * node.value
+                                 / base.value);
+                exponent.adjoint  +=
+                    (adjoint * node.value * std::log(base.value));
+                break;
+            }
+
+            case AD_OPCODE::SPARSE_SUM:
+                for (uint64_t bits = m_sparse_inputs[node.right]; bits != 0;
+                     bits &= (bits - 1))
+                {
+                    m_nodes[node.left + std::countr_zero(bits)].adjoint +=
+                        adjoint;
+                }
+                break;
+
+            case AD_OPCODE::CLAMPED_LOGISTIC:
+            {
+                AD_Node&     x     = m_nodes[node.left];
+                const double clamp = m_nodes[node.right].value;
+
+                // The saturated regions are constant.
+                if (std::abs(x.value) < clamp)
+                {
+                    x.adjoint -= (adjoint * node.value * (1.0 - node.value));
+                }
+                break;
+            }
+        }
+    }
 }
 
-void AD_Adjoint::set_value(const double value) { m_value = value; }
-
-AD_Adjoint AD_Adjoint::operator+=(const AD_Adjoint& other)
+void AD_Tape::rewind(const std::size_t size)
 {
-    this->m_value += other.m_value;
-    return (*this);
-}
+    m_nodes.resize(size);
 
-AD_Adjoint AD_Adjoint::operator-=(const AD_Adjoint& other)
-{
-    this->m_value -= other.m_value;
-    return (*this);
+    for (AD_Node& node : m_nodes) { node.adjoint = 0.0; }
 }
 
-void AD_Adjoint_No_Op::operator()(
-    MAYBE_UNUSED const std::initializer_list<double> args)
-{
-}
+void AD_Tape::reserve(const std::size_t capacity) { m_nodes.reserve(capacity); }
 
-void AD_Adjoint_Addition::operator()(
-    MAYBE_UNUSED const std::initializer_list<double> args)
-{
-    left_node().adjoint()  += value();
-    right_node().adjoint() += value();
-}
+void AD_Tape::clear() { m_nodes.clear(); }
 
-void AD_Adjoint_Subtraction::operator()(
-    MAYBE_UNUSED const std::initializer_list<double> args)
+void AD_Tape::set_sparse_input(const uint32_t slot, const uint64_t bitboard)
 {
-    left_node().adjoint()  += value();
-    right_node().adjoint() -= value();
-}
+    if (slot >= m_sparse_inputs.size()) { m_sparse_inputs.resize(slot + 1); }
 
-void AD_Adjoint_Multiplication::operator()(
-    MAYBE_UNUSED const std::initializer_list<double> args)
-{
-    left_node().adjoint()  += (value() * right_node().value());
-    right_node().adjoint() += (value() * left_node().value());
+    m_sparse_inputs[slot] = bitboard;
 }
 
-void AD_Adjoint_Division::operator()(
-    MAYBE_UNUSED const std::initializer_list<double> args)
-{
-    left_node().adjoint()  += (value() / right_node().value());
-    right_node().adjoint() -= (value() * left_node().value())
-                            / (right_node().value() * right_node().value());
-}
-
-void AD_Adjoint_Negation::operator()(
-    MAYBE_UNUSED const std::initializer_list<double> args)
-{
-    left_node().adjoint() -= value();
-}
+AD_Compiled_Graph::AD_Compiled_Graph() {}
 
-void AD_Adjoint_Tanh::operator()(
-    MAYBE_UNUSED const std::initializer_list<double> args)
+AD_Compiled_Graph::AD_Compiled_Graph(const AD_Tape&      tape,
+                                     const std::size_t   num_of_variables,
+                                     const AD_Node_Index output) :
+    m_program(tape.begin(), (tape.begin() + output + 1)),
+    m_num_of_variables(num_of_variables),
+    m_output(output)
 {
-    MATREX_ASSERT((args.size() == 1),
-                  "Automatic Differentation Adjoint tanh requires 1 argument; "
-                  "(1) This node's value");
-
-    const double& this_node_value = (args.begin())[0];
-
-    left_node().adjoint() +=
-        (value() * (1.0 - (this_node_value * this_node_value)));
+    MATREX_ASSERT((num_of_variables <= m_program.size()),
+                  "The compiled graph has fewer nodes than variables.");
+
+    for (std::size_t i = 0; i < m_program.size(); ++i)
+    {
+        const AD_Node& node = m_program[i];
+
+        MATREX_ASSERT(((node.opcode == AD_OPCODE::VARIABLE)
+                       == (i < num_of_variables)),
+                      "The variables must be the first nodes of the tape.");
+
+        if (node.opcode == AD_OPCODE::INPUT)
+        {
+            m_num_of_inputs =
+                std::max(m_num_of_inputs, static_cast<std::size_t>(node.left + 1));
+        }
+        else if (node.opcode == AD_OPCODE::SPARSE_SUM)
+        {
+            m_num_of_sparse_inputs =
+                std::max(m_num_of_sparse_inputs,
+                         static_cast<std::size_t>(node.right + 1));
+        }
+    }
 }
 
-void AD_Adjoint_Exp::operator()(
-    MAYBE_UNUSED const std::initializer_list<double> args)
+AD_Replay_Buffers AD_Compiled_Graph::create_buffers() const
 {
-    MATREX_ASSERT((args.size() == 1),
-                  "Automatic Differentation Adjoint exp requires 1 argument; "
-                  "(1) This node's value");
+    constexpr std::size_t L = AD_COMPILED_GRAPH_LANES;
 
-    const double& this_node_value = (args.begin())[0];
+    AD_Replay_Buffers buffers;
 
-    left_node().adjoint() += (value() * this_node_value);
-}
+    buffers.values.resize(m_program.size() * L);
+    buffers.adjoints.resize(m_program.size() * L);
+    buffers.inputs.resize(m_num_of_inputs * L);
+    buffers.sparse_inputs.resize(m_num_of_sparse_inputs * L);
 
-void AD_Adjoint_Sqrt::operator()(
-    MAYBE_UNUSED const std::initializer_list<double> args)
-{
-    MATREX_ASSERT((args.size() == 1),
-                  "Automatic Differentation Adjoint sqrt requires 1 argument; "
-                  "(1) This node's value");
+    // Constants never change between replays.
+    for (std::size_t i = 0; i < m_program.size(); ++i)
+    {
+        if (m_program[i].opcode != AD_OPCODE::CONSTANT) { continue; }
 
-    const double& this_node_value = (args.begin())[0];
+        std::fill_n(&buffers.values[i * L], L, m_program[i].value);
+    }
 
-    left_node().adjoint() += (value() / (2 * this_node_value));
+    return buffers;
 }
 
-void AD_Adjoint_Pow::operator()(
-    MAYBE_UNUSED const std::initializer_list<double> args)
+void AD_Compiled_Graph::load_variables(const std::span<const double> variables,
+                                       AD_Replay_Buffers& buffers) const
 {
-    MATREX_ASSERT(
-        (args.size() == 1),
-        "Automatic Differentation Adjoint pow requires 1 argument; (1) This "
-        "node's value");
+    constexpr std::size_t L = AD_COMPILED_GRAPH_LANES;
 
-    const double& this_node_value = (args.begin())[0];
+    MATREX_ASSERT((variables.size() == m_num_of_variables),
+                  "Wrong number of variables loaded into the compiled graph.");
 
-    left_node().adjoint() += (value() * right_node().value() * this_node_value
-                              / left_node().value());
-    right_node().adjoint() +=
-        (value() * this_node_value * std::log(left_node().value()));
+    for (std::size_t i = 0; i < m_num_of_variables; ++i)
+    {
+        std::fill_n(&buffers.values[i * L], L, variables[i]);
+    }
 }
 
-AD_Node::AD_Node() : m_adjoint(nullptr) {}
-
-AD_Node::AD_Node(const double value) : m_value(value), m_adjoint(nullptr) {}
-
-AD_Node::AD_Node(const double value, AD_Adjoint_Pointer adjoint) :
-    m_value(value), m_adjoint(std::move(adjoint))
+void AD_Compiled_Graph::forward(AD_Replay_Buffers& buffers) const
 {
+    constexpr std::size_t L = AD_COMPILED_GRAPH_LANES;
+
+    double* const values = buffers.values.data();
+
+    for (std::size_t i = m_num_of_variables; i <= m_output; ++i)
+    {
+        const AD_Node& node = m_program[i];
+        double*        out  = &values[i * L];
+        const double*  a    = operand(values, node.left);
+        const double*  b    = operand(values, node.right);
+
+        switch (node.opcode)
+        {
+            case AD_OPCODE::CONSTANT:
+            case AD_OPCODE::VARIABLE: break;
+
+            case AD_OPCODE::INPUT:
+                std::copy_n(&buffers.inputs[node.left * L], L, out);
+                break;
+
+            case AD_OPCODE::ADDITION:
+                for (std::size_t j = 0; j < L; ++j) { out[j] = a[j] + b[j]; }
+                break;
+
+            case AD_OPCODE::SUBTRACTION:
+                for (std::size_t j = 0; j < L; ++j) { out[j] = a[j] - b[j]; }
+                break;
+
+            case AD_OPCODE::MULTIPLICATION:
+                for (std::size_t j = 0; j < L; ++j) { out[j] = a[j] * b[j]; }
+                break;
+
+            case AD_OPCODE::DIVISION:
+                for (std::size_t j = 0; j < L; ++j) { out[j] = a[j] / b[j]; }
+                break;
+
+            case AD_OPCODE::NEGATION:
+                for (std::size_t j = 0; j < L; ++j) { out[j] = -a[j]; }
+                break;
+
+            case AD_OPCODE::TANH:
+                for (std::size_t j = 0; j < L; ++j) { out[j] = std::tanh(a[j]); }
+                break;
+
+            case AD_OPCODE::EXP:
+                for (std::size_t j = 0; j < L; ++j) { out[j] = std::exp(a[j]); }
+                break;
+
+            case AD_OPCODE::SQRT:
+                for (std::size_t j = 0; j < L; ++j) { out[j] = std::sqrt(a[j]); }
+                break;
+
+            case AD_OPCODE::POW:
+                for (std::size_t j = 0; j < L; ++j)
+                {
+                    out[j] = std::pow(a[j], b[j]);
+                }
+                break;
+
+            case AD_OPCODE::SPARSE_SUM:
+            {
+                // The summed nodes are variables so, every lane of them holds
+                // the same value.
+                const uint64_t* bitboards =
+                    &buffers.sparse_inputs[node.right * L];
+
+                for (std::size_t j = 0; j < L; ++j)
+                {
+                    double sum = 0.0;
+                    for (uint64_t bits = bitboards[j]; bits != 0;
+                         bits &= (bits - 1))
+                    {
+                        sum += values[(node.left + std::countr_zero(bits)) * L];
+                    }
+                    out[j] = sum;
+                }
+                break;
+            }
+
+            case AD_OPCODE::CLAMPED_LOGISTIC:
+                for (std::size_t j = 0; j < L; ++j)
+                {
+                    const double logistic = 1.0 / (std::exp(a[j]) + 1.0);
+                    out[j] = (a[j] >= b[j])    ? 0.0
+                           : (a[j] <= -b[j]) ? 1.0
+                                             : logistic;
+                }
+                break;
+        }
+    }
 }
 
-AD_Node::AD_Node(double             value,
-                 AD_Adjoint_Pointer adjoint,
-                 const std::size_t  weight_index) :
-    m_value(value), m_adjoint(std::move(adjoint)), m_weight_index(weight_index)
+void AD_Compiled_Graph::backward(
+    AD_Replay_Buffers&            buffers,
+    const std::span<const double> output_adjoints,
+    const std::span<double>       variable_adjoints) const
 {
+    constexpr std::size_t L = AD_COMPILED_GRAPH_LANES;
+
+    MATREX_ASSERT((output_adjoints.size() == L),
+                  "Every lane of the compiled graph needs an output adjoint.");
+    MATREX_ASSERT((variable_adjoints.size() == m_num_of_variables),
+                  "Wrong number of variable adjoints for the compiled graph.");
+
+    const double* const values   = buffers.values.data();
+    double* const       adjoints = buffers.adjoints.data();
+
+    std::fill(buffers.adjoints.begin(), buffers.adjoints.end(), 0.0);
+    std::copy(output_adjoints.begin(),
+              output_adjoints.end(),
+              &adjoints[m_output * L]);
+
+    for (std::size_t i = (static_cast<std::size_t>(m_output) + 1);
+         i-- > m_num_of_variables;)
+    {
+        const AD_Node& node  = m_program[i];
+        const double*  out   = &values[i * L];
+        const double*  g     = &adjoints[i * L];
+        const double*  a     = operand(values, node.left);
+        const double*  b     = operand(values, node.right);
+        double*        a_bar = operand(adjoints, node.left);
+        double*        b_bar = operand(adjoints, node.right);
+
+        switch (node.opcode)
+        {
+            case AD_OPCODE::CONSTANT:
+            case AD_OPCODE::VARIABLE:
+            case AD_OPCODE::INPUT: break;
+
+            case AD_OPCODE::ADDITION:
+                for (std::size_t j = 0; j < L; ++j)
+                {
+                    a_bar[j] += g[j];
+                    b_bar[j] += g[j];
+                }
+                break;
+
+            case AD_OPCODE::SUBTRACTION:
+                for (std::size_t j = 0; j < L; ++j)
+                {
+                    a_bar[j] += g[j];
+                    b_bar[j] -= g[j];
+                }
+                break;
+
+            case AD_OPCODE::MULTIPLICATION:
+                for (std::size_t j = 0; j < L; ++j)
+                {
+                    a_bar[j] += (g[j] * b[j]);
+                    b_bar[j] += (g[j] * a[j]);
+                }
+                break;
+
+            case AD_OPCODE::DIVISION:
+                for (std::size_t j = 0; j < L; ++j)
+                {
+                    a_bar[j] += (g[j] / b[j]);
+                    b_bar[j] -= (g[j] * a[j]) / (b[j] * b[j]);
+                }
+                break;
+
+            case AD_OPCODE::NEGATION:
+                for (std::size_t j = 0; j < L; ++j) { a_bar[j] -= g[j]; }
+                break;
+
+            case AD_OPCODE::TANH:
+                for (std::size_t j = 0; j < L; ++j)
+                {
+                    a_bar[j] += (g[j] * (1.0 - (out[j] * out[j])));
+                }
+                break;
+
+            case AD_OPCODE::EXP:
+                for (std::size_t j = 0; j < L; ++j)
+                {
+                    a_bar[j] += (g[j] * out[j]);
+                }
+                break;
+
+            case AD_OPCODE::SQRT:
+                for (std::size_t j = 0; j < L; ++j)
+                {
+                    a_bar[j] += (g[j] / (2 * out[j]));
+                }
+                break;
+
+            case AD_OPCODE::POW:
+                for (std::size_t j = 0; j < L; ++j)
+                {
+                    a_bar[j] += (g[j] * b[j] * out[j] / a[j]);
+                    b_bar[j] += (g[j] * out[j] * std::log(a[j]));
+                }
+                break;
+
+            case AD_OPCODE::SPARSE_SUM:
+            {
+                const uint64_t* bitboards =
+                    &buffers.sparse_inputs[node.right * L];
+
+                for (std::size_t j = 0; j < L; ++j)
+                {
+                    for (uint64_t bits = bitboards[j]; bits != 0;
+                         bits &= (bits - 1))
+                    {
+                        adjoints[((node.left + std::countr_zero(bits)) * L)
+                                 + j] += g[j];
+                    }
+                }
+                break;
+            }
+
+            case AD_OPCODE::CLAMPED_LOGISTIC:
+                // The saturated regions are constant.
+                for (std::size_t j = 0; j < L; ++j)
+                {
+                    a_bar[j] -= (std::abs(a[j]) < b[j])
+                                  ? (g[j] * out[j] * (1.0 - out[j]))
+                                  : 0.0;
+                }
+                break;
+        }
+    }
+
+    for (std::size_t i = 0; i < m_num_of_variables; ++i)
+    {
+        double sum = 0.0;
+        for (std::size_t j = 0; j < L; ++j) { sum += adjoints[(i * L) + j]; }
+
+        variable_adjoints[i] += sum;
+    }
 }
-
-double& AD_Node::value() { return m_value; }
-
-const double& AD_Node::value() const { return m_value; }
-
-AD_Tape::AD_Tape() {}
-
-std::reference_wrapper<AD_Node> AD_Tape::push(AD_Node&& node)
-{
-    m_tape.push_back(std::move(node));
-    return std::ref(m_tape.back());
-}
-
-void AD_Tape::clear() { m_tape.clear(); }
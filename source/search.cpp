@@ -1,12 +1,94 @@
 #include "search.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 #include "chess_move.hpp"
 #include "evaluate.hpp"
 #include "evaluation_terms.hpp"
 #include "static_exchange_evaluation.hpp"
 
+Late_Move_Reduction_Table create_late_move_reduction_table()
+{
+    Late_Move_Reduction_Table table;
+
+    for (std::size_t depth = 0; depth < table.size; ++depth)
+    {
+        for (std::size_t move_number = 0;
+             move_number < MAXIMUM_NUM_OF_MOVES_IN_A_POSITION;
+             ++move_number)
+        {
+            // The logarithm of 0 is undefined, neither is ever reduced anyway.
+            if ((depth == 0) || (move_number == 0))
+            {
+                table[depth][move_number] = 0;
+                continue;
+            }
+
+            table[depth][move_number] = static_cast<uint8_t>(
+                LATE_MOVE_REDUCTION_BASE
+                + ((std::log(static_cast<double>(depth))
+                    * std::log(static_cast<double>(move_number)))
+                   / LATE_MOVE_REDUCTION_DIVISOR));
+        }
+    }
+
+    return table;
+}
+
+Score get_aspiration_window_bound(const Score                        score,
+                                  const Fixed_Point_Int_Storage_Type delta)
+{
+    const Fixed_Point_Int_Storage_Type bound = (score.to_int() + delta);
+
+    if (bound < FP_EVALUATION_MIN) { return Score(FP_NEGATIVE_INFINITY); }
+    if (bound > FP_EVALUATION_MAX) { return Score(FP_POSITIVE_INFINITY); }
+
+    return Score(bound);
+}
+
+const Late_Move_Reduction_Table Search_Engine::LATE_MOVE_REDUCTIONS =
+    create_late_move_reduction_table();
+
+Search_Parameters::Search_Parameters()
+{
+    for (std::size_t i = 0; i < NUM_OF_SEARCH_PARAMETERS; ++i)
+    {
+        m_values[i] = SEARCH_PARAMETER_DEFINITIONS[i].default_value;
+    }
+}
+
+bool Search_Parameters::contains(const std::string_view name)
+{
+    return std::any_of(SEARCH_PARAMETER_DEFINITIONS.begin(),
+                       SEARCH_PARAMETER_DEFINITIONS.end(),
+                       [&](const Search_Parameter_Definition& definition)
+                       { return (definition.name == name); });
+}
+
+bool Search_Parameters::set(const std::string_view name, const int32_t value)
+{
+    for (std::size_t i = 0; i < NUM_OF_SEARCH_PARAMETERS; ++i)
+    {
+        const Search_Parameter_Definition& definition =
+            SEARCH_PARAMETER_DEFINITIONS[i];
+
+        if (definition.name == name)
+        {
+            m_values[i] = std::clamp(value, definition.min, definition.max);
+            return true;
+        }
+    }
+
+    return false;
+}
+
 Search_Engine::Search_Engine() :
-    m_timer_expired_during_search(false), m_num_of_nodes_searched(0)
+    m_timer_expired_during_search(false),
+    m_num_of_nodes_searched(0),
+    m_num_of_beta_cutoffs(0),
+    m_num_of_first_move_beta_cutoffs(0),
+    m_is_verifying_null_move(false)
 {
 }
 
@@ -15,6 +97,10 @@ void Search_Engine::new_game()
 #if COLLECT_TT_STATISTICS == 1
     m_transposition_table.get_statistics().print();
     m_transposition_table.clear_statistics();
+#endif
+#if COLLECT_EVAL_STATISTICS == 1
+    m_evaluation_statistics.print();
+    m_evaluation_statistics = Evaluation_Statistics();
 #endif
     m_transposition_table.clear();
     m_correction_history.clear();
@@ -22,22 +108,73 @@ void Search_Engine::new_game()
     m_q_cont_hist_stack.stack.clear();
     m_c_cont_hist_table.clear();
     m_c_cont_hist_stack.stack.clear();
+    m_null_move_q_hist_table.clear();
+    m_null_move_c_hist_table.clear();
+    m_main_history.clear();
+    m_counter_move_table.clear();
 }
 
 Search_Engine_Result
 Search_Engine::search(const Chess_Board&        cb,
                       const Search_Constraints& constraints)
 {
-    m_chess_board                 = cb;
-    m_constraints                 = constraints;
-    m_my_side                     = cb.get_side_to_move();
-    m_num_of_nodes_searched       = 0;
-    m_timer_expired_during_search = false;
+    prepare_search(cb, constraints);
+
+    return iterative_deepening();
+}
+
+std::pair<Score, Score> Search_Engine::static_and_quiescence_scores(
+    const Chess_Board&        cb,
+    const Search_Constraints& constraints)
+{
+    prepare_search(cb, constraints);
+
+    // The quiescence search is not part of an iterative deepening iteration so,
+    // it's transposition table entries are aged as a depth 0 search.
+    m_current_search_depth = QUIESCENCE_SEARCH_DEPTH;
+
+    Move_Generator        mg(m_chess_board);
+    Move_Generation_List  moves;
+    Moves_Bitboard_Matrix moving_side_matrix;
+    mg.generate_all_moves<MOVE_GENERATION_TYPE::ALL>(moves,
+                                                     moving_side_matrix);
+
+    const Score static_evaluation =
+        evaluate_position(m_chess_board, moving_side_matrix);
+    const Score quiescence_score = quiescence(m_chess_board,
+                                              0,
+                                              Score(FP_NEGATIVE_INFINITY),
+                                              Score(FP_POSITIVE_INFINITY))
+                                       .second;
+
+    return {static_evaluation, quiescence_score};
+}
+
+void Search_Engine::prepare_search(const Chess_Board&        cb,
+                                   const Search_Constraints& constraints)
+{
+    m_chess_board                    = cb;
+    m_constraints                    = constraints;
+    m_my_side                        = cb.get_side_to_move();
+    m_num_of_nodes_searched          = 0;
+    m_num_of_beta_cutoffs            = 0;
+    m_num_of_first_move_beta_cutoffs = 0;
+    m_timer_expired_during_search    = false;
+    m_is_verifying_null_move         = false;
+
+    // Killer moves are only meaningful for the position they were found in.
+    for (Search_Stack_Entry& entry : m_search_stack)
+    {
+        entry.move = Chess_Move();
+        entry.killer_moves.clear();
+    }
 
     m_transposition_table.resize(constraints.transposition_table_size);
     m_principal_variation.clear();
 
-    return iterative_deepening();
+    // The network may have been loaded after the position was set so, the
+    // accumulator is rebuilt before every search.
+    if (NNUE::is_loaded()) { m_chess_board.refresh_nnue_accumulator(); }
 }
 
 Search_Engine_Result
@@ -50,8 +187,6 @@ Search_Engine::negamax(Chess_Board&                    position,
                        Score                           alpha,
                        Score                           beta)
 {
-    const uint32_t depth_squared = (depth * depth);
-
     // The parent's PV must be cleared between negamax calls because sibling
     // moves could influence each other.
     principal_variation.clear();
@@ -128,15 +263,29 @@ Search_Engine::negamax(Chess_Board&                    position,
                 transposition_table_entry.score};
     }
 
+    // The search stack and the continuation history stacks only hold the plies
+    // up to the soft limit so, a node at the limit is resolved by quiescence
+    // search as if it's depth ran out.
+    if (ply >= MAX_SEARCH_DEPTH_SOFT_LIMIT)
+    {
+        return quiescence(position, ply, alpha, beta);
+    }
+
     // Assume that the score bound for a position's score to be stored in the
     // transposition table is an upper bound (or <= alpha) until we find out
     // otherwise.
     Score_Bound_Type score_bound = Score_Bound_Type::UPPER_BOUND;
 
+    // The killer moves of the children are only shared between siblings.
+    m_search_stack[ply + 1].killer_moves.clear();
+
     Move_Ordering mo(position,
                      transposition_table_entry.best_move,
                      q_cont_hist_stack,
-                     c_cont_hist_stack);
+                     c_cont_hist_stack,
+                     m_main_history,
+                     m_search_stack[ply].killer_moves,
+                     get_counter_move(position, ply));
     mo.generate_moves<MOVE_GENERATION_TYPE::ALL>();
     Move_Generation_List&  moves              = mo.get_sorted_moves();
     Moves_Bitboard_Matrix& moving_side_matrix = mo.get_moves_matrix();
@@ -172,6 +321,22 @@ Search_Engine::negamax(Chess_Board&                    position,
         return quiescence(position, ply, alpha, beta);
     }
 
+    // Internal iterative reduction - without a transposition table move the
+    // node is searched one ply shallower. A PV node is detected by it's window
+    // so, it stays a PV node and it's first move is still searched with the
+    // full window. The transposition table stores the reduced depth since, it
+    // is the depth that was searched.
+    if (should_do_internal_iterative_reduction(did_transposition_table_hit,
+                                               transposition_table_entry,
+                                               is_side_to_move_in_check,
+                                               depth,
+                                               ply))
+    {
+        --depth;
+    }
+
+    const uint32_t depth_squared = (depth * depth);
+
     ++m_num_of_nodes_searched;
 
     // Check if time has expired during the search.
@@ -190,35 +355,139 @@ Search_Engine::negamax(Chess_Board&                    position,
         return {moves[0], Score(FP_POSITIVE_INFINITY)};
     }
 
-    // Generate moves matrix for the opposing side for evaluation purposes.
-    const PIECE_COLOR opposing_side =
-        (PIECE_COLOR) ((~position.get_side_to_move()) & 0x1);
-    Move_Generation_List  not_used_moves_list;
-    Moves_Bitboard_Matrix opposing_side_matrix;
-    Move_Generator        mg(position);
-    mg.generate_all_moves<MOVE_GENERATION_TYPE::ALL>(opposing_side,
-                                                     not_used_moves_list,
-                                                     opposing_side_matrix);
+    const Score static_evaluation =
+        evaluate_position(position, moving_side_matrix);
+
+    const Search_Parameters& parameters = m_constraints.parameters;
+
+    // Reverse futility pruning - the static evaluation is so far above beta
+    // that, even a margin growing with depth cannot bring it below beta.
+    const Matrex_FP_Int fp_reverse_futility_pruning_margin =
+        Matrex_FP_Int::from_integer(
+            (parameters[REVERSE_FUTILITY_PRUNING_QUADRATIC_MARGIN]
+             * static_cast<int32_t>(depth_squared))
+            + (parameters[REVERSE_FUTILITY_PRUNING_LINEAR_MARGIN] * depth)
+            + parameters[REVERSE_FUTILITY_PRUNING_CONSTANT_MARGIN]);
+    const Score reverse_futility_pruning_margin =
+        Score(fp_reverse_futility_pruning_margin);
+    const Score reverse_futility_threshold =
+        static_evaluation - reverse_futility_pruning_margin;
+    if (should_do_reverse_futility_pruning(is_pv_node,
+                                           is_side_to_move_in_check,
+                                           depth,
+                                           reverse_futility_threshold,
+                                           beta))
+    {
+        return {Chess_Move(), reverse_futility_threshold};
+    }
 
-    const Evaluator e(TUNED_EVALUATION_WEIGHTS,
-                      position,
-                      moving_side_matrix,
-                      opposing_side_matrix);
+    // Razoring - the static evaluation is so far below alpha that, only a
+    // tactic could raise alpha so, quiescence search decides if the node is
+    // worth searching.
+    const Matrex_FP_Int fp_razoring_margin = Matrex_FP_Int::from_integer(
+        (parameters[RAZORING_LINEAR_MARGIN] * depth)
+        + parameters[RAZORING_CONSTANT_MARGIN]);
+    const Score razoring_threshold =
+        static_evaluation + Score(fp_razoring_margin);
+    if (should_do_razoring(is_pv_node,
+                           is_side_to_move_in_check,
+                           depth,
+                           razoring_threshold,
+                           alpha))
+    {
+        const Score razoring_score =
+            quiescence(position, ply, alpha, beta).second;
+
+        if (razoring_score <= alpha) { return {Chess_Move(), razoring_score}; }
+    }
+
+    // Null move pruning - if the opponent cannot punish the side to move even
+    // when it passes the turn, a reduced depth null window search of the null
+    // move failing high means a real move would almost certainly fail high too.
+    if (should_do_null_move_pruning(position,
+                                    is_pv_node,
+                                    is_side_to_move_in_check,
+                                    depth,
+                                    ply,
+                                    static_evaluation,
+                                    beta))
+    {
+        const uint16_t null_move_reduction =
+            (NULL_MOVE_BASE_REDUCTION
+             + (depth / NULL_MOVE_DEPTH_REDUCTION_DIVISOR));
+        const uint16_t null_move_depth = (depth > (null_move_reduction + 1))
+                                           ? (depth - null_move_reduction - 1)
+                                           : QUIESCENCE_SEARCH_DEPTH;
 
-    const Score static_evaluation = e.evaluate(m_correction_history);
-
-    // const Matrex_FP_Int fp_reverse_futility_pruning_margin =
-    //     Matrex_FP_Int::from_integer((2 * depth_squared) + (32 * depth) + 16);
-    // const Score reverse_futility_pruning_margin =
-    //     Score(fp_reverse_futility_pruning_margin);
-    // const Score reverse_futility_threshold =
-    //     static_evaluation - reverse_futility_pruning_margin;
-    // if (should_do_reverse_futility_pruning(is_side_to_move_in_check,
-    //                                        reverse_futility_threshold,
-    //                                        beta))
-    // {
-    //     return {Chess_Move(), reverse_futility_threshold};
-    // }
+        Principal_Variation_List null_move_principal_variation;
+
+        // The null move's subtree reads it's own continuation histories since,
+        // it has no moving piece to index the continuation history tables.
+        const auto q_cont_hist_max_idx =
+            q_cont_hist_stack.stack.get_max_index();
+        q_cont_hist_stack.bind_to_history_table(m_null_move_q_hist_table, ply);
+
+        const auto c_cont_hist_max_idx =
+            c_cont_hist_stack.stack.get_max_index();
+        c_cont_hist_stack.bind_to_history_table(m_null_move_c_hist_table, ply);
+
+        // The child sees the null move and does not pass the turn back.
+        m_search_stack[ply].move = Chess_Move();
+
+        const Undo_Chess_Move undo_null_move = position.make_null_move();
+
+        const Score null_move_score =
+            -negamax(position,
+                     null_move_depth,
+                     null_move_principal_variation,
+                     q_cont_hist_stack,
+                     c_cont_hist_stack,
+                     (ply + 1),
+                     -beta,
+                     (-beta + Score(PV_WINDOW_SIZE)))
+                 .second;
+
+        position.undo_null_move(undo_null_move);
+
+        q_cont_hist_stack.stack.truncate(q_cont_hist_max_idx);
+        c_cont_hist_stack.stack.truncate(c_cont_hist_max_idx);
+
+        if (null_move_score >= beta)
+        {
+            // Passing the turn is illegal so, a mate found after it is not a
+            // proven mate.
+            const Score null_move_cutoff_score =
+                null_move_score.is_mating_score() ? beta : null_move_score;
+
+            if (depth < NULL_MOVE_VERIFICATION_MIN_DEPTH)
+            {
+                return {Chess_Move(), null_move_cutoff_score};
+            }
+
+            // At high depths a wrong cutoff (zugzwang) is expensive so, the
+            // cutoff is verified by searching the position itself at the
+            // reduced depth without null moves.
+            m_is_verifying_null_move = true;
+
+            const Score verification_score =
+                negamax(position,
+                        null_move_depth,
+                        principal_variation,
+                        q_cont_hist_stack,
+                        c_cont_hist_stack,
+                        ply,
+                        (beta - Score(PV_WINDOW_SIZE)),
+                        beta)
+                    .second;
+
+            m_is_verifying_null_move = false;
+
+            if (verification_score >= beta)
+            {
+                return {Chess_Move(), null_move_cutoff_score};
+            }
+        }
+    }
 
     Principal_Variation_List child_principal_variation;
     Chess_Move               best_move        = Chess_Move();
@@ -230,7 +499,8 @@ Search_Engine::negamax(Chess_Board&                    position,
 
     Static_Exchange_Evaluator<int64_t> see(position);
 
-    bool is_first_move = true;
+    bool     is_first_move         = true;
+    uint16_t num_of_moves_searched = 0;
     for (const Chess_Move& move : moves)
     {
         // Static Exchange Evaluation Pruning (Captures Only)
@@ -279,6 +549,24 @@ Search_Engine::negamax(Chess_Board&                    position,
             continue;
         }
 
+        // Late move reduction - a quiet move ordered late is unlikely to raise
+        // alpha so, it is first searched at a reduced depth. Read before the
+        // move is bound to the continuation history stack.
+        uint16_t late_move_reduction = 0;
+        if (should_do_late_move_reduction(move,
+                                          is_side_to_move_in_check,
+                                          depth,
+                                          num_of_moves_searched))
+        {
+            late_move_reduction =
+                get_late_move_reduction(position,
+                                        q_cont_hist_stack,
+                                        move,
+                                        is_pv_node,
+                                        depth,
+                                        num_of_moves_searched);
+        }
+
         // Ensure each child has its own principal variation and is unaffected
         // by moves from the previous sibling.
         child_principal_variation.clear();
@@ -295,6 +583,9 @@ Search_Engine::negamax(Chess_Board&                    position,
             c_cont_hist_stack.stack.get_max_index();
         c_cont_hist_stack.bind_to_history_table(m_c_cont_hist_table[move], ply);
 
+        // The child reads this move to find it's counter move.
+        m_search_stack[ply].move = move;
+
         // Explore the child move's subtree for it's evaluation. Negate the
         // result to compare it's score to the parent's scores (alpha,
         // evaluation, etc).
@@ -325,7 +616,7 @@ Search_Engine::negamax(Chess_Board&                    position,
             // Search the presumably non-PV node with the narrowest window
             // around alpha since, we assume no other move will raise alpha.
             child_result = negamax(position,
-                                   (depth - 1),
+                                   (depth - 1 - late_move_reduction),
                                    child_principal_variation,
                                    q_cont_hist_stack,
                                    c_cont_hist_stack,
@@ -333,7 +624,23 @@ Search_Engine::negamax(Chess_Board&                    position,
                                    (-alpha - Score(PV_WINDOW_SIZE)),
                                    -alpha);
 
-            const Score child_score = -child_result.second;
+            Score child_score = -child_result.second;
+
+            // A reduced search that raised alpha is not trusted - redo the
+            // search at the full depth before the move may become the best.
+            if ((late_move_reduction > 0) && (child_score > alpha))
+            {
+                child_result = negamax(position,
+                                       (depth - 1),
+                                       child_principal_variation,
+                                       q_cont_hist_stack,
+                                       c_cont_hist_stack,
+                                       (ply + 1),
+                                       (-alpha - Score(PV_WINDOW_SIZE)),
+                                       -alpha);
+
+                child_score = -child_result.second;
+            }
 
             // If the child result's score raised alpha and was within the full
             // alpha-beta window - redo the search because we found out that
@@ -412,6 +719,10 @@ Search_Engine::negamax(Chess_Board&                    position,
         {
             beta_cutoff_move = move;
             score_bound      = Score_Bound_Type::LOWER_BOUND;
+
+            ++m_num_of_beta_cutoffs;
+            if (is_first_move) { ++m_num_of_first_move_beta_cutoffs; }
+
             break;
         }
         else
@@ -432,6 +743,7 @@ Search_Engine::negamax(Chess_Board&                    position,
         }
 
         is_first_move = false;
+        ++num_of_moves_searched;
     }
 
     // Correction History Update.
@@ -447,7 +759,7 @@ Search_Engine::negamax(Chess_Board&                    position,
                                     static_evaluation);
     }
 
-    // Continuation History Update.
+    // Continuation History, Main History, Killer and Counter Move Update.
     if (should_update_quiet_continuation_history(beta_cutoff_move, score_bound))
     {
         update_continuation_history(q_cont_hist_stack,
@@ -455,6 +767,13 @@ Search_Engine::negamax(Chess_Board&                    position,
                                     ply,
                                     depth_squared,
                                     quiets_to_malus);
+
+        update_main_history(position,
+                            beta_cutoff_move,
+                            depth_squared,
+                            quiets_to_malus);
+
+        update_refutations(position, beta_cutoff_move, ply);
     }
 
     if (should_update_capture_continuation_history(beta_cutoff_move,
@@ -488,6 +807,38 @@ Search_Engine::negamax(Chess_Board&                    position,
     return {best_move, best_score};
 }
 
+uint16_t Search_Engine::get_late_move_reduction(
+    const Chess_Board&                  position,
+    const Search_Quiet_Cont_Hist_Stack& q_cont_hist_stack,
+    const Chess_Move&                   move,
+    const bool                          is_pv_node,
+    const uint16_t                      depth,
+    const uint16_t                      num_of_moves_searched) const
+{
+    const std::size_t depth_index =
+        std::min<std::size_t>(depth, MAX_SEARCH_DEPTH_SOFT_LIMIT);
+    const std::size_t move_number_index =
+        std::min<std::size_t>(num_of_moves_searched,
+                              (MAXIMUM_NUM_OF_MOVES_IN_A_POSITION - 1));
+
+    int32_t reduction = LATE_MOVE_REDUCTIONS[depth_index][move_number_index];
+
+    // The score of a PV node is exact so, it's moves are searched more
+    // precisely.
+    if (is_pv_node) { --reduction; }
+
+    // Moves that caused beta cutoffs in similar positions are reduced less and
+    // moves that failed low are reduced more.
+    const int32_t history =
+        (q_cont_hist_stack.get_score(move)
+         + m_main_history.get(position.get_side_to_move(), move));
+    reduction -= (history / LATE_MOVE_REDUCTION_HISTORY_DIVISOR);
+
+    // The reduced search never drops into quiescence search.
+    return static_cast<uint16_t>(
+        std::clamp<int32_t>(reduction, 0, (depth - 2)));
+}
+
 // This function implements quiescence search. The idea of quiescence search
 // is to avoid the horizon effect - the concept that a depth-limited search
 // will be insufficient to play out the consequences of available tactical
@@ -550,16 +901,6 @@ Search_Engine_Result Search_Engine::quiescence(Chess_Board& position,
     Move_Generation_List&  moves              = mo.get_sorted_moves();
     Moves_Bitboard_Matrix& moving_side_matrix = mo.get_moves_matrix();
 
-    // Generate moves matrix for the opposing side for evaluation purposes.
-    const PIECE_COLOR opposing_side =
-        (PIECE_COLOR) ((~position.get_side_to_move()) & 0x1);
-    Move_Generation_List  not_used_moves_list;
-    Moves_Bitboard_Matrix opposing_side_matrix;
-    Move_Generator        mg(position);
-    mg.generate_all_moves<MOVE_GENERATION_TYPE::ALL>(opposing_side,
-                                                     not_used_moves_list,
-                                                     opposing_side_matrix);
-
     // No moves and in check - return mate score. Note, we don't handle
     // stalemates in quiescence search.
     if ((moves.get_max_index() == -1) && is_side_to_move_in_check)
@@ -584,13 +925,17 @@ Search_Engine_Result Search_Engine::quiescence(Chess_Board& position,
         return {Chess_Move(), mate_score};
     }
 
-    // Stand pat evaluation.
-    const Evaluator e(TUNED_EVALUATION_WEIGHTS,
-                      position,
-                      moving_side_matrix,
-                      opposing_side_matrix);
-
-    Score stand_pat = e.evaluate(m_correction_history);
+    // Stand pat evaluation - lazy when not in check since, only its relation
+    // to the window matters unless it lies inside of it.
+    bool  is_stand_pat_lazy = false;
+    Score stand_pat =
+        is_side_to_move_in_check
+            ? evaluate_position(position, moving_side_matrix)
+            : evaluate_position(position,
+                                moving_side_matrix,
+                                alpha,
+                                beta,
+                                is_stand_pat_lazy);
 
     // Update stand pat evaluation based on a transposition table hit which
     // would most likely be based on a deeper search.
@@ -600,21 +945,30 @@ Search_Engine_Result Search_Engine::quiescence(Chess_Board& position,
                                              stand_pat))
     {
         stand_pat = transposition_table_entry.score;
+        is_stand_pat_lazy = false;
     }
 
     // No tactical moves - return the static evaluation (stand pat).
     if ((moves.get_max_index() == -1) && (!is_side_to_move_in_check))
     {
+        // Static evaluations are exact unless, the lazy evaluation only
+        // produced a bound outside of the window.
+        Score_Bound_Type stand_pat_bound = Score_Bound_Type::EXACT;
+        if (is_stand_pat_lazy)
+        {
+            stand_pat_bound = (stand_pat <= alpha)
+                                ? Score_Bound_Type::UPPER_BOUND
+                                : Score_Bound_Type::LOWER_BOUND;
+        }
+
         // Cache the position's stand pat evaluation in the transposition table.
         transposition_table_entry = {
             .best_move = Chess_Move(), // No best move.
             .score     = stand_pat,
             .partial_zobrist =
                 Transposition_Table::get_partial_zobrist(position_z_hash),
-            .depth = QUIESCENCE_SEARCH_DEPTH,
-            .score_bound =
-                Score_Bound_Type::EXACT // Static evaluations are always exact.
-        };
+            .depth       = QUIESCENCE_SEARCH_DEPTH,
+            .score_bound = stand_pat_bound};
         m_transposition_table.write(m_current_search_depth,
                                     ply,
                                     position_z_hash,
@@ -735,16 +1089,70 @@ Search_Engine_Result Search_Engine::iterative_deepening()
     // Iteratively increment the negamax search depth and start the
     // search timer.
     m_timer.start();
-    for (uint16_t current_depth = 1; current_depth < MAX_SEARCH_DEPTH;
+    // No node is searched deeper than the soft limit so, neither is an
+    // iteration.
+    for (uint16_t current_depth = 1;
+         current_depth <= MAX_SEARCH_DEPTH_SOFT_LIMIT;
          ++current_depth)
     {
         m_current_search_depth = current_depth;
 
-        Search_Engine_Result result = negamax(m_chess_board,
-                                              current_depth,
-                                              m_principal_variation,
-                                              m_q_cont_hist_stack,
-                                              m_c_cont_hist_stack);
+        // Once the score is stable, search a narrow window around the previous
+        // iteration's score since, a narrower window prunes more. Mate scores
+        // are not stable so, they are searched with the full window.
+        Aspiration_Window_Statistics aspiration_window_statistics;
+        Score                        alpha = Score(FP_NEGATIVE_INFINITY);
+        Score                        beta  = Score(FP_POSITIVE_INFINITY);
+
+        if ((current_depth >= ASPIRATION_WINDOW_MIN_DEPTH)
+            && (!best.second.is_mating_score()))
+        {
+            aspiration_window_statistics.delta =
+                ASPIRATION_WINDOW_INITIAL_DELTA.get_value();
+            alpha = get_aspiration_window_bound(
+                best.second,
+                -aspiration_window_statistics.delta);
+            beta = get_aspiration_window_bound(
+                best.second,
+                aspiration_window_statistics.delta);
+        }
+
+        Search_Engine_Result result;
+        while (true)
+        {
+            result = negamax(m_chess_board,
+                             current_depth,
+                             m_principal_variation,
+                             m_q_cont_hist_stack,
+                             m_c_cont_hist_stack,
+                             0,
+                             alpha,
+                             beta);
+
+            if (m_timer_expired_during_search) { break; }
+
+            // A score outside of the window is only a bound so, the failed
+            // side of the window is widened and the iteration searched again.
+            if ((result.second <= alpha)
+                && (alpha > Score(FP_NEGATIVE_INFINITY)))
+            {
+                ++aspiration_window_statistics.num_of_fail_lows;
+                aspiration_window_statistics.delta *= 2;
+                alpha = get_aspiration_window_bound(
+                    best.second,
+                    -aspiration_window_statistics.delta);
+            }
+            else if ((result.second >= beta)
+                     && (beta < Score(FP_POSITIVE_INFINITY)))
+            {
+                ++aspiration_window_statistics.num_of_fail_highs;
+                aspiration_window_statistics.delta *= 2;
+                beta = get_aspiration_window_bound(
+                    best.second,
+                    aspiration_window_statistics.delta);
+            }
+            else { break; }
+        }
 
         uint64_t current_time = m_timer.elapsed();
 
@@ -752,9 +1160,15 @@ Search_Engine_Result Search_Engine::iterative_deepening()
                                                current_time,
                                                m_num_of_nodes_searched,
                                                m_principal_variation,
-                                               result.second);
+                                               result.second,
+                                               aspiration_window_statistics);
+
+        if (m_constraints.should_print_info)
+        {
+            std::cout << uci_search_info << std::endl;
+        }
 
-        std::cout << uci_search_info << std::endl;
+        best = result;
 
         if ((m_constraints.is_depth_search())
             && (current_depth == m_constraints.depth))
@@ -762,7 +1176,11 @@ Search_Engine_Result Search_Engine::iterative_deepening()
             break;
         }
 
-        best = result;
+        if ((m_constraints.is_node_search())
+            && (m_num_of_nodes_searched >= m_constraints.nodes))
+        {
+            break;
+        }
 
         m_principal_variation.clear();
 
@@ -775,6 +1193,65 @@ Search_Engine_Result Search_Engine::iterative_deepening()
     return best;
 }
 
+// Static evaluation of the position from the side to move's point of view using
+// either the NNUE network (when enabled and loaded) or the hand-crafted
+// evaluator with the tuned weights.
+Score Search_Engine::evaluate_position(
+    const Chess_Board&           position,
+    const Moves_Bitboard_Matrix& moving_side_matrix)
+{
+    if (m_constraints.use_nnue_evaluation && NNUE::is_loaded())
+    {
+        const NNUE_Evaluator e(position);
+        return e.evaluate(m_correction_history);
+    }
+
+    // Generate moves matrix for the opposing side for evaluation purposes.
+    const PIECE_COLOR opposing_side =
+        (PIECE_COLOR) ((~position.get_side_to_move()) & 0x1);
+    Move_Generation_List  not_used_moves_list;
+    Moves_Bitboard_Matrix opposing_side_matrix;
+    Move_Generator        mg(position);
+    mg.generate_all_moves<MOVE_GENERATION_TYPE::ALL>(opposing_side,
+                                                     not_used_moves_list,
+                                                     opposing_side_matrix);
+
+    const Evaluator e(TUNED_EVALUATION_WEIGHTS,
+                      position,
+                      moving_side_matrix,
+                      opposing_side_matrix);
+
+    return e.evaluate(m_correction_history);
+}
+
+// Lazy static evaluation of the position with respect to the alpha-beta window.
+// If is_lazy is set, the returned score is only a bound; an upper bound when it
+// is <= alpha and a lower bound when it is >= beta.
+Score Search_Engine::evaluate_position(
+    const Chess_Board&           position,
+    const Moves_Bitboard_Matrix& moving_side_matrix,
+    const Score                  alpha,
+    const Score                  beta,
+    bool&                        is_lazy)
+{
+    if (m_constraints.use_nnue_evaluation && NNUE::is_loaded())
+    {
+        is_lazy = false;
+        const NNUE_Evaluator e(position);
+        return e.evaluate(m_correction_history);
+    }
+
+    // The opposing side's moves matrix is generated by the evaluator only if
+    // the expensive stage is needed.
+    const Evaluator e(TUNED_EVALUATION_WEIGHTS, position, moving_side_matrix);
+
+    return e.evaluate(m_correction_history,
+                      alpha,
+                      beta,
+                      is_lazy,
+                      m_evaluation_statistics);
+}
+
 const Transposition_Table_Statistics& Search_Engine::get_tt_statistics() const
 {
 #if COLLECT_TT_STATISTICS == 1
@@ -869,3 +1346,52 @@ void Search_Engine::update_continuation_history(
         }
     }
 }
+
+// The main history is updated with the same bonus and malus as the quiet
+// continuation history.
+void Search_Engine::update_main_history(
+    const Chess_Board&          position,
+    const Chess_Move&           move,
+    const uint32_t              depth_squared,
+    const Move_Generation_List& quiets_to_malus)
+{
+    constexpr bool MALUS = true;
+    constexpr bool BONUS = false;
+
+    const PIECE_COLOR side_to_move = position.get_side_to_move();
+
+    m_main_history.gravity_update<BONUS>(side_to_move, move, depth_squared);
+
+    for (const Chess_Move& malus_move : quiets_to_malus)
+    {
+        m_main_history.gravity_update<MALUS>(side_to_move,
+                                             malus_move,
+                                             (depth_squared >> 1));
+    }
+}
+
+void Search_Engine::update_refutations(const Chess_Board& position,
+                                       const Chess_Move&  move,
+                                       const uint16_t     ply)
+{
+    m_search_stack[ply].killer_moves.update(move);
+
+    if ((ply > 0) && (!m_search_stack[ply - 1].move.is_same_move(Chess_Move())))
+    {
+        m_counter_move_table.get(position.get_side_to_move(),
+                                 m_search_stack[ply - 1].move) = move;
+    }
+}
+
+Chess_Move Search_Engine::get_counter_move(const Chess_Board& position,
+                                           const uint16_t     ply) const
+{
+    // The root has no previous move.
+    if ((ply == 0) || m_search_stack[ply - 1].move.is_same_move(Chess_Move()))
+    {
+        return Chess_Move();
+    }
+
+    return m_counter_move_table.get(position.get_side_to_move(),
+                                    m_search_stack[ply - 1].move);
+}
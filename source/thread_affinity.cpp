@@ -0,0 +1,229 @@
+#include "thread_affinity.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+namespace
+{
+
+// Parses a sysfs CPU (or node) list such as "0-3,8-11" into the CPUs it lists.
+std::vector<uint32_t> parse_cpu_list(const std::string& cpu_list)
+{
+    std::vector<uint32_t> cpus;
+
+    std::stringstream ss(cpu_list);
+    std::string       range;
+
+    while (std::getline(ss, range, ','))
+    {
+        if (range.empty() || (range == "\n")) { continue; }
+
+        const std::size_t dash_index = range.find('-');
+
+        const auto first =
+            static_cast<uint32_t>(std::stoul(range.substr(0, dash_index)));
+        const auto last =
+            (dash_index == std::string::npos)
+                ? first
+                : static_cast<uint32_t>(
+                      std::stoul(range.substr(dash_index + 1)));
+
+        for (uint32_t cpu = first; cpu <= last; ++cpu) { cpus.push_back(cpu); }
+    }
+
+    return cpus;
+}
+
+std::string read_first_line(const std::filesystem::path& path)
+{
+    std::ifstream file(path);
+    std::string   line;
+    std::getline(file, line);
+    return line;
+}
+
+// The IDs of the online NUMA nodes. The IDs need not be contiguous so, they
+// are read from the list of online nodes or else, from the node directories.
+std::vector<uint32_t>
+read_numa_node_ids(const std::filesystem::path& nodes_path)
+{
+    std::vector<uint32_t> node_ids =
+        parse_cpu_list(read_first_line(nodes_path / "online"));
+
+    if (!node_ids.empty()) { return node_ids; }
+
+    std::error_code error;
+    for (const auto& entry :
+         std::filesystem::directory_iterator(nodes_path, error))
+    {
+        const std::string name = entry.path().filename().string();
+
+        if ((name.size() > 4) && name.starts_with("node")
+            && std::all_of((name.begin() + 4),
+                           name.end(),
+                           [](const unsigned char c)
+                           { return (std::isdigit(c) != 0); }))
+        {
+            node_ids.push_back(
+                static_cast<uint32_t>(std::stoul(name.substr(4))));
+        }
+    }
+
+    std::sort(node_ids.begin(), node_ids.end());
+
+    return node_ids;
+}
+
+#if defined(__linux__)
+
+std::optional<cpu_set_t> read_process_affinity_mask()
+{
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+
+    if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) != 0)
+    {
+        return std::nullopt;
+    }
+
+    return cpu_set;
+}
+
+// The affinity mask of the process before any thread was pinned, it is read
+// during static initialization which runs before any thread can be pinned.
+const std::optional<cpu_set_t> PROCESS_AFFINITY_MASK =
+    read_process_affinity_mask();
+
+#endif
+
+// Whether the process may run on the CPU.
+bool is_cpu_allowed(const uint32_t cpu)
+{
+#if defined(__linux__)
+    if (!PROCESS_AFFINITY_MASK.has_value()) { return true; }
+
+    return (cpu < CPU_SETSIZE) && CPU_ISSET(cpu, &(*PROCESS_AFFINITY_MASK));
+#else
+    (void) cpu;
+    return true;
+#endif
+}
+
+} // namespace
+
+Numa_Topology read_numa_topology()
+{
+    Numa_Topology topology;
+
+    const std::filesystem::path nodes_path("/sys/devices/system/node");
+
+    std::error_code error;
+    if (std::filesystem::is_directory(nodes_path, error))
+    {
+        for (const uint32_t node : read_numa_node_ids(nodes_path))
+        {
+            std::vector<uint32_t> cpus = parse_cpu_list(read_first_line(
+                nodes_path / ("node" + std::to_string(node)) / "cpulist"));
+
+            std::erase_if(cpus,
+                          [](const uint32_t cpu)
+                          { return !is_cpu_allowed(cpu); });
+
+            if (!cpus.empty())
+            {
+                topology.node_cpus.push_back(std::move(cpus));
+            }
+        }
+    }
+
+    // Fall back to a single node of all CPUs the process may run on.
+    if (topology.node_cpus.empty())
+    {
+        std::vector<uint32_t> cpus;
+        for (uint32_t cpu = 0;
+             cpu < std::max(std::thread::hardware_concurrency(), 1U);
+             ++cpu)
+        {
+            if (is_cpu_allowed(cpu)) { cpus.push_back(cpu); }
+        }
+
+        if (cpus.empty()) { cpus.push_back(0); }
+
+        topology.node_cpus.push_back(std::move(cpus));
+    }
+
+    return topology;
+}
+
+std::vector<uint32_t> cpus_spread_across_numa_nodes()
+{
+    const Numa_Topology topology = read_numa_topology();
+
+    std::size_t max_cpus_per_node = 0;
+    for (const auto& cpus : topology.node_cpus)
+    {
+        max_cpus_per_node = std::max(max_cpus_per_node, cpus.size());
+    }
+
+    // Take the i-th CPU of every node in turn.
+    std::vector<uint32_t> spread_cpus;
+    for (std::size_t i = 0; i < max_cpus_per_node; ++i)
+    {
+        for (const auto& cpus : topology.node_cpus)
+        {
+            if (i < cpus.size()) { spread_cpus.push_back(cpus[i]); }
+        }
+    }
+
+    return spread_cpus;
+}
+
+bool pin_current_thread_to_cpu(const uint32_t cpu)
+{
+#if defined(__linux__)
+    if (cpu >= CPU_SETSIZE) { return false; }
+
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+
+    return (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set)
+            == 0);
+#else
+    (void) cpu;
+    return false;
+#endif
+}
+
+bool unpin_current_thread()
+{
+#if defined(__linux__)
+    if (!PROCESS_AFFINITY_MASK.has_value()) { return false; }
+
+    return (pthread_setaffinity_np(pthread_self(),
+                                   sizeof(*PROCESS_AFFINITY_MASK),
+                                   &(*PROCESS_AFFINITY_MASK))
+            == 0);
+#else
+    return false;
+#endif
+}
+
+std::optional<uint32_t> current_cpu()
+{
+#if defined(__linux__)
+    const int cpu = sched_getcpu();
+    if (cpu >= 0) { return static_cast<uint32_t>(cpu); }
+#endif
+    return std::nullopt;
+}
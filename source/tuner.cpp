@@ -1,16 +1,61 @@
 #include "tuner.hpp"
 
+#include <deque>
 #include <iomanip>
 #include <numbers>
+#include <numeric>
 #include <random>
-#include <ranges>
-
-Tuner::Tuner(std::ostream&  logging,
-             std::ifstream& dataset_file,
-             std::ofstream& output) :
-    m_log(logging), m_output(output), m_thread_pool(TUNER_NUM_OF_THREADS)
+#include <span>
+#include <sstream>
+#include <stdexcept>
+
+#include "timer.hpp"
+
+Tuner::Tuner(std::ostream&                logging,
+             std::ifstream&               dataset_file,
+             std::ofstream&               output,
+             const std::size_t            num_of_threads,
+             const bool                   pin_threads,
+             const std::filesystem::path& checkpoint_path,
+             const std::size_t            memory_budget) :
+    m_log(logging),
+    m_output(output),
+    m_memory_budget(memory_budget),
+    m_num_of_threads(num_of_threads),
+    m_thread_pool(num_of_threads, pin_threads),
+    m_checkpoint_path(checkpoint_path),
+    m_rng(std::random_device {}())
 {
-    parse_dataset_file(dataset_file, m_training_dataset, m_validation_dataset);
+    if (m_num_of_threads == 0)
+    {
+        throw std::invalid_argument("The tuner needs at least one thread.");
+    }
+
+    if (pin_threads
+        && (m_thread_pool.get_num_of_pinned_workers() < m_num_of_threads))
+    {
+        m_log << "[INFO] Only " << m_thread_pool.get_num_of_pinned_workers()
+              << " of " << m_num_of_threads
+              << " threads could be pinned to a CPU." << std::endl;
+    }
+
+    if (memory_budget == 0)
+    {
+        parse_dataset_file(dataset_file,
+                           m_training_dataset,
+                           m_validation_dataset);
+
+        m_gradient_graph =
+            compile_gradient_graph(m_training_dataset.mini_batches[0].features);
+    }
+    else
+    {
+        open_dataset_streams(dataset_file, memory_budget);
+
+        Mini_Batch first_mini_batch;
+        m_training_stream->next(first_mini_batch);
+        m_gradient_graph = compile_gradient_graph(first_mini_batch.features);
+    }
 
     constexpr uint8_t DOUBLE_STD_OUT_PRECISION = 8;
 
@@ -106,21 +151,53 @@ Evaluation_Weights<double> Tuner::init_weights()
     return weights;
 }
 
-Evaluation_Weights<double> Tuner::tune()
+Evaluation_Weights<double> Tuner::tune(const bool resume)
 {
-    Tuner_Step_State global_state;
-    global_state.weights = init_weights();
+    Timer tuning_timer;
+
+    Tuner_Checkpoint checkpoint;
+    checkpoint.num_of_threads = m_num_of_threads;
+    checkpoint.memory_budget  = m_memory_budget;
+
+    if (resume)
+    {
+        checkpoint = read_checkpoint();
+
+        std::istringstream rng_state(checkpoint.rng_state);
+        rng_state >> m_rng;
+
+        m_log << "[INFO] Resuming from epoch " << checkpoint.epoch
+              << " at timestep " << checkpoint.timestep << "." << std::endl;
+    }
+    else
+    {
+        checkpoint.state.weights = init_weights();
+        checkpoint.best_weights  = checkpoint.state.weights;
+
+        m_log << "[INFO] Initial weights: " << checkpoint.state.weights
+              << std::endl;
+    }
 
-    m_log << "[INFO] Initial weights: " << global_state.weights << std::endl;
+    // The global state is read by the step jobs as a snapshot and replaced
+    // with a new version after every step.
+    Shared_Snapshot<Tuner_Step_State> global_state(checkpoint.state);
 
-    Evaluation_Weights<double> best_weights = global_state.weights;
+    // The local state of every worker is kept across the steps, it is
+    // allocated by the worker itself on its first step.
+    Tuner_Step_Shared_Data::Local_States local_states(m_num_of_threads);
 
     const std::size_t num_of_mini_batches =
-        m_training_dataset.mini_batches.size();
+        is_streaming() ? m_training_stream->get_num_of_mini_batches()
+                       : m_training_dataset.mini_batches.size();
+    const uint64_t training_dataset_size =
+        is_streaming() ? m_training_stream->get_num_of_positions()
+                       : m_training_dataset.size;
     const double max_training_data_loss =
-        compute_max_data_loss(m_training_dataset);
+        is_streaming() ? compute_max_data_loss(*m_training_stream)
+                       : compute_max_data_loss(m_training_dataset);
     const double max_validation_data_loss =
-        compute_max_data_loss(m_validation_dataset);
+        is_streaming() ? compute_max_data_loss(*m_validation_stream)
+                       : compute_max_data_loss(m_validation_dataset);
 
     m_log << "[INFO] There is " << num_of_mini_batches
           << " batches in 1 training epoch." << std::endl;
@@ -129,21 +206,28 @@ Evaluation_Weights<double> Tuner::tune()
     m_log << "[INFO] Maximum data loss for the validation dataset is: "
           << max_validation_data_loss << std::endl;
 
-    uint64_t t = 1; // NADAM's timestep
-    double   previous_epoch_training_loss =
-        compute_loss(m_training_dataset, best_weights);
-    double previous_epoch_validation_loss =
-        compute_loss(m_validation_dataset, best_weights);
-    uint8_t epoch_patience_count = 0;
-
-    m_log << "[INFO] Initial training dataset loss is "
-          << previous_epoch_training_loss << std::endl;
-    m_log << "[INFO] Initial validation dataset loss is "
-          << previous_epoch_validation_loss << std::endl;
+    if (!resume)
+    {
+        checkpoint.previous_epoch_training_loss =
+            compute_training_loss(checkpoint.best_weights);
+        checkpoint.previous_epoch_validation_loss =
+            compute_validation_loss(checkpoint.best_weights);
+
+        m_log << "[INFO] Initial training dataset loss is "
+              << checkpoint.previous_epoch_training_loss << std::endl;
+        m_log << "[INFO] Initial validation dataset loss is "
+              << checkpoint.previous_epoch_validation_loss << std::endl;
+    }
 
-    for (uint64_t epoch = 1; epoch <= TUNER_MAX_EPOCHS; ++epoch)
+    while (checkpoint.epoch <= TUNER_MAX_EPOCHS)
     {
-        double weight_update_magnitude_average = 0;
+        const uint64_t epoch = checkpoint.epoch;
+
+        // The state of the random number generator at the start of the epoch
+        // is what a checkpoint in the middle of the epoch stores such that,
+        // a resumed epoch generates the same order of mini-batches.
+        std::ostringstream epoch_rng_state;
+        epoch_rng_state << m_rng;
 
         // Shuffling our mini batches diversifies the loss landscapes L_Xi (Xi
         // being the mini batch i of a training set X - shuffling increases the
@@ -157,94 +241,152 @@ Evaluation_Weights<double> Tuner::tune()
         // a minimum - noting that it will escape some local minima that are not
         // minima across all mini-batches (some depressions in the surface/local
         // minima can be caused by noise in the data of a particular
-        // mini-batch).
-        std::shuffle(m_training_dataset.mini_batches.begin(),
-                     m_training_dataset.mini_batches.end(),
-                     std::mt19937_64(std::random_device {}()));
+        // mini-batch). A streamed dataset is shuffled by the stream, the pass
+        // is seeded from the same generator such that, it is resumed the same
+        // way.
+        std::vector<std::size_t> mini_batch_order;
+        if (is_streaming())
+        {
+            m_training_stream->start_pass(true,
+                                          m_rng(),
+                                          checkpoint.next_mini_batch);
+        }
+        else
+        {
+            mini_batch_order.resize(num_of_mini_batches);
+            std::iota(mini_batch_order.begin(), mini_batch_order.end(), 0);
+            std::shuffle(mini_batch_order.begin(),
+                         mini_batch_order.end(),
+                         m_rng);
+        }
 
         double learning_rate = learning_rate_scheduler(epoch);
 
         m_log << "[INFO] Learning rate for epoch " << epoch << " is "
               << learning_rate << std::endl;
 
-        for (const Mini_Batch& mini_batch : m_training_dataset.mini_batches)
-        {
-            // Create a split of the mini batch for every worker thread.
-            Worker_Batches worker_data = create_worker_batches(mini_batch);
+        Timer epoch_timer;
+
+        // The stream prefetches the next mini-batch while the workers step on
+        // the current one.
+        Mini_Batch streamed_mini_batch;
 
-            // Create an array for each thread to store it's state.
-            Tuner_Step_States_Array thread_states;
+        for (; checkpoint.next_mini_batch < num_of_mini_batches;
+             ++checkpoint.next_mini_batch)
+        {
+            if (is_streaming() && !m_training_stream->next(streamed_mini_batch))
+            {
+                throw std::runtime_error(
+                    "The training stream ended before the epoch.");
+            }
 
-            // Create the shared data object for the threads.
-            Threads_Shared_Data shared_data(learning_rate,
-                                            global_state,
-                                            thread_states,
-                                            weight_update_magnitude_average,
-                                            t);
+            const Mini_Batch& mini_batch =
+                is_streaming()
+                    ? streamed_mini_batch
+                    : m_training_dataset.mini_batches
+                          [mini_batch_order[checkpoint.next_mini_batch]];
+
+            // Create the shared data object for the threads, it holds a slot
+            // for each thread to store it's state.
+            Tuner_Step_Shared_Data shared_data {
+                .learning_rate = learning_rate,
+                .timestep      = checkpoint.timestep,
+                .global_state  = global_state,
+                .local_states  = local_states,
+                .split_sizes =
+                    Thread_Result_Slots<std::size_t>(m_num_of_threads),
+                .weight_update_magnitudes =
+                    Thread_Result_Slots<double>(m_num_of_threads),
+                .next_global_state = {}};
 
             // Push as many jobs as there are threads assigning each tuner step
-            // job a different split of the mini-batch.
-            for (std::size_t i = 0; i < TUNER_NUM_OF_THREADS; ++i)
+            // job a different split of the mini-batch, the job of a split is
+            // bound to the pool worker of the same index.
+            for (std::size_t i = 0; i < m_num_of_threads; ++i)
             {
                 std::unique_ptr<Thread_Job> job =
                     std::make_unique<Tuner_Step>(shared_data,
                                                  (*this),
-                                                 worker_data.batches[i]);
+                                                 mini_batch,
+                                                 i);
 
-                m_thread_pool.push_job(std::move(job));
+                m_thread_pool.push_job_to_worker(std::move(job), i);
             }
 
             // Wait for all threads in the pool to complete their jobs.
             m_thread_pool.wait_for_jobs_to_complete();
 
-            // Calculate the average state (average moments and average weights)
-            // from the thread states array. Note that all threads have
-            // completed execution so their is no need for synchronization
-            // primitives to access their final states.
-            Tuner_Step_State average_state;
-            for (const auto& state : thread_states)
+            // Average the thread states (moments and weights) into the next
+            // global state. Note that all threads have completed their steps
+            // so, the weights are split into a slice per thread and every
+            // thread averages its slice across all thread states.
+            const std::size_t num_of_weights =
+                shared_data.next_global_state.weights.get_size();
+            const std::size_t slice_size =
+                (num_of_weights + m_num_of_threads - 1) / m_num_of_threads;
+
+            for (std::size_t begin = 0; begin < num_of_weights;
+                 begin += slice_size)
             {
-                average_state.first_moment =
-                    average_state.first_moment + state.first_moment;
-                average_state.second_moment =
-                    average_state.second_moment + state.second_moment;
-                average_state.weights = average_state.weights + state.weights;
+                std::unique_ptr<Thread_Job> job =
+                    std::make_unique<Tuner_Reduce>(
+                        shared_data,
+                        begin,
+                        std::min((begin + slice_size), num_of_weights));
+
+                m_thread_pool.push_job(std::move(job));
             }
-            average_state.first_moment =
-                average_state.first_moment
-                / static_cast<double>(TUNER_NUM_OF_THREADS);
-            average_state.second_moment =
-                average_state.second_moment
-                / static_cast<double>(TUNER_NUM_OF_THREADS);
-            average_state.weights = average_state.weights
-                                  / static_cast<double>(TUNER_NUM_OF_THREADS);
 
-            // Assign the new global state as the average.
-            global_state = average_state;
+            m_thread_pool.wait_for_jobs_to_complete();
 
-            m_log << "Weights at timestep " << t << " are; "
-                  << global_state.weights << std::endl;
+            for (std::size_t i = 0; i < m_num_of_threads; ++i)
+            {
+                checkpoint.weight_update_magnitude_sum +=
+                    shared_data.weight_update_magnitudes[i];
+            }
+
+            // Publish the averaged state as the new global state.
+            global_state.publish(std::move(shared_data.next_global_state));
+
+            m_log << "Weights at timestep " << checkpoint.timestep << " are; "
+                  << global_state.read()->weights << std::endl;
 
             // Increment timestep.
-            ++t;
+            ++checkpoint.timestep;
+
+            if ((checkpoint.timestep % TUNER_CHECKPOINT_INTERVAL) == 0)
+            {
+                Tuner_Checkpoint mid_epoch_checkpoint = checkpoint;
+                ++mid_epoch_checkpoint.next_mini_batch;
+                mid_epoch_checkpoint.rng_state = epoch_rng_state.str();
+                mid_epoch_checkpoint.state     = (*global_state.read());
+
+                write_checkpoint(mid_epoch_checkpoint);
+            }
         }
 
-        weight_update_magnitude_average =
-            weight_update_magnitude_average / num_of_mini_batches;
+        const double epoch_seconds =
+            static_cast<double>(epoch_timer.elapsed()) / NANOSECONDS_IN_SECOND;
+        m_log << "[INFO] Training throughput for epoch " << epoch << " is "
+              << (static_cast<double>(training_dataset_size) / epoch_seconds)
+              << " positions/second." << std::endl;
+
+        const double weight_update_magnitude_average =
+            checkpoint.weight_update_magnitude_sum / num_of_mini_batches;
 
         const double validation_loss =
-            compute_loss(m_validation_dataset, global_state.weights);
+            compute_validation_loss(global_state.read()->weights);
         const double validation_loss_percent =
             100.0L * (validation_loss / max_validation_data_loss);
         const double validation_loss_improvement =
-            previous_epoch_validation_loss - validation_loss;
+            checkpoint.previous_epoch_validation_loss - validation_loss;
 
         const double training_loss =
-            compute_loss(m_training_dataset, global_state.weights);
+            compute_training_loss(global_state.read()->weights);
         const double training_loss_percent =
             100.0L * (training_loss / max_training_data_loss);
         const double training_loss_improvement =
-            previous_epoch_training_loss - training_loss;
+            checkpoint.previous_epoch_training_loss - training_loss;
 
         m_log << "[INFO] Epoch " << epoch
               << ": Validation Loss = " << validation_loss
@@ -255,28 +397,254 @@ Evaluation_Weights<double> Tuner::tune()
               << "; Training Loss Improvement = " << training_loss_improvement
               << "; Training Loss Percent = " << training_loss_percent << "%"
               << "; Weight Update Average = " << weight_update_magnitude_average
+              << "; Elapsed Seconds = "
+              << (static_cast<double>(tuning_timer.elapsed())
+                  / NANOSECONDS_IN_SECOND)
               << std::endl;
 
         if ((validation_loss_improvement < TUNER_LOSS_IMPROVEMENT_CUTOFF)
             && (weight_update_magnitude_average < TUNER_WEIGHT_UPDATE_CUTOFF))
         { // Converged!
-            ++epoch_patience_count;
-            if (epoch_patience_count == TUNER_PATIENCE) { break; }
+            ++checkpoint.epoch_patience_count;
+            if (checkpoint.epoch_patience_count == TUNER_PATIENCE) { break; }
         }
         else
         { // Not converged.
             if (validation_loss_improvement > 0)
             {
-                best_weights = global_state.weights;
+                checkpoint.best_weights = global_state.read()->weights;
             }
-            epoch_patience_count = 0;
+            checkpoint.epoch_patience_count = 0;
         }
 
         m_log << "[INFO] Epoch patience count = "
-              << static_cast<uint64_t>(epoch_patience_count) << std::endl;
+              << checkpoint.epoch_patience_count << std::endl;
+
+        checkpoint.previous_epoch_training_loss   = training_loss;
+        checkpoint.previous_epoch_validation_loss = validation_loss;
+
+        // The next epoch starts from the current state of the random number
+        // generator.
+        std::ostringstream rng_state;
+        rng_state << m_rng;
+
+        ++checkpoint.epoch;
+        checkpoint.next_mini_batch             = 0;
+        checkpoint.weight_update_magnitude_sum = 0;
+        checkpoint.rng_state                   = rng_state.str();
+        checkpoint.state                       = (*global_state.read());
 
-        previous_epoch_training_loss   = training_loss;
-        previous_epoch_validation_loss = validation_loss;
+        write_checkpoint(checkpoint);
+    }
+
+    print_header_file(checkpoint.best_weights);
+
+    return checkpoint.best_weights;
+}
+
+namespace
+{
+
+double dot(const Evaluation_Weights<double>& a,
+           const Evaluation_Weights<double>& b)
+{
+    double result = 0.0L;
+    for (std::size_t i = 0; i < a.get_size(); ++i)
+    {
+        result += a[i] * b[i];
+    }
+
+    return result;
+}
+
+// A weight change and the gradient change it caused.
+struct LBFGS_Correction
+{
+    Evaluation_Weights<double> weight_change;
+    Evaluation_Weights<double> gradient_change;
+    double                     rho; // 1 / (weight change . gradient change)
+};
+
+// The L-BFGS two-loop recursion, returns the product of the inverse Hessian
+// approximated by the corrections (oldest first) and the gradient.
+Evaluation_Weights<double>
+lbfgs_direction(const std::deque<LBFGS_Correction>& corrections,
+                const Evaluation_Weights<double>&   gradient)
+{
+    Evaluation_Weights<double> direction = gradient;
+    std::vector<double>        alphas(corrections.size());
+
+    for (std::size_t i = corrections.size(); i-- > 0;)
+    {
+        alphas[i] = corrections[i].rho
+                  * dot(corrections[i].weight_change, direction);
+        direction -= (corrections[i].gradient_change * alphas[i]);
+    }
+
+    // The newest correction scales the initial inverse Hessian.
+    const LBFGS_Correction& newest = corrections.back();
+    direction *= (dot(newest.weight_change, newest.gradient_change)
+                  / dot(newest.gradient_change, newest.gradient_change));
+
+    for (std::size_t i = 0; i < corrections.size(); ++i)
+    {
+        const double beta = corrections[i].rho
+                          * dot(corrections[i].gradient_change, direction);
+        direction += (corrections[i].weight_change * (alphas[i] - beta));
+    }
+
+    return direction;
+}
+
+} // namespace
+
+Evaluation_Weights<double> Tuner::tune_lbfgs()
+{
+    if (is_streaming())
+    {
+        throw std::runtime_error(
+            "L-BFGS needs the dataset in memory, it can not be streamed.");
+    }
+
+    Timer tuning_timer;
+
+    Evaluation_Weights<double> weights = init_weights();
+
+    m_log << "[INFO] Initial weights: " << weights << std::endl;
+
+    const double max_validation_data_loss =
+        compute_max_data_loss(m_validation_dataset);
+
+    double training_loss = compute_loss(m_training_dataset, weights);
+    double best_validation_loss =
+        compute_loss(m_validation_dataset, weights);
+    Evaluation_Weights<double> best_weights = weights;
+
+    m_log << "[INFO] Initial training dataset loss is " << training_loss
+          << std::endl;
+    m_log << "[INFO] Initial validation dataset loss is "
+          << best_validation_loss << std::endl;
+
+    // The gradient is projected such that, the search direction never points
+    // out of the valid range of the weights.
+    Evaluation_Weights<double> gradient = projected_gradient(
+        weights,
+        compute_full_batch_gradient(m_training_dataset, weights));
+
+    std::deque<LBFGS_Correction> corrections;
+    uint8_t                      patience_count = 0;
+
+    for (uint64_t iteration = 1; iteration <= TUNER_LBFGS_MAX_ITERATIONS;
+         ++iteration)
+    {
+        Evaluation_Weights<double> direction;
+        if (!corrections.empty())
+        {
+            direction = lbfgs_direction(corrections, gradient);
+        }
+
+        // Without curvature information, or if the approximation does not
+        // give a descent direction, step along the gradient.
+        if (corrections.empty() || (dot(direction, gradient) <= 0.0L))
+        {
+            const double gradient_norm = std::sqrt(dot(gradient, gradient));
+            if (gradient_norm == 0.0L) { break; }
+
+            corrections.clear();
+            direction = gradient * (TUNER_LBFGS_INITIAL_STEP / gradient_norm);
+        }
+
+        // Backtracking line search on the projected step.
+        double                     step_length = 1.0L;
+        double                     next_training_loss = training_loss;
+        Evaluation_Weights<double> next_weights;
+        bool                       is_step_accepted = false;
+
+        for (uint8_t i = 0; i < TUNER_LBFGS_MAX_LINE_SEARCH_STEPS; ++i)
+        {
+            next_weights =
+                projected_weight_change(weights, (direction * step_length));
+            next_training_loss = compute_loss(m_training_dataset, next_weights);
+
+            const double predicted_decrease =
+                dot(gradient, (next_weights - weights));
+            if (next_training_loss
+                <= (training_loss
+                    + (TUNER_LBFGS_ARMIJO_CONSTANT * predicted_decrease)))
+            {
+                is_step_accepted = true;
+                break;
+            }
+
+            step_length *= 0.5L;
+        }
+
+        if (!is_step_accepted)
+        {
+            // Restart from the gradient once before giving up.
+            if (corrections.empty()) { break; }
+            corrections.clear();
+            continue;
+        }
+
+        const Evaluation_Weights<double> next_gradient = projected_gradient(
+            next_weights,
+            compute_full_batch_gradient(m_training_dataset, next_weights));
+
+        LBFGS_Correction correction {
+            .weight_change   = (next_weights - weights),
+            .gradient_change = (next_gradient - gradient),
+            .rho             = 0};
+
+        // Only corrections with positive curvature keep the inverse Hessian
+        // approximation positive definite.
+        const double curvature =
+            dot(correction.weight_change, correction.gradient_change);
+        if (curvature > TUNER_EPSILON)
+        {
+            correction.rho = 1.0L / curvature;
+            corrections.push_back(std::move(correction));
+            if (corrections.size() > TUNER_LBFGS_HISTORY_SIZE)
+            {
+                corrections.pop_front();
+            }
+        }
+
+        const double training_loss_improvement =
+            training_loss - next_training_loss;
+
+        weights       = next_weights;
+        gradient      = next_gradient;
+        training_loss = next_training_loss;
+
+        const double validation_loss =
+            compute_loss(m_validation_dataset, weights);
+        if (validation_loss < best_validation_loss)
+        {
+            best_validation_loss = validation_loss;
+            best_weights         = weights;
+        }
+
+        m_log << "[INFO] Iteration " << iteration
+              << ": Validation Loss = " << validation_loss
+              << "; Validation Loss Percent = "
+              << (100.0L * (validation_loss / max_validation_data_loss)) << "%"
+              << "; Training Loss = " << training_loss
+              << "; Training Loss Improvement = " << training_loss_improvement
+              << "; Step Length = " << step_length << "; Elapsed Seconds = "
+              << (static_cast<double>(tuning_timer.elapsed())
+                  / NANOSECONDS_IN_SECOND)
+              << std::endl;
+
+        if (training_loss_improvement < TUNER_LOSS_IMPROVEMENT_CUTOFF)
+        { // Converged!
+            ++patience_count;
+            if (patience_count == TUNER_PATIENCE) { break; }
+        }
+        else
+        {
+            patience_count = 0;
+        }
     }
 
     print_header_file(best_weights);
@@ -284,11 +652,255 @@ Evaluation_Weights<double> Tuner::tune()
     return best_weights;
 }
 
+Evaluation_Weights<double>
+Tuner::compute_full_batch_gradient(const Dataset&                    d,
+                                   const Evaluation_Weights<double>& weights)
+{
+    Tuner_Gradient_Shared_Data shared_data {
+        .dataset  = d,
+        .weights  = weights,
+        .gradient_sums =
+            Thread_Result_Slots<Evaluation_Weights<double>>(m_num_of_threads)};
+
+    for (std::size_t i = 0; i < m_num_of_threads; ++i)
+    {
+        std::unique_ptr<Thread_Job> job =
+            std::make_unique<Tuner_Gradient>(shared_data, (*this), i);
+
+        m_thread_pool.push_job(std::move(job));
+    }
+
+    m_thread_pool.wait_for_jobs_to_complete();
+
+    // Reduce in worker order such that the gradient is deterministic.
+    Evaluation_Weights<double> gradient;
+    for (std::size_t i = 0; i < m_num_of_threads; ++i)
+    {
+        gradient += shared_data.gradient_sums[i];
+    }
+
+    return gradient / static_cast<double>(d.size);
+}
+
+void Tuner::write_checkpoint(const Tuner_Checkpoint& checkpoint) const
+{
+    if (m_checkpoint_path.empty()) { return; }
+
+    // The checkpoint is written next to the previous one and then renamed over
+    // it such that, a crash while writing never leaves a torn checkpoint.
+    std::filesystem::path temporary_path = m_checkpoint_path;
+    temporary_path += ".tmp";
+
+    {
+        std::ofstream checkpoint_file(temporary_path,
+                                      (std::ios::binary | std::ios::trunc));
+        checkpoint.write(checkpoint_file);
+
+        if (!checkpoint_file)
+        {
+            throw std::runtime_error("Failed to write the tuner checkpoint.");
+        }
+    }
+
+    std::filesystem::rename(temporary_path, m_checkpoint_path);
+
+    m_log << "[INFO] Wrote checkpoint at epoch " << checkpoint.epoch
+          << " and timestep " << checkpoint.timestep << "." << std::endl;
+}
+
+Tuner_Checkpoint Tuner::read_checkpoint() const
+{
+    if (m_checkpoint_path.empty())
+    {
+        throw std::invalid_argument(
+            "Resuming the tuner requires a checkpoint path.");
+    }
+
+    std::ifstream checkpoint_file(m_checkpoint_path, std::ios::binary);
+    if (!checkpoint_file)
+    {
+        throw std::runtime_error("Failed to open the tuner checkpoint.");
+    }
+
+    return Tuner_Checkpoint::read(checkpoint_file,
+                                  m_num_of_threads,
+                                  m_memory_budget);
+}
+
+namespace
+{
+
+template <typename T>
+void write_checkpoint_value(std::ostream& os, const T& value)
+{
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void read_checkpoint_value(std::istream& is, T& value)
+{
+    is.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+// The weights are one contiguous block of doubles so, they are written and
+// read as a whole.
+void write_checkpoint_weights(std::ostream&                     os,
+                              const Evaluation_Weights<double>& weights)
+{
+    os.write(reinterpret_cast<const char*>(weights.data()),
+             (weights.get_size() * sizeof(double)));
+}
+
+void read_checkpoint_weights(std::istream&               is,
+                             Evaluation_Weights<double>& weights)
+{
+    is.read(reinterpret_cast<char*>(weights.data()),
+            (weights.get_size() * sizeof(double)));
+}
+
+} // namespace
+
+void Tuner_Checkpoint::write(std::ostream& os) const
+{
+    write_checkpoint_value(os, TUNER_CHECKPOINT_MAGIC);
+    write_checkpoint_value(os, TUNER_CHECKPOINT_VERSION);
+    write_checkpoint_value(os, static_cast<uint64_t>(best_weights.get_size()));
+    write_checkpoint_value(os, num_of_threads);
+    write_checkpoint_value(os, memory_budget);
+
+    write_checkpoint_value(os, epoch);
+    write_checkpoint_value(os, next_mini_batch);
+    write_checkpoint_value(os, timestep);
+    write_checkpoint_value(os, weight_update_magnitude_sum);
+    write_checkpoint_value(os, previous_epoch_training_loss);
+    write_checkpoint_value(os, previous_epoch_validation_loss);
+    write_checkpoint_value(os, epoch_patience_count);
+
+    write_checkpoint_value(os, static_cast<uint64_t>(rng_state.size()));
+    os.write(rng_state.data(), rng_state.size());
+
+    write_checkpoint_weights(os, state.first_moment);
+    write_checkpoint_weights(os, state.second_moment);
+    write_checkpoint_weights(os, state.weights);
+    write_checkpoint_weights(os, best_weights);
+}
+
+Tuner_Checkpoint Tuner_Checkpoint::read(std::istream&  is,
+                                        const uint64_t num_of_threads,
+                                        const uint64_t memory_budget)
+{
+    uint64_t magic                     = 0;
+    uint32_t version                   = 0;
+    uint64_t num_of_weights            = 0;
+    uint64_t checkpoint_num_of_threads = 0;
+    uint64_t checkpoint_memory_budget  = 0;
+    read_checkpoint_value(is, magic);
+    read_checkpoint_value(is, version);
+    read_checkpoint_value(is, num_of_weights);
+    read_checkpoint_value(is, checkpoint_num_of_threads);
+    read_checkpoint_value(is, checkpoint_memory_budget);
+
+    if ((magic != TUNER_CHECKPOINT_MAGIC)
+        || (version != TUNER_CHECKPOINT_VERSION))
+    {
+        throw std::runtime_error("The file is not a tuner checkpoint of this "
+                                 "version.");
+    }
+
+    if (num_of_weights != Evaluation_Weights<double>::SIZE)
+    {
+        throw std::runtime_error(
+            "The tuner checkpoint was written for a different set of "
+            "evaluation weights.");
+    }
+
+    if (checkpoint_num_of_threads != num_of_threads)
+    {
+        throw std::runtime_error(
+            "The tuner checkpoint was written with a different number of "
+            "threads.");
+    }
+
+    if (checkpoint_memory_budget != memory_budget)
+    {
+        throw std::runtime_error(
+            "The tuner checkpoint was written with a different dataset "
+            "streaming memory budget.");
+    }
+
+    Tuner_Checkpoint checkpoint;
+    checkpoint.num_of_threads = checkpoint_num_of_threads;
+    checkpoint.memory_budget  = checkpoint_memory_budget;
+
+    read_checkpoint_value(is, checkpoint.epoch);
+    read_checkpoint_value(is, checkpoint.next_mini_batch);
+    read_checkpoint_value(is, checkpoint.timestep);
+    read_checkpoint_value(is, checkpoint.weight_update_magnitude_sum);
+    read_checkpoint_value(is, checkpoint.previous_epoch_training_loss);
+    read_checkpoint_value(is, checkpoint.previous_epoch_validation_loss);
+    read_checkpoint_value(is, checkpoint.epoch_patience_count);
+
+    uint64_t rng_state_size = 0;
+    read_checkpoint_value(is, rng_state_size);
+
+    // The size is garbage if the file ends before it.
+    if (!is) { throw std::runtime_error("The tuner checkpoint is truncated."); }
+
+    if (rng_state_size > TUNER_CHECKPOINT_MAX_RNG_STATE_SIZE)
+    {
+        throw std::runtime_error(
+            "The tuner checkpoint's random number generator state is too "
+            "large.");
+    }
+
+    checkpoint.rng_state.resize(rng_state_size);
+    is.read(checkpoint.rng_state.data(), rng_state_size);
+
+    read_checkpoint_weights(is, checkpoint.state.first_moment);
+    read_checkpoint_weights(is, checkpoint.state.second_moment);
+    read_checkpoint_weights(is, checkpoint.state.weights);
+    read_checkpoint_weights(is, checkpoint.best_weights);
+
+    if (!is) { throw std::runtime_error("The tuner checkpoint is truncated."); }
+
+    return checkpoint;
+}
+
 // In the theme of projected gradient descent, we set the gradient to a scaled
-// value if the weights minus the gradient were to cross the valid range for the
+// value if the weight minus the gradient were to cross the valid range for the
 // fixed point math we are using for static evaluation - this is to prevent the
 // algorithm from jumping back and forth between the valid range and outside the
 // valid range because of momentum.
+double Tuner::projected_gradient(const double weight,
+                                 const double gradient) const
+{
+    // If the gradient is negative, according to the traditional gradient
+    // descent weight update, we want to increase the weights - so as a
+    // conservative measure we reduce the gradient to a numerical value a scale
+    // less than what would be needed to be greater than the maximum - this
+    // allows us to keep some form of a direction/magnitude rather than
+    // aggressively diminishing it to zero.
+    constexpr double PROJECTED_GRADIENT_SCALE = 1000.0;
+    const double     weight_with_step         = weight - gradient;
+    if (weight_with_step > Matrex_FP_Int::safe_maximum())
+    {
+        const double distance_from_boundary =
+            std::abs(weight - Matrex_FP_Int::safe_maximum());
+        return std::copysign(distance_from_boundary, gradient)
+             / PROJECTED_GRADIENT_SCALE;
+    }
+    // Simalaur logic as the maximum clamp.
+    else if (weight_with_step < Matrex_FP_Int::safe_minimum())
+    {
+        const double distance_from_boundary =
+            std::abs(weight - Matrex_FP_Int::safe_minimum());
+        return std::copysign(distance_from_boundary, gradient)
+             / PROJECTED_GRADIENT_SCALE;
+    }
+
+    return gradient;
+}
+
 Evaluation_Weights<double>
 Tuner::projected_gradient(const Evaluation_Weights<double>& weights,
                           const Evaluation_Weights<double>& gradient) const
@@ -297,41 +909,23 @@ Tuner::projected_gradient(const Evaluation_Weights<double>& weights,
 
     for (std::size_t i = 0; i < weights.get_size(); ++i)
     {
-        // If the gradient is negative, according to the traditional gradient
-        // descent weight update, we want to increase the weights - so as a
-        // conservative measure we reduce the gradient to a numerical value a
-        // scale less than what would be needed to be greater than the maximum -
-        // this allows us to keep some form of a direction/magnitude rather than
-        // aggressively diminishing it to zero.
-        constexpr double PROJECTED_GRADIENT_SCALE = 1000.0;
-        const double     weights_with_step        = weights[i] - gradient[i];
-        if (weights_with_step > Matrex_FP_Int::safe_maximum())
-        {
-            double distance_from_boundary =
-                std::abs(weights[i] - Matrex_FP_Int::safe_maximum());
-            result[i] = std::copysign(distance_from_boundary, gradient[i])
-                      / PROJECTED_GRADIENT_SCALE;
-        }
-        // Simalaur logic as the maximum clamp.
-        else if (weights_with_step < Matrex_FP_Int::safe_minimum())
-        {
-            double distance_from_boundary =
-                std::abs(weights[i] - Matrex_FP_Int::safe_minimum());
-            result[i] = std::copysign(distance_from_boundary, gradient[i])
-                      / PROJECTED_GRADIENT_SCALE;
-        }
-        else
-        {
-            result[i] = gradient[i];
-        }
+        result[i] = projected_gradient(weights[i], gradient[i]);
     }
 
     return result;
 }
 
 // Here we are using a concept from projected gradient descent where we project
-// the weights back into a valid range for the fixed point math we are using for
+// the weight back into a valid range for the fixed point math we are using for
 // static evaluation.
+double Tuner::projected_weight_change(const double weight,
+                                      const double weight_update) const
+{
+    return std::clamp((weight - weight_update),
+                      Matrex_FP_Int::safe_minimum(),
+                      Matrex_FP_Int::safe_maximum());
+}
+
 Evaluation_Weights<double> Tuner::projected_weight_change(
     const Evaluation_Weights<double>& weights,
     const Evaluation_Weights<double>& weight_update) const
@@ -340,9 +934,7 @@ Evaluation_Weights<double> Tuner::projected_weight_change(
 
     for (std::size_t i = 0; i < weights.get_size(); ++i)
     {
-        result[i] = std::clamp((weights[i] - weight_update[i]),
-                               Matrex_FP_Int::safe_minimum(),
-                               Matrex_FP_Int::safe_maximum());
+        result[i] = projected_weight_change(weights[i], weight_update[i]);
     }
 
     return result;
@@ -374,285 +966,302 @@ double Tuner::learning_rate_scheduler(const uint64_t epoch) const
     }
 }
 
-void Tuner::parse_dataset_file(std::ifstream& dataset_file,
-                               Dataset&       training_dataset,
-                               Dataset&       validation_dataset)
+namespace
 {
-    Mini_Batch aggregate_batch;
 
-    m_log << "[INFO] Starting to parse dataset file." << std::endl;
+// The first (training size - 1) positions are the training split and the rest
+// are the validation split such that, both splits must have a position.
+uint64_t training_split_size(const uint64_t num_of_positions)
+{
+    const uint64_t size =
+        static_cast<uint64_t>((1.0L - TUNER_VALIDATION_SPLIT)
+                              * static_cast<double>(num_of_positions));
 
-    std::string line;
-    while (std::getline(dataset_file, line))
+    if (size < 2)
     {
-        std::size_t last_space_pos = line.find_last_of(' ');
-        if (last_space_pos != std::string::npos)
-        {
-            std::string fen = line.substr(0, last_space_pos);
+        throw std::runtime_error(
+            "Dataset file is too small to be split into a training and a "
+            "validation dataset.");
+    }
 
-            constexpr uint8_t MAX_SCORE_STRING_LENGTH = 3;
-            double            score                   = std::stod(
-                line.substr((last_space_pos + 2),
-                            MAX_SCORE_STRING_LENGTH)); // +2 to skip space and
-                                                       // opening bracket
+    return size;
+}
 
-            // m_log << "[INFO] Parsed (FEN, score) pair: (\"" << fen << "\", "
-            // << score
-            //       << ")" << std::endl;
+} // namespace
 
-            aggregate_batch.fens.push_back(fen);
-            aggregate_batch.scores.push_back(score);
-        }
-    }
+void Tuner::parse_dataset_file(std::ifstream& dataset_file,
+                               Dataset&       training_dataset,
+                               Dataset&       validation_dataset)
+{
+    m_log << "[INFO] Starting to load binary dataset file." << std::endl;
+
+    Timer load_timer;
+
+    const std::vector<Packed_Position> positions =
+        read_binary_dataset(dataset_file);
 
-    m_log << "[INFO] Finished parsing dataset file of "
-          << aggregate_batch.fens.size() << " entries." << std::endl;
+    m_log << "[INFO] Finished loading dataset file of " << positions.size()
+          << " entries (" << (positions.size() * sizeof(Packed_Position))
+          << " bytes) in " << (load_timer.elapsed() / NANOSECONDS_IN_MILLISECOND)
+          << " ms." << std::endl;
 
-    if (aggregate_batch.fens.empty())
+    if (positions.empty())
     {
         throw std::runtime_error("Dataset file is empty.");
     }
 
-    std::size_t training_dataset_size = static_cast<std::size_t>(
-        (1.0L - TUNER_VALIDATION_SPLIT)
-        * static_cast<double>(aggregate_batch.fens.size()));
+    const std::size_t training_size = training_split_size(positions.size());
 
-    auto fens_split_it =
-        aggregate_batch.fens.begin() + (training_dataset_size - 1);
-    auto scores_split_it =
-        aggregate_batch.scores.begin() + (training_dataset_size - 1);
+    const std::span<const Packed_Position> all_positions(positions);
 
-    Mini_Batch training_aggregate_batch {
-        std::vector<std::string>(aggregate_batch.fens.begin(), fens_split_it),
-        std::vector<double>(aggregate_batch.scores.begin(), scores_split_it)};
-    Mini_Batch validation_aggregate_batch {
-        std::vector<std::string>(fens_split_it, aggregate_batch.fens.end()),
-        std::vector<double>(scores_split_it, aggregate_batch.scores.end())};
+    load_timer.start();
 
-    training_dataset   = create_mini_batches(training_aggregate_batch);
-    validation_dataset = create_mini_batches(validation_aggregate_batch);
+    training_dataset =
+        create_mini_batches(all_positions.subspan(0, (training_size - 1)));
+    validation_dataset =
+        create_mini_batches(all_positions.subspan(training_size - 1));
+
+    m_log << "[INFO] Finished extracting features of the dataset in "
+          << (load_timer.elapsed() / NANOSECONDS_IN_MILLISECOND) << " ms."
+          << std::endl;
 }
 
-Dataset Tuner::create_mini_batches(const Mini_Batch& aggregate_batch)
+// The split of a streamed dataset is the same as the split of a dataset in
+// memory, only the streams' windows are ever in memory.
+void Tuner::open_dataset_streams(std::ifstream&    dataset_file,
+                                 const std::size_t memory_budget)
 {
-    Dataset returned_dataset;
+    dataset_file.seekg(0, std::ios::end);
+    const std::streamoff file_size = dataset_file.tellg();
+    dataset_file.seekg(0, std::ios::beg);
 
-    // Now that we have the size of the entire dataset, split the aggregate
-    // batch into mini-batches of size at most TUNER_MINI_BATCH_SIZE.
-    for (std::size_t i  = 0; i < aggregate_batch.fens.size();
-         i             += TUNER_MINI_BATCH_SIZE)
+    if ((file_size % sizeof(Packed_Position)) != 0)
     {
-        Mini_Batch mini_batch;
+        throw std::runtime_error(
+            "Binary dataset size is not a multiple of the packed position "
+            "size.");
+    }
 
-        for (std::size_t j = i; (j < (i + TUNER_MINI_BATCH_SIZE)
-                                 && j < aggregate_batch.fens.size());
-             ++j)
-        {
-            mini_batch.fens.push_back(aggregate_batch.fens[j]);
-            mini_batch.scores.push_back(aggregate_batch.scores[j]);
-        }
+    const uint64_t num_of_positions = (file_size / sizeof(Packed_Position));
 
-        returned_dataset.mini_batches.push_back(mini_batch);
+    if (num_of_positions == 0)
+    {
+        throw std::runtime_error("Dataset file is empty.");
     }
 
-    returned_dataset.size = aggregate_batch.fens.size();
+    const uint64_t training_size = training_split_size(num_of_positions);
+
+    // Both streams keep their windows so, the budget is split between them.
+    // While stepping, the mini-batch and its worker splits are held and while
+    // computing a loss, a group of a mini-batch per thread is held.
+    const std::size_t stream_memory_budget = (memory_budget / 2);
+    const std::size_t num_of_mini_batches_held =
+        std::max<std::size_t>(2, m_num_of_threads);
+
+    m_training_stream =
+        std::make_unique<Mini_Batch_Stream>(dataset_file,
+                                            m_dataset_mutex,
+                                            0,
+                                            (training_size - 1),
+                                            TUNER_MINI_BATCH_SIZE,
+                                            stream_memory_budget,
+                                            num_of_mini_batches_held);
+    m_validation_stream = std::make_unique<Mini_Batch_Stream>(
+        dataset_file,
+        m_dataset_mutex,
+        (training_size - 1),
+        (num_of_positions - (training_size - 1)),
+        TUNER_MINI_BATCH_SIZE,
+        stream_memory_budget,
+        num_of_mini_batches_held);
+
+    m_log << "[INFO] Streaming dataset file of " << num_of_positions
+          << " entries (" << file_size << " bytes) with a memory budget of "
+          << memory_budget << " bytes." << std::endl;
+}
+
+// The evaluation features of every position are extracted once here, the
+// tuning loop never sets a board or generates moves.
+Dataset
+Tuner::create_mini_batches(const std::span<const Packed_Position> positions)
+{
+    Dataset returned_dataset;
+
+    // Now that we have the size of the entire dataset, split the positions
+    // into mini-batches of size at most TUNER_MINI_BATCH_SIZE.
+    for (std::size_t i = 0; i < positions.size(); i += TUNER_MINI_BATCH_SIZE)
+    {
+        returned_dataset.mini_batches.push_back(create_mini_batch(
+            positions.subspan(i,
+                              std::min<std::size_t>(TUNER_MINI_BATCH_SIZE,
+                                                    (positions.size() - i)))));
+    }
+
+    returned_dataset.size = positions.size();
 
     return returned_dataset;
 }
 
-Worker_Batches Tuner::create_worker_batches(const Mini_Batch& mini_batch)
+Mini_Batch Tuner::create_worker_batch(const Mini_Batch& mini_batch,
+                                      const std::size_t worker) const
 {
-    Worker_Batches returned_batches;
+    Mini_Batch batch;
+
+    const std::size_t mini_batch_size   = mini_batch.features.size;
+    const std::size_t worker_batch_size = mini_batch_size / m_num_of_threads;
 
-    const std::size_t mini_batch_size = mini_batch.fens.size();
-    const std::size_t worker_batch_size =
-        mini_batch_size / TUNER_NUM_OF_THREADS;
+    const std::size_t batch_start = worker_batch_size * worker;
+    const std::size_t batch_end   = (worker == (m_num_of_threads - 1))
+                                      ? mini_batch_size
+                                      : worker_batch_size * (worker + 1);
 
-    for (std::size_t i = 0; i < TUNER_NUM_OF_THREADS; ++i)
+    batch.features.reserve(batch_end - batch_start);
+    for (std::size_t j = batch_start; j < batch_end; ++j)
     {
-        Mini_Batch batch;
+        batch.features.append(mini_batch.features, j);
+    }
 
-        const std::size_t batch_start = worker_batch_size * i;
-        const std::size_t batch_end   = (i == (TUNER_NUM_OF_THREADS - 1))
-                                          ? mini_batch_size
-                                          : worker_batch_size * (i + 1);
+    batch.scores = std::vector<double>(mini_batch.scores.begin() + batch_start,
+                                       mini_batch.scores.begin() + batch_end);
 
-        batch.fens =
-            std::vector<std::string>(mini_batch.fens.begin() + batch_start,
-                                     mini_batch.fens.begin() + batch_end);
-        batch.scores =
-            std::vector<double>(mini_batch.scores.begin() + batch_start,
-                                mini_batch.scores.begin() + batch_end);
+    return batch;
+}
 
-        returned_batches.batches[i] = batch;
-    }
+AD_Compiled_Graph
+Tuner::compile_gradient_graph(const Evaluation_Batch& batch) const
+{
+    // Any position records the same graph, the weights are placeholders since
+    // the values are replaced on every replay.
+    const Evaluation_Weights<double> weights;
+
+    AD_Tape    tape;
+    const auto ad_weights = create_ad_weights(tape, weights);
+
+    const Feature_Evaluator e(ad_weights, batch, 0);
+    const AD_Value          result = e.evaluate_white_perspective();
 
-    return returned_batches;
+    m_log << "[INFO] Compiled the gradient graph into " << (result.node + 1)
+          << " nodes." << std::endl;
+
+    return AD_Compiled_Graph(tape, weights.get_size(), result.node);
 }
 
-Tuner_Eval_Params Tuner::compute_eval_params(const Mini_Batch& mini_batch) const
+Evaluation_Weights<double>
+Tuner::compute_gradient(const Evaluation_Weights<double>& weights,
+                        const Mini_Batch&                 mini_batch) const
 {
-    Tuner_Eval_Params return_value;
-    return_value.boards.reserve(mini_batch.fens.size());
-    return_value.moving_side_matrices.reserve(mini_batch.fens.size());
-    return_value.opposing_side_matrices.reserve(mini_batch.fens.size());
-
-    for (std::size_t i = 0; i < mini_batch.fens.size(); ++i)
-    {
-        Chess_Board cb;
-        cb.set_from_fen(mini_batch.fens[i]);
+    constexpr std::size_t L = AD_COMPILED_GRAPH_LANES;
 
-        const PIECE_COLOR     moving_side = cb.get_side_to_move();
-        Move_Generation_List  moving_side_moves_list;
-        Moves_Bitboard_Matrix moving_side_matrix;
-        Move_Generator        mg_moving_side(cb);
-        mg_moving_side.generate_all_moves<MOVE_GENERATION_TYPE::ALL>(
-            moving_side,
-            moving_side_moves_list,
-            moving_side_matrix);
+    const std::size_t N = mini_batch.features.size;
 
-        const PIECE_COLOR opposing_side =
-            (PIECE_COLOR) ((~cb.get_side_to_move()) & 0x1);
-        Move_Generation_List  opposing_side_moves_list;
-        Moves_Bitboard_Matrix opposing_side_matrix;
-        Move_Generator        mg_opposing_side(cb);
-        mg_opposing_side.generate_all_moves<MOVE_GENERATION_TYPE::ALL>(
-            opposing_side,
-            opposing_side_moves_list,
-            opposing_side_matrix);
+    // An empty split of a mini-batch has no gradient rather than 0/0.
+    if (N == 0) { return Evaluation_Weights<double> {}; }
 
-        return_value.boards.push_back(cb);
-        return_value.moving_side_matrices.push_back(moving_side_matrix);
-        return_value.opposing_side_matrices.push_back(opposing_side_matrix);
+    std::vector<double> variables(weights.get_size());
+    for (std::size_t i = 0; i < weights.get_size(); ++i)
+    {
+        variables[i] = weights[i];
     }
 
-    return return_value;
-}
+    AD_Replay_Buffers buffers = m_gradient_graph.create_buffers();
+    m_gradient_graph.load_variables(variables, buffers);
 
-Evaluation_Weights<double> Tuner::ad_backward_pass(AD_Tape& tape,
-                                                   AD_Value output) const
-{
-    // The partial derivative of the output scalar with respect to itself is 1.
-    output.node.get_ref().adjoint().set_value(1.0);
+    std::vector<double>    sum_of_gradients(weights.get_size(), 0.0);
+    Multi_Array<double, L> output_adjoints;
 
-    // Each tape node has to backpropagate it's adjoint to it's parent(s), this
-    // is simply done by calling the respective adjoint functors with their
-    // respective parameters.
-    for (auto& node : std::views::reverse(tape))
+    for (std::size_t start = 0; start < N; start += L)
     {
-        auto& adjoint = node.adjoint();
+        mini_batch.features.fill_replay_inputs(start, buffers);
 
-        if ((typeid(adjoint) == typeid(AD_Adjoint_Tanh))
-            || (typeid(adjoint) == typeid(AD_Adjoint_Exp))
-            || (typeid(adjoint) == typeid(AD_Adjoint_Sqrt))
-            || (typeid(adjoint) == typeid(AD_Adjoint_Pow)))
-        {
-            adjoint({node.value()});
-        }
-        else
+        m_gradient_graph.forward(buffers);
+
+        // The compiled graph evaluates from white's perspective.
+        const double* evaluations_white = m_gradient_graph.output(buffers);
+
+        for (std::size_t lane = 0; lane < L; ++lane)
         {
-            adjoint({});
+            if ((start + lane) >= N)
+            {
+                output_adjoints[lane] = 0.0;
+                continue;
+            }
+
+            const double evaluation_white  = evaluations_white[lane];
+            const double target_evaluation = mini_batch.scores[start + lane];
+            const double error = target_evaluation - sigmoid(evaluation_white);
+
+            output_adjoints[lane] = derivative_huber_loss(error)
+                                  * derivative_sigmoid(evaluation_white);
         }
+
+        m_gradient_graph.backward(buffers,
+                                  output_adjoints.data,
+                                  sum_of_gradients);
     }
 
-    // The adjoints propagated back to the weights (variables in the computation
-    // graph) form the gradient.
     Evaluation_Weights<double> gradient;
-    for (const auto& node : tape)
+    for (std::size_t i = 0; i < weights.get_size(); ++i)
     {
-        if (node.weight_index() != -1)
-        {
-            gradient[node.weight_index()] += node.adjoint().value();
-        }
+        gradient[i] = sum_of_gradients[i] / static_cast<double>(N);
     }
 
-    // After the backward pass, we can clear the tape of all nodes used to
-    // calculate this gradient.
-    tape.clear();
-
     return gradient;
 }
 
-Evaluation_Weights<double>
-Tuner::compute_gradient(const Evaluation_Weights<double>& weights,
-                        const Mini_Batch&                 mini_batch) const
+double Tuner::compute_mini_batch_loss(
+    const Mini_Batch&                 mini_batch,
+    const Evaluation_Weights<double>& weights) const
 {
-    Evaluation_Weights<double> gradient;
+    double loss = 0.0L;
 
-    std::size_t N = mini_batch.fens.size();
+    const Batch_Evaluator<double> e(weights);
+    std::vector<double>           evaluations;
 
-    Tuner_Eval_Params eval_params = compute_eval_params(mini_batch);
+    const Evaluation_Batch& batch = mini_batch.features;
 
-    AD_Tape tape;
+    e.evaluate(batch, evaluations);
 
-    for (std::size_t i = 0; i < N; ++i)
+    for (std::size_t i = 0; i < batch.size; ++i)
     {
-        // The auto-differentiation weights must be recreated every iteration
-        // because the tape is cleared after every backward pass and since we
-        // use references to nodes on the tape in AD Values - we must create new
-        // nodes to reference otherwise, referencing cleared nodes is equivalent
-        // to a dangling reference.
-        auto ad_weights = create_ad_weights(tape, weights);
-
-        Evaluator e(ad_weights,
-                    eval_params.boards[i],
-                    eval_params.moving_side_matrices[i],
-                    eval_params.opposing_side_matrices[i]);
-
         const double sign =
-            (eval_params.boards[i].get_side_to_move() == PIECE_COLOR::WHITE)
-                ? 1.0L
-                : -1.0L;
-        const auto   result = e.evaluate_template_typed();
+            (batch.side_to_move[i] == PIECE_COLOR::WHITE) ? 1.0L : -1.0L;
+        const double evaluation = evaluations[i];
         const double evaluation_white =
-            sign * result.value(); // Convert side-to-move's evaluation to
-                                   // white's perspective.
+            sign * evaluation; // Convert side-to-move's evaluation to
+                               // white's perspective.
         const double target_evaluation = mini_batch.scores[i];
-        const double error = target_evaluation - sigmoid(evaluation_white);
-        const double huber_loss_derivative = derivative_huber_loss(error);
-        const double sigmoid_derivative = derivative_sigmoid(evaluation_white);
-        const Evaluation_Weights<double> evaluation_deriative =
-            ad_backward_pass(tape, result) * sign;
-
-        gradient = gradient
-                 + (evaluation_deriative
-                    * (huber_loss_derivative * sigmoid_derivative));
+        const double error  = target_evaluation - sigmoid(evaluation_white);
+        loss               += huber_loss(error);
     }
 
-    gradient = gradient / static_cast<double>(N);
-
-    return gradient;
+    return loss;
 }
 
 double Tuner::compute_loss(const Dataset&                    d,
                            const Evaluation_Weights<double>& weights)
 {
-    double            loss = 0.0L;
-    const std::size_t N    = d.size;
+    const std::size_t N = d.size;
 
-    for (const Mini_Batch& mini_batch : d.mini_batches)
+    Tuner_Loss_Shared_Data shared_data {
+        .dataset           = d,
+        .weights           = weights,
+        .mini_batch_losses = std::vector<double>(d.mini_batches.size(), 0.0L)};
+
+    for (std::size_t i = 0; i < m_num_of_threads; ++i)
     {
-        Tuner_Eval_Params eval_params = compute_eval_params(mini_batch);
+        std::unique_ptr<Thread_Job> job =
+            std::make_unique<Tuner_Loss>(shared_data, (*this), i);
 
-        for (std::size_t i = 0; i < mini_batch.fens.size(); ++i)
-        {
-            Evaluator e(weights,
-                        eval_params.boards[i],
-                        eval_params.moving_side_matrices[i],
-                        eval_params.opposing_side_matrices[i]);
-
-            const double sign =
-                (eval_params.boards[i].get_side_to_move() == PIECE_COLOR::WHITE)
-                    ? 1.0L
-                    : -1.0L;
-            const double evaluation = e.evaluate_template_typed();
-            const double evaluation_white =
-                sign * evaluation; // Convert side-to-move's evaluation to
-                                   // white's perspective.
-            const double target_evaluation = mini_batch.scores[i];
-            const double error  = target_evaluation - sigmoid(evaluation_white);
-            loss               += huber_loss(error);
-        }
+        m_thread_pool.push_job(std::move(job));
+    }
+
+    m_thread_pool.wait_for_jobs_to_complete();
+
+    // Reduce in mini-batch order such that the loss is deterministic.
+    double loss = 0.0L;
+    for (const double mini_batch_loss : shared_data.mini_batch_losses)
+    {
+        loss += mini_batch_loss;
     }
 
     loss = loss / static_cast<double>(N);
@@ -660,6 +1269,48 @@ double Tuner::compute_loss(const Dataset&                    d,
     return loss;
 }
 
+double Tuner::compute_loss(Mini_Batch_Stream&                stream,
+                           const Evaluation_Weights<double>& weights)
+{
+    stream.start_pass(false, 0);
+
+    // The losses of the groups are summed in stream order such that the loss
+    // is deterministic.
+    double     loss = 0.0L;
+    Mini_Batch mini_batch;
+    bool       has_mini_batch = stream.next(mini_batch);
+
+    while (has_mini_batch)
+    {
+        Dataset group {.mini_batches = {}, .size = 0};
+        while (has_mini_batch && (group.mini_batches.size() < m_num_of_threads))
+        {
+            group.size += mini_batch.features.size;
+            group.mini_batches.push_back(std::move(mini_batch));
+
+            has_mini_batch = stream.next(mini_batch);
+        }
+
+        const double group_loss = compute_loss(group, weights);
+        loss += (group_loss * static_cast<double>(group.size));
+    }
+
+    return loss / static_cast<double>(stream.get_num_of_positions());
+}
+
+double Tuner::compute_training_loss(const Evaluation_Weights<double>& weights)
+{
+    return is_streaming() ? compute_loss(*m_training_stream, weights)
+                          : compute_loss(m_training_dataset, weights);
+}
+
+double
+Tuner::compute_validation_loss(const Evaluation_Weights<double>& weights)
+{
+    return is_streaming() ? compute_loss(*m_validation_stream, weights)
+                          : compute_loss(m_validation_dataset, weights);
+}
+
 double Tuner::compute_max_data_loss(const Dataset& d)
 {
     std::size_t num_of_decisive_games = 0;
@@ -667,24 +1318,51 @@ double Tuner::compute_max_data_loss(const Dataset& d)
 
     for (const Mini_Batch& mini_batch : d.mini_batches)
     {
-        for (std::size_t i = 0; i < mini_batch.fens.size(); ++i)
+        count_results(mini_batch, num_of_decisive_games, num_of_draws);
+    }
+
+    return max_data_loss(num_of_decisive_games, num_of_draws);
+}
+
+double Tuner::compute_max_data_loss(Mini_Batch_Stream& stream)
+{
+    std::size_t num_of_decisive_games = 0;
+    std::size_t num_of_draws          = 0;
+
+    stream.start_pass(false, 0);
+
+    Mini_Batch mini_batch;
+    while (stream.next(mini_batch))
+    {
+        count_results(mini_batch, num_of_decisive_games, num_of_draws);
+    }
+
+    return max_data_loss(num_of_decisive_games, num_of_draws);
+}
+
+void Tuner::count_results(const Mini_Batch& mini_batch,
+                          std::size_t&      num_of_decisive_games,
+                          std::size_t&      num_of_draws) const
+{
+    for (std::size_t i = 0; i < mini_batch.scores.size(); ++i)
+    {
+        if (mini_batch.scores[i] != 0.5L) { ++num_of_decisive_games; }
+        else
         {
-            if (mini_batch.scores[i] != 0.5L) { ++num_of_decisive_games; }
-            else
-            {
-                ++num_of_draws;
-            }
+            ++num_of_draws;
         }
     }
+}
 
+double Tuner::max_data_loss(const std::size_t num_of_decisive_games,
+                            const std::size_t num_of_draws) const
+{
     const double loss_on_decisive = huber_loss(1.0L);
     const double loss_on_draw     = huber_loss(0.5L);
 
-    const double max_data_loss = ((num_of_decisive_games * loss_on_decisive)
-                                  + (num_of_draws * loss_on_draw))
-                               / static_cast<double>(d.size);
-
-    return max_data_loss;
+    return ((num_of_decisive_games * loss_on_decisive)
+            + (num_of_draws * loss_on_draw))
+         / static_cast<double>(num_of_decisive_games + num_of_draws);
 }
 
 void Tuner::print_element_as_cpp(std::ofstream& ofs, const double scalar)
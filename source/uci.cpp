@@ -1,9 +1,12 @@
 #include "uci.hpp"
 
+#include <charconv>
 #include <iostream>
 #include <sstream>
 
 #include "move_generator.hpp"
+#include "nnue.hpp"
+#include "thread_affinity.hpp"
 
 UCI::UCI() : m_is_frc(false) {}
 
@@ -11,33 +14,35 @@ void UCI::loop()
 {
     std::string line;
 
-    while (std::getline(std::cin, line))
-    {
-        const std::size_t first_space_idx = line.find_first_of(" ");
+    while (std::getline(std::cin, line)) { handle_command(line); }
+}
 
-        std::string command;
-        std::string arguments;
+void UCI::handle_command(const std::string& line)
+{
+    const std::size_t first_space_idx = line.find_first_of(" ");
 
-        if (first_space_idx == std::string::npos) { command = line; }
-        else
-        {
-            command   = line.substr(0, first_space_idx);
-            arguments = line.substr((first_space_idx + 1));
-        }
+    std::string command;
+    std::string arguments;
+
+    if (first_space_idx == std::string::npos) { command = line; }
+    else
+    {
+        command   = line.substr(0, first_space_idx);
+        arguments = line.substr((first_space_idx + 1));
+    }
 
 #define HANDLE_COMMAND(c)                                                      \
     if (command == #c) { handle_##c(arguments); }
 
-        HANDLE_COMMAND(position)
-        HANDLE_COMMAND(go)
-        HANDLE_COMMAND(quit)
-        HANDLE_COMMAND(uci)
-        HANDLE_COMMAND(ucinewgame)
-        HANDLE_COMMAND(isready)
-        HANDLE_COMMAND(setoption)
+    HANDLE_COMMAND(position)
+    HANDLE_COMMAND(go)
+    HANDLE_COMMAND(quit)
+    HANDLE_COMMAND(uci)
+    HANDLE_COMMAND(ucinewgame)
+    HANDLE_COMMAND(isready)
+    HANDLE_COMMAND(setoption)
 
 #undef HANDLE_COMMAND
-    }
 }
 
 void UCI::handle_position(const std::string& arguments)
@@ -182,6 +187,21 @@ void UCI::handle_uci(const std::string&)
     std::cout << "option name Hash type spin default "
               << DEFAULT_TRANSPOSITION_TABLE_SIZE << " min 1 max 1024"
               << std::endl;
+    std::cout << "option name EvalFile type string default <empty>"
+              << std::endl;
+    std::cout << "option name UseNNUE type check default false" << std::endl;
+    std::cout << "option name PinSearchThread type check default false"
+              << std::endl;
+
+    for (const Search_Parameter_Definition& definition :
+         SEARCH_PARAMETER_DEFINITIONS)
+    {
+        std::cout << "option name " << definition.name
+                  << " type spin default " << definition.default_value
+                  << " min " << definition.min << " max " << definition.max
+                  << std::endl;
+    }
+
     std::cout << "uciok" << std::endl;
 }
 
@@ -217,6 +237,98 @@ void UCI::handle_setoption(const std::string& arguments)
                 m_search_constraints.transposition_table_size =
                     std::stoull(tokens->at(current_index));
             }
+            else if (option_name == "EvalFile")
+            {
+                current_index += 2; // Skip "EvalFile" and "value"
+
+                if (current_index >= tokens->size())
+                {
+                    std::cout << "info string missing value for option "
+                              << option_name << std::endl;
+                    break;
+                }
+
+                // The path is the remainder of the command since, it may
+                // contain spaces.
+                std::string path = tokens->at(current_index);
+                while ((current_index + 1) < tokens->size())
+                {
+                    path += " " + tokens->at(++current_index);
+                }
+
+                if (NNUE::load(path))
+                {
+                    m_chess_board.refresh_nnue_accumulator();
+                }
+                else
+                {
+                    std::cout << "info string failed to load network " << path
+                              << std::endl;
+                }
+            }
+            else if (option_name == "UseNNUE")
+            {
+                current_index += 2; // Skip "UseNNUE" and "value"
+
+                m_search_constraints.use_nnue_evaluation =
+                    (tokens->at(current_index) == "true");
+            }
+            else if (option_name == "PinSearchThread")
+            {
+                current_index += 2; // Skip "PinSearchThread" and "value"
+
+                // The search runs on this thread, it is pinned to the CPU it is
+                // currently on such that, the scheduler can't migrate it. Its
+                // tables are not moved so, they stay wherever they were first
+                // touched.
+                bool is_affinity_set = false;
+                if (tokens->at(current_index) == "true")
+                {
+                    const std::optional<uint32_t> cpu = current_cpu();
+                    is_affinity_set = cpu.has_value()
+                                   && pin_current_thread_to_cpu(cpu.value());
+                }
+                else
+                {
+                    is_affinity_set = unpin_current_thread();
+                }
+
+                if (!is_affinity_set)
+                {
+                    std::cout << "info string failed to set the affinity of "
+                                 "the search thread"
+                              << std::endl;
+                }
+            }
+            else if (Search_Parameters::contains(option_name))
+            {
+                current_index += 2; // Skip the option's name and "value"
+
+                // The remaining options are the tunable search parameters.
+                if (current_index >= tokens->size())
+                {
+                    std::cout << "info string missing value for option "
+                              << option_name << std::endl;
+                    break;
+                }
+
+                const std::string& value_str = tokens->at(current_index);
+                const char* value_end = (value_str.data() + value_str.size());
+
+                int32_t                      value = 0;
+                const std::from_chars_result result =
+                    std::from_chars(value_str.data(), value_end, value);
+
+                if ((result.ec != std::errc()) || (result.ptr != value_end))
+                {
+                    std::cout << "info string invalid value " << value_str
+                              << " for option " << option_name << std::endl;
+                }
+                else
+                {
+                    m_search_constraints.parameters.set(option_name, value);
+                }
+            }
         }
 
         ++current_index;
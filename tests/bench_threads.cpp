@@ -0,0 +1,92 @@
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "threads.hpp"
+#include "timer.hpp"
+
+// Benchmarks of the thread pool. They report the latency of a single job and
+// the throughput of many small jobs, the expectations only check that every job
+// ran. They are disabled such that, they only run when asked for with
+// --gtest_also_run_disabled_tests --gtest_filter=thread_pool_benchmarks.*
+
+constexpr std::size_t BENCH_THREAD_COUNT       = 4;
+constexpr std::size_t BENCH_LATENCY_ITERATIONS = 1000;
+constexpr std::size_t BENCH_THROUGHPUT_JOBS    = 100000;
+
+class Thread_Count_Job : public Thread_Job
+{
+  public:
+
+    explicit Thread_Count_Job(Threads_Shared_Data& shared_data) :
+        Thread_Job(shared_data)
+    {
+    }
+
+    virtual bool has_job() const override { return true; }
+
+    virtual std::any operator()(std::stop_token) override
+    {
+        read_shared_data<std::atomic<uint64_t>>(m_index_to_count).get()++;
+
+        return true;
+    }
+
+  private:
+
+    constexpr static std::size_t m_index_to_count = 0;
+};
+
+TEST(thread_pool_benchmarks, DISABLED_job_latency)
+{
+    std::atomic<uint64_t> count {0};
+    Threads_Shared_Data   shared_data(count);
+
+    Thread_Pool pool(BENCH_THREAD_COUNT);
+
+    // Every iteration measures the round trip of a single job from the push to
+    // the wait returning, the workers are parked in between.
+    Timer    timer;
+    uint64_t total_nanoseconds = 0;
+    for (std::size_t i = 0; i < BENCH_LATENCY_ITERATIONS; ++i)
+    {
+        timer.start();
+
+        pool.push_job(std::make_unique<Thread_Count_Job>(shared_data));
+        pool.wait_for_jobs_to_complete();
+
+        total_nanoseconds += timer.elapsed();
+    }
+
+    std::cout << "Average job latency: "
+              << (total_nanoseconds / BENCH_LATENCY_ITERATIONS) << " ns"
+              << std::endl;
+
+    EXPECT_EQ(count.load(), BENCH_LATENCY_ITERATIONS);
+}
+
+TEST(thread_pool_benchmarks, DISABLED_job_throughput)
+{
+    std::atomic<uint64_t> count {0};
+    Threads_Shared_Data   shared_data(count);
+
+    Thread_Pool pool(BENCH_THREAD_COUNT);
+
+    Timer timer;
+
+    for (std::size_t i = 0; i < BENCH_THROUGHPUT_JOBS; ++i)
+    {
+        pool.push_job(std::make_unique<Thread_Count_Job>(shared_data));
+    }
+    pool.wait_for_jobs_to_complete();
+
+    const double seconds =
+        static_cast<double>(timer.elapsed()) / NANOSECONDS_IN_SECOND;
+
+    std::cout << "Job throughput: "
+              << (static_cast<double>(BENCH_THROUGHPUT_JOBS) / seconds)
+              << " jobs/second" << std::endl;
+
+    EXPECT_EQ(count.load(), BENCH_THROUGHPUT_JOBS);
+}
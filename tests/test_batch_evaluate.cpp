@@ -0,0 +1,79 @@
+#include <cmath>
+
+#include "batch_evaluate.hpp"
+#include "evaluation_terms.hpp"
+#include "gtest/gtest.h"
+#include "move_generator.hpp"
+
+TEST(batch_evaluate, matches_evaluator)
+{
+    constexpr std::string_view FENS[] = {
+        START_POSITION_FEN,
+        "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "4k3/8/8/8/8/8/8/4K2R b K - 0 1"};
+
+    Evaluation_Weights<double> weights;
+    for (std::size_t i = 0; i < weights.get_size(); ++i)
+    {
+        weights[i] = TUNED_EVALUATION_WEIGHTS[i].to_double();
+    }
+
+    Evaluation_Batch    batch;
+    std::vector<double> expected_scores;
+
+    Chess_Board cb;
+    for (const std::string_view fen : FENS)
+    {
+        cb.set_from_fen(std::string(fen));
+
+        const PIECE_COLOR moving_side = cb.get_side_to_move();
+
+        Move_Generation_List  moving_side_moves_list;
+        Moves_Bitboard_Matrix moving_side_matrix;
+        Move_Generator        mg_moving_side(cb);
+        mg_moving_side.generate_all_moves<MOVE_GENERATION_TYPE::ALL>(
+            moving_side,
+            moving_side_moves_list,
+            moving_side_matrix);
+
+        Move_Generation_List  opposing_side_moves_list;
+        Moves_Bitboard_Matrix opposing_side_matrix;
+        Move_Generator        mg_opposing_side(cb);
+        mg_opposing_side.generate_all_moves<MOVE_GENERATION_TYPE::ALL>(
+            ~moving_side,
+            opposing_side_moves_list,
+            opposing_side_matrix);
+
+        const Evaluator<double> e(weights,
+                                  cb,
+                                  moving_side_matrix,
+                                  opposing_side_matrix);
+        expected_scores.push_back(e.evaluate_template_typed());
+
+        batch.append(cb, moving_side_matrix, opposing_side_matrix);
+    }
+
+    std::vector<double>           scores;
+    const Batch_Evaluator<double> batch_evaluator(weights);
+    batch_evaluator.evaluate(batch, scores);
+
+    ASSERT_EQ(batch.size, std::size(FENS));
+    ASSERT_EQ(scores.size(), std::size(FENS));
+
+    // The evaluators only differ in the order of the floating point additions.
+    for (std::size_t i = 0; i < batch.size; ++i)
+    {
+        const double tolerance =
+            (1e-9 * std::max(1.0, std::abs(expected_scores[i])));
+
+        EXPECT_NEAR(scores[i], expected_scores[i], tolerance) << FENS[i];
+
+        const Feature_Evaluator<double> feature_evaluator(weights, batch, i);
+        EXPECT_NEAR(feature_evaluator.evaluate_template_typed(),
+                    expected_scores[i],
+                    tolerance)
+            << FENS[i];
+    }
+}
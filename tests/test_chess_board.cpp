@@ -29,3 +29,51 @@ TEST(chess_board_tests, to_fen)
     position.set_from_fen(test_fen);
     ASSERT_EQ(test_fen, position.to_fen());
 }
+
+TEST(chess_board_tests, packed_position)
+{
+    const std::vector<std::string> test_fens = {
+        std::string(START_POSITION_FEN),
+        "rnbqk2r/p1p1bp1p/3ppnp1/1B6/Pp1NPBQ1/1P1PN3/2P2PPP/R4RK1 b kq a3 0 1",
+        "3r1rk1/ppp2pbp/1qn2np1/3pp1B1/3PP1b1/Q1N2NP1/PPP2PBP/3R1RK1 w - - 0 1",
+        "r1b2rk1/3p1ppp/2nbpn2/pp2N3/1qpP1B1Q/5NP1/PPP1PPBP/R4RK1 b - d3 7 23"};
+
+    for (const std::string& test_fen : test_fens)
+    {
+        Chess_Board position;
+        position.set_from_fen(test_fen);
+
+        Chess_Board unpacked_position;
+        unpacked_position.set_from_packed_position(
+            position.to_packed_position());
+
+        ASSERT_EQ(test_fen, unpacked_position.to_fen());
+        ASSERT_EQ(position.get_zobrist_hash(),
+                  unpacked_position.get_zobrist_hash());
+    }
+}
+
+TEST(chess_board_tests, null_move)
+{
+    const std::string test_fen =
+        "r1b2rk1/3p1ppp/2nbpn2/pp2N3/1qpP1B1Q/5NP1/PPP1PPBP/R4RK1 b - d3 7 23";
+    const std::string null_move_fen =
+        "r1b2rk1/3p1ppp/2nbpn2/pp2N3/1qpP1B1Q/5NP1/PPP1PPBP/R4RK1 w - - 8 24";
+
+    Chess_Board position;
+    position.set_from_fen(test_fen);
+    const Zobrist_Hash z_hash = position.get_zobrist_hash();
+
+    Chess_Board expected_position;
+    expected_position.set_from_fen(null_move_fen);
+
+    // The null move passes the turn and clears the en passant square.
+    const Undo_Chess_Move undo_move = position.make_null_move();
+    ASSERT_EQ(null_move_fen, position.to_fen());
+    ASSERT_EQ(expected_position.get_zobrist_hash(),
+              position.get_zobrist_hash());
+
+    position.undo_null_move(undo_move);
+    ASSERT_EQ(test_fen, position.to_fen());
+    ASSERT_EQ(z_hash, position.get_zobrist_hash());
+}
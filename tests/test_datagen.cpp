@@ -0,0 +1,63 @@
+#include <sstream>
+
+#include "datagen.hpp"
+#include "gtest/gtest.h"
+
+TEST(datagen, self_play_game)
+{
+    Datagen_Options options;
+    options.depth          = 2;
+    options.max_game_plies = 16;
+
+    std::unique_ptr<Search_Engine> engine = std::make_unique<Search_Engine>();
+    Psuedo_RNG<uint64_t>           rng;
+
+    std::vector<Packed_Position> game_positions;
+    play_self_play_game((*engine), rng, options, game_positions);
+
+    ASSERT_FALSE(game_positions.empty());
+    EXPECT_LE(game_positions.size(), options.max_game_plies);
+
+    // Every position of a game carries the game's result.
+    for (const Packed_Position& packed : game_positions)
+    {
+        EXPECT_EQ(packed.result, game_positions[0].result);
+    }
+
+    // The randomized opening is played before the first recorded position.
+    EXPECT_GT(game_positions[0].full_move_count,
+              (DATAGEN_NUM_OF_RANDOM_OPENING_PLIES / NUM_OF_PLAYERS));
+}
+
+TEST(datagen, generate)
+{
+    Datagen_Options options;
+    options.num_of_threads = 2;
+    options.num_of_games   = 4;
+    options.depth          = 2;
+    options.max_game_plies = 8;
+
+    std::ostringstream log;
+    std::stringstream  output;
+
+    Datagen        datagen(log, output, options);
+    const uint64_t num_of_positions = datagen.generate();
+
+    const std::vector<Packed_Position> positions = read_binary_dataset(output);
+
+    EXPECT_GT(num_of_positions, 0);
+    EXPECT_EQ(positions.size(), num_of_positions);
+    EXPECT_LE(num_of_positions,
+              (options.num_of_games * options.max_game_plies));
+}
+
+TEST(datagen, invalid_options)
+{
+    std::ostringstream log;
+    std::stringstream  output;
+
+    Datagen_Options options;
+    options.depth = 0;
+
+    EXPECT_THROW(Datagen(log, output, options), std::invalid_argument);
+}
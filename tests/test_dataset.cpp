@@ -0,0 +1,33 @@
+#include <cstring>
+#include <sstream>
+
+#include "dataset.hpp"
+#include "gtest/gtest.h"
+
+TEST(dataset, read_binary_dataset)
+{
+    Chess_Board cb;
+    cb.set_from_fen(std::string(START_POSITION_FEN));
+    const Packed_Position packed = cb.to_packed_position();
+
+    std::string bytes;
+    for (int i = 0; i < 2; ++i)
+    {
+        bytes.append(reinterpret_cast<const char*>(&packed),
+                     sizeof(Packed_Position));
+    }
+
+    {
+        std::istringstream                 is(bytes);
+        const std::vector<Packed_Position> positions = read_binary_dataset(is);
+        ASSERT_EQ(positions.size(), 2);
+        EXPECT_EQ(std::memcmp(&positions[1], &packed, sizeof(Packed_Position)),
+                  0);
+    }
+
+    // A partial trailing record.
+    {
+        std::istringstream is(bytes.substr(0, (bytes.size() - 1)));
+        EXPECT_THROW(read_binary_dataset(is), std::runtime_error);
+    }
+}
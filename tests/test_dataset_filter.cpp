@@ -0,0 +1,50 @@
+#include <sstream>
+
+#include "dataset_filter.hpp"
+#include "gtest/gtest.h"
+
+TEST(dataset_filter, filter)
+{
+    constexpr std::string_view FENS[] = {
+        START_POSITION_FEN,
+        START_POSITION_FEN,                  // Duplicate.
+        "4k3/4R3/8/8/8/8/8/4K3 b - - 0 1",   // In check.
+        "4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1", // Hanging queen, not quiet.
+        "4k3/8/8/8/8/8/8/4K3 w - - 0 1"};
+
+    std::stringstream input;
+    Chess_Board       cb;
+    for (const std::string_view fen : FENS)
+    {
+        cb.set_from_fen(std::string(fen));
+        const Packed_Position packed = cb.to_packed_position();
+        input.write(reinterpret_cast<const char*>(&packed),
+                    sizeof(Packed_Position));
+    }
+
+    Dataset_Filter_Options options;
+    options.num_of_threads   = 2;
+    options.bucket_directory = (std::filesystem::temp_directory_path()
+                                / "matrex_test_dataset_filter");
+    std::filesystem::create_directories(options.bucket_directory);
+
+    std::ostringstream log;
+    std::stringstream  output;
+
+    Dataset_Filter                  dataset_filter(log, options);
+    const Dataset_Filter_Statistics statistics =
+        dataset_filter.filter(input, output);
+
+    EXPECT_EQ(statistics.num_of_positions_read, 5);
+    EXPECT_EQ(statistics.num_of_duplicates, 1);
+    EXPECT_EQ(statistics.num_of_positions_in_check, 1);
+    EXPECT_EQ(statistics.num_of_non_quiet_positions, 1);
+    EXPECT_EQ(statistics.num_of_positions_written, 2);
+
+    const std::vector<Packed_Position> positions = read_binary_dataset(output);
+    EXPECT_EQ(positions.size(), 2);
+
+    // The run's bucket files and their directory are removed.
+    EXPECT_TRUE(std::filesystem::is_empty(options.bucket_directory));
+    std::filesystem::remove(options.bucket_directory);
+}
@@ -0,0 +1,126 @@
+#include "gtest/gtest.h"
+#include "history.hpp"
+
+namespace
+{
+
+Chess_Move create_move(const PIECES  moving_piece,
+                       const ESQUARE source_square,
+                       const ESQUARE destination_square)
+{
+    return Chess_Move {.source_square      = source_square,
+                       .destination_square = destination_square,
+                       .moving_piece       = moving_piece};
+}
+
+} // namespace
+
+TEST(history, killer_moves)
+{
+    const Chess_Move first  = create_move(KNIGHT, ESQUARE::G1, ESQUARE::F3);
+    const Chess_Move second = create_move(PAWN, ESQUARE::E2, ESQUARE::E4);
+    const Chess_Move third  = create_move(BISHOP, ESQUARE::F1, ESQUARE::C4);
+
+    Killer_Moves killer_moves;
+    EXPECT_EQ(killer_moves.find(first), NUM_OF_KILLER_MOVES);
+
+    // The newest killer is in the first slot.
+    killer_moves.update(first);
+    killer_moves.update(second);
+    EXPECT_EQ(killer_moves.find(second), 0);
+    EXPECT_EQ(killer_moves.find(first), 1);
+
+    // The newest killer again doesn't push out the other killer.
+    killer_moves.update(second);
+    EXPECT_EQ(killer_moves.find(second), 0);
+    EXPECT_EQ(killer_moves.find(first), 1);
+
+    // The oldest killer is pushed out.
+    killer_moves.update(third);
+    EXPECT_EQ(killer_moves.find(third), 0);
+    EXPECT_EQ(killer_moves.find(second), 1);
+    EXPECT_EQ(killer_moves.find(first), NUM_OF_KILLER_MOVES);
+
+    killer_moves.clear();
+    EXPECT_EQ(killer_moves.find(third), NUM_OF_KILLER_MOVES);
+    EXPECT_EQ(killer_moves.find(second), NUM_OF_KILLER_MOVES);
+}
+
+TEST(history, counter_moves)
+{
+    const Chess_Move previous_move =
+        create_move(PAWN, ESQUARE::E7, ESQUARE::E5);
+    const Chess_Move counter_move =
+        create_move(KNIGHT, ESQUARE::G1, ESQUARE::F3);
+
+    Counter_Move_Table counter_move_table;
+    EXPECT_TRUE(counter_move_table.get(WHITE, previous_move)
+                    .is_same_move(Chess_Move()));
+
+    counter_move_table.get(WHITE, previous_move) = counter_move;
+    EXPECT_TRUE(counter_move_table.get(WHITE, previous_move)
+                    .is_same_move(counter_move));
+
+    // Indexed by the previous move's moving piece and destination square only.
+    const Chess_Move same_destination =
+        create_move(PAWN, ESQUARE::E6, ESQUARE::E5);
+    EXPECT_TRUE(counter_move_table.get(WHITE, same_destination)
+                    .is_same_move(counter_move));
+
+    EXPECT_TRUE(counter_move_table.get(BLACK, previous_move)
+                    .is_same_move(Chess_Move()));
+    const Chess_Move other_piece =
+        create_move(KNIGHT, ESQUARE::F7, ESQUARE::E5);
+    EXPECT_TRUE(counter_move_table.get(WHITE, other_piece)
+                    .is_same_move(Chess_Move()));
+
+    counter_move_table.clear();
+    EXPECT_TRUE(counter_move_table.get(WHITE, previous_move)
+                    .is_same_move(Chess_Move()));
+}
+
+TEST(history, butterfly_history)
+{
+    const Chess_Move move = create_move(KNIGHT, ESQUARE::G1, ESQUARE::F3);
+
+    Butterfly_History_Table butterfly_history;
+    EXPECT_EQ(butterfly_history.get(WHITE, move), 0);
+
+    // The bonus is clamped before gravity is applied.
+    butterfly_history.gravity_update<false>(WHITE, move, 100);
+    EXPECT_EQ(butterfly_history.get(WHITE, move), 100);
+    butterfly_history.gravity_update<false>(WHITE,
+                                            move,
+                                            (MAX_QUIET_HISTORY_BONUS * 4));
+    EXPECT_LE(butterfly_history.get(WHITE, move),
+              (100 + MAX_QUIET_HISTORY_BONUS));
+    EXPECT_GT(butterfly_history.get(WHITE, move), 100);
+
+    // Indexed by the side to move and the source and destination squares.
+    const Chess_Move other_piece =
+        create_move(BISHOP, ESQUARE::G1, ESQUARE::F3);
+    const Chess_Move other_destination =
+        create_move(KNIGHT, ESQUARE::G1, ESQUARE::H3);
+    EXPECT_EQ(butterfly_history.get(BLACK, move), 0);
+    EXPECT_EQ(butterfly_history.get(WHITE, other_piece),
+              butterfly_history.get(WHITE, move));
+    EXPECT_EQ(butterfly_history.get(WHITE, other_destination), 0);
+
+    // A malus is a penalty.
+    const History_Score_Storage_Type score = butterfly_history.get(WHITE, move);
+    butterfly_history.gravity_update<true>(WHITE, move, 50);
+    EXPECT_LT(butterfly_history.get(WHITE, move), score);
+
+    // Gravity saturates the entry such that, it never leaves the history range.
+    for (std::size_t i = 0; i < 100000; ++i)
+    {
+        butterfly_history.gravity_update<false>(WHITE,
+                                                move,
+                                                MAX_QUIET_HISTORY_BONUS);
+    }
+    EXPECT_GT(butterfly_history.get(WHITE, move), 0);
+    EXPECT_LE(butterfly_history.get(WHITE, move), MAX_HISTORY);
+
+    butterfly_history.clear();
+    EXPECT_EQ(butterfly_history.get(WHITE, move), 0);
+}
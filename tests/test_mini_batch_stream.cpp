@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "mini_batch_stream.hpp"
+
+namespace
+{
+
+constexpr std::size_t NUM_OF_POSITIONS = 10;
+constexpr std::size_t MINI_BATCH_SIZE  = 3;
+
+// The features of the held and the prefetched mini-batch.
+constexpr std::size_t FEATURES_SIZE =
+    (2 * MINI_BATCH_SIZE * MINI_BATCH_BYTES_PER_POSITION);
+
+// Two mini-batches per window such that, the positions span several windows
+// and the last window and mini-batch are partial.
+constexpr std::size_t MEMORY_BUDGET =
+    (FEATURES_SIZE + (2 * MINI_BATCH_SIZE * sizeof(Packed_Position)));
+
+uint8_t create_result(const std::size_t position)
+{
+    return static_cast<uint8_t>(position % (PACKED_RESULT::PACKED_WIN + 1));
+}
+
+std::stringstream create_dataset()
+{
+    std::stringstream dataset;
+    Chess_Board       cb;
+    cb.set_from_fen(std::string(START_POSITION_FEN));
+
+    for (std::size_t i = 0; i < NUM_OF_POSITIONS; ++i)
+    {
+        Packed_Position packed = cb.to_packed_position();
+        packed.result          = create_result(i);
+        dataset.write(reinterpret_cast<const char*>(&packed),
+                      sizeof(Packed_Position));
+    }
+
+    return dataset;
+}
+
+std::vector<double> read_pass(Mini_Batch_Stream& stream,
+                              std::size_t&       num_of_mini_batches)
+{
+    std::vector<double> scores;
+    Mini_Batch          mini_batch;
+
+    num_of_mini_batches = 0;
+    while (stream.next(mini_batch))
+    {
+        EXPECT_LE(mini_batch.features.size, MINI_BATCH_SIZE);
+        EXPECT_EQ(mini_batch.features.size, mini_batch.scores.size());
+
+        scores.insert(scores.end(),
+                      mini_batch.scores.begin(),
+                      mini_batch.scores.end());
+        ++num_of_mini_batches;
+    }
+
+    return scores;
+}
+
+} // namespace
+
+TEST(mini_batch_stream, ordered_pass)
+{
+    std::stringstream dataset = create_dataset();
+    std::mutex        dataset_mutex;
+
+    Mini_Batch_Stream stream(dataset,
+                             dataset_mutex,
+                             0,
+                             NUM_OF_POSITIONS,
+                             MINI_BATCH_SIZE,
+                             MEMORY_BUDGET);
+
+    EXPECT_EQ(stream.get_num_of_mini_batches(), 4);
+
+    std::size_t               num_of_mini_batches = 0;
+    const std::vector<double> scores = read_pass(stream, num_of_mini_batches);
+
+    EXPECT_EQ(num_of_mini_batches, 4);
+    ASSERT_EQ(scores.size(), NUM_OF_POSITIONS);
+
+    // Without a shuffle the positions are streamed in file order.
+    for (std::size_t i = 0; i < NUM_OF_POSITIONS; ++i)
+    {
+        Packed_Position packed {};
+        packed.result = create_result(i);
+        EXPECT_EQ(scores[i], packed_result_to_score(packed));
+    }
+}
+
+TEST(mini_batch_stream, shuffled_pass)
+{
+    std::stringstream dataset = create_dataset();
+    std::mutex        dataset_mutex;
+
+    Mini_Batch_Stream stream(dataset,
+                             dataset_mutex,
+                             0,
+                             NUM_OF_POSITIONS,
+                             MINI_BATCH_SIZE,
+                             MEMORY_BUDGET);
+
+    std::size_t num_of_mini_batches = 0;
+
+    const std::vector<double> ordered_scores =
+        read_pass(stream, num_of_mini_batches);
+
+    constexpr uint64_t SEED = 12345;
+
+    stream.start_pass(true, SEED);
+    const std::vector<double> shuffled_scores =
+        read_pass(stream, num_of_mini_batches);
+
+    // A shuffled pass visits every position exactly once.
+    std::vector<double> sorted_ordered_scores  = ordered_scores;
+    std::vector<double> sorted_shuffled_scores = shuffled_scores;
+    std::sort(sorted_ordered_scores.begin(), sorted_ordered_scores.end());
+    std::sort(sorted_shuffled_scores.begin(), sorted_shuffled_scores.end());
+    EXPECT_EQ(sorted_ordered_scores, sorted_shuffled_scores);
+
+    // The same seed gives the same pass.
+    stream.start_pass(true, SEED);
+    EXPECT_EQ(read_pass(stream, num_of_mini_batches), shuffled_scores);
+
+    // A pass started at a mini-batch continues the pass of the same seed.
+    constexpr std::size_t FIRST_MINI_BATCH = 3;
+
+    stream.start_pass(true, SEED, FIRST_MINI_BATCH);
+    const std::vector<double> resumed_scores =
+        read_pass(stream, num_of_mini_batches);
+
+    EXPECT_EQ(num_of_mini_batches, 1);
+    ASSERT_LE(resumed_scores.size(), shuffled_scores.size());
+    EXPECT_EQ(resumed_scores,
+              std::vector<double>(
+                  (shuffled_scores.end() - resumed_scores.size()),
+                  shuffled_scores.end()));
+}
+
+TEST(mini_batch_stream, range)
+{
+    std::stringstream dataset = create_dataset();
+    std::mutex        dataset_mutex;
+
+    constexpr uint64_t FIRST_POSITION = 7;
+
+    Mini_Batch_Stream stream(dataset,
+                             dataset_mutex,
+                             FIRST_POSITION,
+                             (NUM_OF_POSITIONS - FIRST_POSITION),
+                             MINI_BATCH_SIZE,
+                             MEMORY_BUDGET);
+
+    std::size_t               num_of_mini_batches = 0;
+    const std::vector<double> scores = read_pass(stream, num_of_mini_batches);
+
+    EXPECT_EQ(num_of_mini_batches, 1);
+    EXPECT_EQ(scores.size(), (NUM_OF_POSITIONS - FIRST_POSITION));
+}
+
+TEST(mini_batch_stream, memory_budget)
+{
+    std::stringstream dataset = create_dataset();
+    std::mutex        dataset_mutex;
+
+    // The budget must fit the features and a window of one mini-batch.
+    constexpr std::size_t MINIMUM_MEMORY_BUDGET =
+        (FEATURES_SIZE + (MINI_BATCH_SIZE * sizeof(Packed_Position)));
+
+    EXPECT_THROW(Mini_Batch_Stream(dataset,
+                                   dataset_mutex,
+                                   0,
+                                   NUM_OF_POSITIONS,
+                                   MINI_BATCH_SIZE,
+                                   (MINIMUM_MEMORY_BUDGET - 1)),
+                 std::invalid_argument);
+
+    // Every mini-batch held by the caller is counted.
+    EXPECT_THROW(Mini_Batch_Stream(dataset,
+                                   dataset_mutex,
+                                   0,
+                                   NUM_OF_POSITIONS,
+                                   MINI_BATCH_SIZE,
+                                   MINIMUM_MEMORY_BUDGET,
+                                   2),
+                 std::invalid_argument);
+
+    Mini_Batch_Stream stream(dataset,
+                             dataset_mutex,
+                             0,
+                             NUM_OF_POSITIONS,
+                             MINI_BATCH_SIZE,
+                             MINIMUM_MEMORY_BUDGET);
+
+    std::size_t               num_of_mini_batches = 0;
+    const std::vector<double> scores = read_pass(stream, num_of_mini_batches);
+
+    EXPECT_EQ(num_of_mini_batches, 4);
+    EXPECT_EQ(scores.size(), NUM_OF_POSITIONS);
+}
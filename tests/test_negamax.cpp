@@ -197,3 +197,135 @@ TEST(negamax, DISABLED_debug)
     const Score evaluation = e.evaluate(corr_hist_table);
     std::cout << "Evaluation: " << evaluation.to_int() << std::endl;
 }
+
+TEST(negamax, late_move_reduction_table)
+{
+    const Late_Move_Reduction_Table table = create_late_move_reduction_table();
+
+    for (std::size_t i = 0; i < MAXIMUM_NUM_OF_MOVES_IN_A_POSITION; ++i)
+    {
+        EXPECT_EQ(table[0][i], 0);
+    }
+    for (std::size_t i = 0; i < table.size; ++i) { EXPECT_EQ(table[i][0], 0); }
+
+    // The base of 0.75 truncates to no reduction while, either logarithm is
+    // still small.
+    EXPECT_EQ(table[1][30], 0);
+    EXPECT_EQ(table[30][1], 0);
+    EXPECT_EQ(table[3][3], 1);
+    EXPECT_EQ(table[10][10], 3);
+    EXPECT_EQ(table[32][32], 6);
+
+    // Deeper nodes and later moves are never reduced less.
+    for (std::size_t depth = 1; depth < table.size; ++depth)
+    {
+        for (std::size_t move_number = 1;
+             move_number < MAXIMUM_NUM_OF_MOVES_IN_A_POSITION;
+             ++move_number)
+        {
+            EXPECT_GE(table[depth][move_number],
+                      table[depth - 1][move_number]);
+            EXPECT_GE(table[depth][move_number],
+                      table[depth][move_number - 1]);
+        }
+    }
+}
+
+TEST(negamax, aspiration_window_bounds)
+{
+    const Score score(Matrex_FP_Int::from_integer(40));
+
+    Fixed_Point_Int_Storage_Type delta =
+        ASPIRATION_WINDOW_INITIAL_DELTA.get_value();
+
+    EXPECT_EQ(get_aspiration_window_bound(score, -delta).to_int(),
+              Matrex_FP_Int::from_integer(15).get_value());
+    EXPECT_EQ(get_aspiration_window_bound(score, delta).to_int(),
+              Matrex_FP_Int::from_integer(65).get_value());
+
+    // Every time the search fails outside the window the delta doubles, the
+    // bounds widen until they leave the non-mating evaluations and become
+    // infinite.
+    Score alpha = get_aspiration_window_bound(score, -delta);
+    Score beta  = get_aspiration_window_bound(score, delta);
+    while ((alpha.to_int() > FP_NEGATIVE_INFINITY)
+           || (beta.to_int() < FP_POSITIVE_INFINITY))
+    {
+        delta *= 2;
+
+        const Score wider_alpha = get_aspiration_window_bound(score, -delta);
+        const Score wider_beta  = get_aspiration_window_bound(score, delta);
+
+        EXPECT_LE(wider_alpha.to_int(), alpha.to_int());
+        EXPECT_GE(wider_beta.to_int(), beta.to_int());
+        EXPECT_TRUE((wider_alpha.to_int() == FP_NEGATIVE_INFINITY)
+                    || (wider_alpha.to_int() >= FP_EVALUATION_MIN));
+        EXPECT_TRUE((wider_beta.to_int() == FP_POSITIVE_INFINITY)
+                    || (wider_beta.to_int() <= FP_EVALUATION_MAX));
+
+        alpha = wider_alpha;
+        beta  = wider_beta;
+    }
+
+    // A score next to the edge of the evaluations is only bounded on one side.
+    const Score winning_score(FP_EVALUATION_MAX);
+    EXPECT_EQ(get_aspiration_window_bound(winning_score,
+                                          ASPIRATION_WINDOW_INITIAL_DELTA
+                                              .get_value())
+                  .to_int(),
+              FP_POSITIVE_INFINITY);
+    EXPECT_LT(get_aspiration_window_bound(winning_score,
+                                          -ASPIRATION_WINDOW_INITIAL_DELTA
+                                               .get_value())
+                  .to_int(),
+              FP_EVALUATION_MAX);
+}
+
+TEST(negamax, internal_iterative_reduction)
+{
+    constexpr uint16_t DEPTH = INTERNAL_ITERATIVE_REDUCTION_MIN_DEPTH;
+    constexpr uint16_t PLY   = 1;
+
+    const Transposition_Table_Entry empty_entry {};
+
+    Transposition_Table_Entry entry {};
+    entry.best_move = Chess_Move {.source_square      = ESQUARE::E2,
+                                  .destination_square = ESQUARE::E4,
+                                  .moving_piece       = PAWN};
+
+    // Reduced without a transposition table hit or without a move in the hit
+    // entry.
+    EXPECT_TRUE(should_do_internal_iterative_reduction(false,
+                                                       entry,
+                                                       false,
+                                                       DEPTH,
+                                                       PLY));
+    EXPECT_TRUE(should_do_internal_iterative_reduction(true,
+                                                       empty_entry,
+                                                       false,
+                                                       DEPTH,
+                                                       PLY));
+
+    // Not reduced with a transposition table move, in check, below the
+    // minimum depth or at the root.
+    EXPECT_FALSE(should_do_internal_iterative_reduction(true,
+                                                        entry,
+                                                        false,
+                                                        DEPTH,
+                                                        PLY));
+    EXPECT_FALSE(should_do_internal_iterative_reduction(false,
+                                                        entry,
+                                                        true,
+                                                        DEPTH,
+                                                        PLY));
+    EXPECT_FALSE(should_do_internal_iterative_reduction(false,
+                                                        entry,
+                                                        false,
+                                                        (DEPTH - 1),
+                                                        PLY));
+    EXPECT_FALSE(should_do_internal_iterative_reduction(false,
+                                                        entry,
+                                                        false,
+                                                        DEPTH,
+                                                        0));
+}
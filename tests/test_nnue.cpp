@@ -0,0 +1,123 @@
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include "chess_board.hpp"
+#include "gtest/gtest.h"
+#include "move_generator.hpp"
+#include "nnue.hpp"
+
+namespace
+{
+
+// A network of small random weights such that, the accumulators can't
+// overflow.
+std::filesystem::path write_network(const NNUE_File_Header& header)
+{
+    const std::filesystem::path path =
+        (std::filesystem::temp_directory_path() / "matrex_test_nnue.bin");
+
+    std::mt19937_64                        rng(12345);
+    std::uniform_int_distribution<int32_t> distribution(-64, 64);
+
+    const std::size_t num_of_parameters =
+        ((NNUE_INPUT_SIZE * NNUE_HIDDEN_SIZE) + NNUE_HIDDEN_SIZE
+         + (NUM_OF_PLAYERS * NNUE_HIDDEN_SIZE) + 1);
+
+    std::ofstream network_file(path, std::ios::binary);
+    network_file.write(reinterpret_cast<const char*>(&header.magic),
+                       sizeof(header.magic));
+    network_file.write(reinterpret_cast<const char*>(&header.input_size),
+                       sizeof(header.input_size));
+    network_file.write(reinterpret_cast<const char*>(&header.hidden_size),
+                       sizeof(header.hidden_size));
+
+    for (std::size_t i = 0; i < num_of_parameters; ++i)
+    {
+        const NNUE_Weight_Storage_Type parameter =
+            static_cast<NNUE_Weight_Storage_Type>(distribution(rng));
+        network_file.write(reinterpret_cast<const char*>(&parameter),
+                           sizeof(parameter));
+    }
+
+    return path;
+}
+
+void expect_refreshed_accumulator(Chess_Board& cb)
+{
+    Chess_Board refreshed = cb;
+    refreshed.refresh_nnue_accumulator();
+
+    EXPECT_TRUE(cb.get_nnue_accumulator() == refreshed.get_nnue_accumulator())
+        << cb.to_fen();
+}
+
+} // namespace
+
+TEST(nnue, header)
+{
+    NNUE_File_Header wrong_magic;
+    wrong_magic.magic = 0;
+
+    NNUE_File_Header wrong_hidden_size;
+    wrong_hidden_size.hidden_size = (NNUE_HIDDEN_SIZE / 2);
+
+    for (const NNUE_File_Header& header : {wrong_magic, wrong_hidden_size})
+    {
+        const std::filesystem::path path = write_network(header);
+        EXPECT_FALSE(NNUE::load(path.string()));
+        EXPECT_FALSE(NNUE::is_loaded());
+        std::filesystem::remove(path);
+    }
+
+    const std::filesystem::path path = write_network(NNUE_File_Header {});
+    EXPECT_TRUE(NNUE::load(path.string()));
+    NNUE::unload();
+    std::filesystem::remove(path);
+}
+
+// Every move of the positions (castling, en passant and promotions among them)
+// is made and undone, the incrementally updated accumulator must be the same as
+// the accumulator refreshed from scratch after both.
+TEST(nnue, incremental_update)
+{
+    const std::filesystem::path path = write_network(NNUE_File_Header {});
+    ASSERT_TRUE(NNUE::load(path.string()));
+
+    const std::vector<std::string> test_fens = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/Pp2P3/2N2Q1p/1PPBBPPP/R3K2R b KQkq a3 0 1",
+        "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+        "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1",
+        "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N w - - 0 1"};
+
+    for (const std::string& test_fen : test_fens)
+    {
+        Chess_Board cb;
+        cb.set_from_fen(test_fen);
+
+        const NNUE_Accumulator initial_accumulator = cb.get_nnue_accumulator();
+
+        Move_Generation_List  moves_list;
+        Moves_Bitboard_Matrix moves_matrix;
+        Move_Generator        mg(cb);
+        mg.generate_all_moves<MOVE_GENERATION_TYPE::ALL>(cb.get_side_to_move(),
+                                                         moves_list,
+                                                         moves_matrix);
+
+        for (const Chess_Move& move : moves_list)
+        {
+            const Undo_Chess_Move undo_move = cb.make_move(move);
+            expect_refreshed_accumulator(cb);
+
+            cb.undo_move(undo_move);
+            EXPECT_TRUE(cb.get_nnue_accumulator() == initial_accumulator)
+                << test_fen;
+        }
+
+        expect_refreshed_accumulator(cb);
+    }
+
+    NNUE::unload();
+    std::filesystem::remove(path);
+}
@@ -1,5 +1,7 @@
 #include <functional>
+#include <future>
 #include <memory>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "threads.hpp"
@@ -33,7 +35,7 @@ class Thread_Addition_Job : public Thread_Job
             [&](int64_t& overall_result)
             { overall_result += (addend_one + addend_two); });
 
-        return NULL;
+        return (addend_one + addend_two);
     }
 
   private:
@@ -43,7 +45,7 @@ class Thread_Addition_Job : public Thread_Job
     constexpr static std::size_t m_index_to_result = 0;
 };
 
-TEST(multi_threading_tests, DISABLED_single_thread)
+TEST(multi_threading_tests, single_thread)
 {
     int64_t             result = 0;
     Threads_Shared_Data shared_data(result);
@@ -58,7 +60,7 @@ TEST(multi_threading_tests, DISABLED_single_thread)
     EXPECT_EQ(result, 7);
 }
 
-TEST(multi_threading_tests, DISABLED_multiple_threads)
+TEST(multi_threading_tests, multiple_threads)
 {
     int64_t             result = 0;
     Threads_Shared_Data shared_data(result);
@@ -90,3 +92,152 @@ TEST(multi_threading_tests, DISABLED_multiple_threads)
 
     EXPECT_EQ(result, expected_result);
 }
+
+TEST(multi_threading_tests, job_futures)
+{
+    int64_t             result = 0;
+    Threads_Shared_Data shared_data(result);
+
+    Thread_Pool pool(MAX_TEST_THREAD_COUNT);
+
+    std::vector<std::future<std::any>> futures;
+    for (int64_t i = 0; i < 100; ++i)
+    {
+        futures.push_back(pool.push_job(
+            std::make_unique<Thread_Addition_Job>(shared_data, i, i)));
+    }
+
+    for (int64_t i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(std::any_cast<int64_t>(futures[i].get()), (2 * i));
+    }
+
+    pool.wait_for_jobs_to_complete();
+
+    EXPECT_EQ(result, 9900);
+}
+
+class Thread_Throwing_Job : public Thread_Job
+{
+  public:
+
+    explicit Thread_Throwing_Job(Threads_Shared_Data& shared_data) :
+        Thread_Job(shared_data)
+    {
+    }
+
+    virtual bool has_job() const override { return true; }
+
+    virtual std::any operator()(std::stop_token) override
+    {
+        throw std::runtime_error("Thread throwing job.");
+    }
+};
+
+TEST(multi_threading_tests, job_exception)
+{
+    int64_t             result = 0;
+    Threads_Shared_Data shared_data(result);
+
+    Thread_Pool pool(MAX_TEST_THREAD_COUNT);
+
+    pool.push_job(std::make_unique<Thread_Throwing_Job>(shared_data));
+    pool.push_job(std::make_unique<Thread_Addition_Job>(shared_data, 3, 4));
+
+    // The exception is rethrown by the wait even though its future was
+    // discarded, the other jobs still complete.
+    EXPECT_THROW(pool.wait_for_jobs_to_complete(), std::runtime_error);
+    EXPECT_EQ(result, 7);
+
+    // It is only rethrown once.
+    pool.push_job(std::make_unique<Thread_Addition_Job>(shared_data, 1, 2));
+    EXPECT_NO_THROW(pool.wait_for_jobs_to_complete());
+    EXPECT_EQ(result, 10);
+}
+
+TEST(multi_threading_tests, reused_pool)
+{
+    int64_t             result = 0;
+    Threads_Shared_Data shared_data(result);
+
+    Thread_Pool pool(MAX_TEST_THREAD_COUNT);
+
+    for (int64_t round = 1; round <= 50; ++round)
+    {
+        for (std::size_t i = 0; i < MAX_TEST_THREAD_COUNT; ++i)
+        {
+            pool.push_job(
+                std::make_unique<Thread_Addition_Job>(shared_data, 1, 0));
+        }
+
+        pool.wait_for_jobs_to_complete();
+
+        EXPECT_EQ(result,
+                  (round * static_cast<int64_t>(MAX_TEST_THREAD_COUNT)));
+    }
+}
+
+TEST(multi_threading_tests, pinned_workers)
+{
+    int64_t             result = 0;
+    Threads_Shared_Data shared_data(result);
+
+    Thread_Pool pool(MAX_TEST_THREAD_COUNT, true);
+
+    for (std::size_t i = 0; i < MAX_TEST_THREAD_COUNT; ++i)
+    {
+        pool.push_job(std::make_unique<Thread_Addition_Job>(shared_data, 1, 1));
+    }
+
+    pool.wait_for_jobs_to_complete();
+
+    EXPECT_EQ(result, (2 * static_cast<int64_t>(MAX_TEST_THREAD_COUNT)));
+}
+
+class Thread_ID_Job : public Thread_Job
+{
+  public:
+
+    explicit Thread_ID_Job(Threads_Shared_Data& shared_data) :
+        Thread_Job(shared_data)
+    {
+    }
+
+    virtual bool has_job() const override { return true; }
+
+    virtual std::any operator()(std::stop_token) override
+    {
+        return get_assigned_thread_id();
+    }
+};
+
+TEST(multi_threading_tests, bound_jobs)
+{
+    int64_t             result = 0;
+    Threads_Shared_Data shared_data(result);
+
+    Thread_Pool pool(MAX_TEST_THREAD_COUNT, true);
+
+    EXPECT_EQ(pool.get_num_of_workers(), MAX_TEST_THREAD_COUNT);
+    EXPECT_LE(pool.get_num_of_pinned_workers(), MAX_TEST_THREAD_COUNT);
+
+    // Every job is bound to the same worker, none of them is stolen by the
+    // idle workers.
+    constexpr std::size_t WORKER = 2;
+
+    std::vector<std::future<std::any>> futures;
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+        futures.push_back(pool.push_job_to_worker(
+            std::make_unique<Thread_ID_Job>(shared_data),
+            WORKER));
+    }
+
+    for (std::future<std::any>& future : futures)
+    {
+        EXPECT_EQ(std::any_cast<int64_t>(future.get()),
+                  static_cast<int64_t>(WORKER));
+    }
+
+    pool.wait_for_jobs_to_complete();
+}
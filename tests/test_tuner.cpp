@@ -0,0 +1,419 @@
+#include <bit>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+#include "evaluation_terms.hpp"
+#include "gtest/gtest.h"
+#include "mini_batch_stream.hpp"
+#include "tuner.hpp"
+
+namespace
+{
+
+struct Test_Position
+{
+    std::string_view fen;
+    uint8_t          result;
+};
+
+constexpr Test_Position POSITIONS[] = {
+    {START_POSITION_FEN, PACKED_RESULT::PACKED_WIN},
+    {"r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+     PACKED_RESULT::PACKED_DRAW},
+    {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 1",
+     PACKED_RESULT::PACKED_LOSS},
+    {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", PACKED_RESULT::PACKED_WIN}};
+
+// The position whose white pawn material is pushed into the clamped region of
+// function G and the number of white pawns it has.
+constexpr std::size_t CLAMPED_POSITION             = 3;
+constexpr double      CLAMPED_POSITION_WHITE_PAWNS = 3.0;
+
+std::vector<Packed_Position>
+create_positions(const std::size_t num_of_positions)
+{
+    std::vector<Packed_Position> positions;
+    Chess_Board                  cb;
+
+    for (std::size_t i = 0; i < num_of_positions; ++i)
+    {
+        cb.set_from_fen(std::string(POSITIONS[i].fen));
+        Packed_Position packed = cb.to_packed_position();
+        packed.result          = POSITIONS[i].result;
+        positions.push_back(packed);
+    }
+
+    return positions;
+}
+
+std::filesystem::path
+write_dataset(const std::vector<Packed_Position>& positions)
+{
+    const std::filesystem::path path =
+        (std::filesystem::temp_directory_path() / "matrex_test_tuner.bin");
+
+    std::ofstream dataset(path, std::ios::binary);
+    dataset.write(reinterpret_cast<const char*>(positions.data()),
+                  (positions.size() * sizeof(Packed_Position)));
+
+    return path;
+}
+
+Evaluation_Weights<double> create_weights()
+{
+    Evaluation_Weights<double> weights;
+    for (std::size_t i = 0; i < weights.get_size(); ++i)
+    {
+        weights[i] = TUNED_EVALUATION_WEIGHTS[i].to_double();
+    }
+
+    // Twice the clamp away from the white pawn material of the position such
+    // that, a small perturbation of the weights keeps it clamped.
+    NLR_Parameters<double>& pawn_nlr =
+        weights.material_NLR_parameters[PIECES::PAWN];
+    pawn_nlr.k = (weights.material[PIECES::PAWN] * CLAMPED_POSITION_WHITE_PAWNS)
+               - (2.0 * NON_LINEAR_RESPONSE_G_EXPONENT_CLAMP);
+
+    return weights;
+}
+
+// The reference loss of the tuner, differentiated by hand.
+double sigmoid(const double s)
+{
+    return 1.0 / (1.0 + std::exp(-s * TUNER_SIGMOID_K));
+}
+
+double derivative_loss(const double evaluation_white, const double target)
+{
+    const double error = target - sigmoid(evaluation_white);
+
+    const double derivative_huber_loss =
+        (std::abs(error) <= TUNER_HUBER_LOSS_GAMMA)
+            ? -error
+            : (-TUNER_HUBER_LOSS_GAMMA
+               * (error / std::sqrt((error * error) + TUNER_EPSILON)));
+
+    return derivative_huber_loss * sigmoid(evaluation_white)
+         * (1.0 - sigmoid(evaluation_white)) * TUNER_SIGMOID_K;
+}
+
+// The mean of the gradients of every position recorded on its own tape.
+std::vector<double> tape_gradient(const Evaluation_Weights<double>& weights,
+                                  const Mini_Batch&                 mini_batch)
+{
+    const std::size_t N = mini_batch.features.size;
+
+    std::vector<double> gradient(weights.get_size(), 0.0);
+
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        AD_Tape                      tape;
+        Evaluation_Weights<AD_Value> ad_weights;
+        for (std::size_t w = 0; w < weights.get_size(); ++w)
+        {
+            ad_weights[w] = AD_Value::variable(tape, weights[w]);
+        }
+
+        const Feature_Evaluator e(ad_weights, mini_batch.features, i);
+        const AD_Value          result = e.evaluate_white_perspective();
+
+        tape.backward(result.node);
+
+        const double scale =
+            derivative_loss(result.value(), mini_batch.scores[i]);
+        for (std::size_t w = 0; w < weights.get_size(); ++w)
+        {
+            gradient[w] += (tape[ad_weights[w].node].adjoint * scale)
+                         / static_cast<double>(N);
+        }
+    }
+
+    return gradient;
+}
+
+// Every tuner step job on the mini-batch followed by a reduction of all the
+// weights.
+Tuner_Step_State step(const Tuner&                             tuner,
+                      const std::size_t                        num_of_threads,
+                      const Shared_Snapshot<Tuner_Step_State>& global_state,
+                      const Mini_Batch&                        mini_batch)
+{
+    Tuner_Step_Shared_Data::Local_States local_states(num_of_threads);
+
+    Tuner_Step_Shared_Data shared_data {
+        .learning_rate = 0.01,
+        .timestep      = 1,
+        .global_state  = global_state,
+        .local_states  = local_states,
+        .split_sizes   = Thread_Result_Slots<std::size_t>(num_of_threads),
+        .weight_update_magnitudes = Thread_Result_Slots<double>(num_of_threads),
+        .next_global_state        = {}};
+
+    for (std::size_t worker = 0; worker < num_of_threads; ++worker)
+    {
+        Tuner_Step job(shared_data, tuner, mini_batch, worker);
+        job(std::stop_token {});
+    }
+
+    Tuner_Reduce reduce(shared_data, 0, Evaluation_Weights<double>::SIZE);
+    reduce(std::stop_token {});
+
+    return shared_data.next_global_state;
+}
+
+} // namespace
+
+TEST(tuner, more_threads_than_positions)
+{
+    const std::vector<Packed_Position> positions =
+        create_positions(std::size(POSITIONS));
+    const std::filesystem::path path = write_dataset(positions);
+
+    constexpr std::size_t NUM_OF_THREADS = 8;
+    ASSERT_GT(NUM_OF_THREADS, positions.size());
+
+    std::ostringstream log;
+    std::ofstream      output;
+    std::ifstream      dataset(path, std::ios::binary);
+    std::ifstream      single_thread_dataset(path, std::ios::binary);
+    const Tuner        tuner(log, dataset, output, NUM_OF_THREADS);
+    const Tuner single_thread_tuner(log, single_thread_dataset, output, 1);
+
+    const Mini_Batch mini_batch = create_mini_batch(positions);
+
+    // The splits cover the mini-batch, most of them are empty.
+    std::size_t num_of_split_positions = 0;
+    for (std::size_t worker = 0; worker < NUM_OF_THREADS; ++worker)
+    {
+        num_of_split_positions +=
+            tuner.create_worker_batch(mini_batch, worker).features.size;
+    }
+    EXPECT_EQ(num_of_split_positions, positions.size());
+
+    Tuner_Step_State initial_state;
+    initial_state.weights = create_weights();
+    const Shared_Snapshot<Tuner_Step_State> global_state(initial_state);
+
+    const Tuner_Step_State state =
+        step(tuner, NUM_OF_THREADS, global_state, mini_batch);
+    const Tuner_Step_State single_thread_state =
+        step(single_thread_tuner, 1, global_state, mini_batch);
+
+    // The first moment is linear in the gradient such that, the average
+    // weighted by the split sizes is the first moment of the whole mini-batch.
+    for (std::size_t i = 0; i < Evaluation_Weights<double>::SIZE; ++i)
+    {
+        ASSERT_TRUE(std::isfinite(state.first_moment[i])) << "weight " << i;
+        ASSERT_TRUE(std::isfinite(state.second_moment[i])) << "weight " << i;
+        ASSERT_TRUE(std::isfinite(state.weights[i])) << "weight " << i;
+
+        EXPECT_NEAR(
+            state.first_moment[i],
+            single_thread_state.first_moment[i],
+            (1e-12 + (1e-9 * std::abs(single_thread_state.first_moment[i]))))
+            << "weight " << i;
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(tuner, gradient)
+{
+    const std::vector<Packed_Position> positions =
+        create_positions(std::size(POSITIONS));
+    const std::filesystem::path path = write_dataset(positions);
+
+    std::ostringstream log;
+    std::ifstream      dataset(path, std::ios::binary);
+    std::ofstream      output;
+    const Tuner        tuner(log, dataset, output, 1);
+
+    const Mini_Batch mini_batch = create_mini_batch(positions);
+    const Evaluation_Weights<double> weights = create_weights();
+
+    // The white pawn material of the position is in the clamped region of
+    // function G.
+    const NLR_Parameters<double>& pawn_nlr =
+        weights.material_NLR_parameters[PIECES::PAWN];
+    const auto& white_pawns =
+        mini_batch.features.piece_bitboards[PIECE_COLOR::WHITE][PIECES::PAWN];
+    ASSERT_EQ(static_cast<double>(std::popcount(white_pawns[CLAMPED_POSITION])),
+              CLAMPED_POSITION_WHITE_PAWNS);
+    ASSERT_GE(std::abs((weights.material[PIECES::PAWN]
+                        * CLAMPED_POSITION_WHITE_PAWNS)
+                       - pawn_nlr.k),
+              NON_LINEAR_RESPONSE_G_EXPONENT_CLAMP);
+
+    const Evaluation_Weights<double> gradient =
+        tuner.compute_gradient(weights, mini_batch);
+    const std::vector<double> expected_gradient =
+        tape_gradient(weights, mini_batch);
+
+    const double N = static_cast<double>(mini_batch.features.size);
+
+    for (std::size_t i = 0; i < weights.get_size(); ++i)
+    {
+        EXPECT_NEAR(gradient[i],
+                    expected_gradient[i],
+                    (1e-12 + (1e-9 * std::abs(expected_gradient[i]))))
+            << "weight " << i;
+
+        // The loss is the sum of the losses of the positions whereas, the
+        // gradient is the mean.
+        const double h = (1e-6 * std::max(1.0, std::abs(weights[i])));
+
+        Evaluation_Weights<double> weights_plus  = weights;
+        Evaluation_Weights<double> weights_minus = weights;
+        weights_plus[i]                         += h;
+        weights_minus[i]                        -= h;
+
+        const double finite_difference =
+            (tuner.compute_mini_batch_loss(mini_batch, weights_plus)
+             - tuner.compute_mini_batch_loss(mini_batch, weights_minus))
+            / (2.0 * h * N);
+
+        EXPECT_NEAR(gradient[i],
+                    finite_difference,
+                    (1e-8 + (1e-4 * std::abs(gradient[i]))))
+            << "weight " << i;
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(tuner, dataset_too_small)
+{
+    // Two positions leave no position for the training dataset.
+    const std::filesystem::path path = write_dataset(create_positions(2));
+
+    std::ostringstream log;
+    std::ofstream      output;
+
+    std::ifstream dataset(path, std::ios::binary);
+    EXPECT_THROW(Tuner(log, dataset, output, 1), std::runtime_error);
+
+    constexpr std::size_t MEMORY_BUDGET = (1 << 20);
+
+    std::ifstream streamed_dataset(path, std::ios::binary);
+    EXPECT_THROW(
+        Tuner(log, streamed_dataset, output, 1, false, {}, MEMORY_BUDGET),
+        std::runtime_error);
+
+    std::filesystem::remove(path);
+}
+
+TEST(tuner, checkpoint)
+{
+    constexpr uint64_t NUM_OF_THREADS = 3;
+    constexpr uint64_t MEMORY_BUDGET  = (1 << 20);
+
+    Tuner_Checkpoint checkpoint;
+    checkpoint.num_of_threads                 = NUM_OF_THREADS;
+    checkpoint.memory_budget                  = MEMORY_BUDGET;
+    checkpoint.epoch                          = 4;
+    checkpoint.next_mini_batch                = 17;
+    checkpoint.timestep                       = 1234;
+    checkpoint.weight_update_magnitude_sum    = 0.5;
+    checkpoint.previous_epoch_training_loss   = 0.25;
+    checkpoint.previous_epoch_validation_loss = 0.125;
+    checkpoint.epoch_patience_count           = 2;
+
+    std::mt19937_64   rng(12345);
+    std::stringstream rng_state;
+    rng_state << rng;
+    checkpoint.rng_state = rng_state.str();
+
+    for (std::size_t i = 0; i < checkpoint.best_weights.get_size(); ++i)
+    {
+        checkpoint.state.first_moment[i]  = static_cast<double>(i);
+        checkpoint.state.second_moment[i] = static_cast<double>(i) * 2.0;
+        checkpoint.state.weights[i]       = static_cast<double>(i) * 3.0;
+        checkpoint.best_weights[i]        = static_cast<double>(i) * 4.0;
+    }
+
+    std::stringstream file;
+    checkpoint.write(file);
+    const std::string bytes = file.str();
+
+    // Round trip.
+    {
+        std::istringstream     is(bytes);
+        const Tuner_Checkpoint read =
+            Tuner_Checkpoint::read(is, NUM_OF_THREADS, MEMORY_BUDGET);
+
+        EXPECT_EQ(read.num_of_threads, checkpoint.num_of_threads);
+        EXPECT_EQ(read.memory_budget, checkpoint.memory_budget);
+        EXPECT_EQ(read.epoch, checkpoint.epoch);
+        EXPECT_EQ(read.next_mini_batch, checkpoint.next_mini_batch);
+        EXPECT_EQ(read.timestep, checkpoint.timestep);
+        EXPECT_EQ(read.weight_update_magnitude_sum,
+                  checkpoint.weight_update_magnitude_sum);
+        EXPECT_EQ(read.previous_epoch_training_loss,
+                  checkpoint.previous_epoch_training_loss);
+        EXPECT_EQ(read.previous_epoch_validation_loss,
+                  checkpoint.previous_epoch_validation_loss);
+        EXPECT_EQ(read.epoch_patience_count, checkpoint.epoch_patience_count);
+        EXPECT_EQ(read.rng_state, checkpoint.rng_state);
+
+        for (std::size_t i = 0; i < checkpoint.best_weights.get_size(); ++i)
+        {
+            EXPECT_EQ(read.state.first_moment[i],
+                      checkpoint.state.first_moment[i]);
+            EXPECT_EQ(read.state.second_moment[i],
+                      checkpoint.state.second_moment[i]);
+            EXPECT_EQ(read.state.weights[i], checkpoint.state.weights[i]);
+            EXPECT_EQ(read.best_weights[i], checkpoint.best_weights[i]);
+        }
+    }
+
+    // A different number of threads.
+    {
+        std::istringstream is(bytes);
+        EXPECT_THROW(
+            Tuner_Checkpoint::read(is, (NUM_OF_THREADS + 1), MEMORY_BUDGET),
+            std::runtime_error);
+    }
+
+    // A different memory budget and a dataset in memory.
+    for (const uint64_t memory_budget : {(MEMORY_BUDGET * 2), uint64_t {0}})
+    {
+        std::istringstream is(bytes);
+        EXPECT_THROW(Tuner_Checkpoint::read(is, NUM_OF_THREADS, memory_budget),
+                     std::runtime_error);
+    }
+
+    // A random number generator state larger than any state of the generator.
+    {
+        Tuner_Checkpoint oversized = checkpoint;
+        oversized.rng_state.resize(TUNER_CHECKPOINT_MAX_RNG_STATE_SIZE + 1);
+
+        std::stringstream oversized_file;
+        oversized.write(oversized_file);
+
+        EXPECT_THROW(Tuner_Checkpoint::read(oversized_file,
+                                            NUM_OF_THREADS,
+                                            MEMORY_BUDGET),
+                     std::runtime_error);
+    }
+
+    // Truncated in the weights and in the header.
+    for (const std::size_t size : {(bytes.size() - 1), std::size_t {12}})
+    {
+        std::istringstream is(bytes.substr(0, size));
+        EXPECT_THROW(Tuner_Checkpoint::read(is, NUM_OF_THREADS, MEMORY_BUDGET),
+                     std::runtime_error);
+    }
+
+    // Wrong magic.
+    {
+        std::string wrong_magic = bytes;
+        wrong_magic[0]          = static_cast<char>(~wrong_magic[0]);
+
+        std::istringstream is(wrong_magic);
+        EXPECT_THROW(Tuner_Checkpoint::read(is, NUM_OF_THREADS, MEMORY_BUDGET),
+                     std::runtime_error);
+    }
+}
@@ -0,0 +1,71 @@
+#include "gtest/gtest.h"
+#include "search.hpp"
+#include "uci.hpp"
+
+TEST(uci, search_parameters)
+{
+    Search_Parameters parameters;
+    for (std::size_t i = 0; i < NUM_OF_SEARCH_PARAMETERS; ++i)
+    {
+        const Search_Parameter_Definition& definition =
+            SEARCH_PARAMETER_DEFINITIONS[i];
+        const SEARCH_PARAMETER parameter = static_cast<SEARCH_PARAMETER>(i);
+
+        EXPECT_TRUE(Search_Parameters::contains(definition.name));
+        EXPECT_EQ(parameters[parameter], definition.default_value);
+
+        EXPECT_TRUE(parameters.set(definition.name, definition.max));
+        EXPECT_EQ(parameters[parameter], definition.max);
+
+        // Values outside of the range are clamped to it.
+        EXPECT_TRUE(parameters.set(definition.name, (definition.max + 1)));
+        EXPECT_EQ(parameters[parameter], definition.max);
+        EXPECT_TRUE(parameters.set(definition.name, (definition.min - 1)));
+        EXPECT_EQ(parameters[parameter], definition.min);
+    }
+
+    // Names are case sensitive and unknown names change nothing.
+    const Search_Parameters defaults;
+    for (const std::string_view name : {"rfpmaxdepth", "RFPMaxDepth2", ""})
+    {
+        EXPECT_FALSE(Search_Parameters::contains(name));
+        EXPECT_FALSE(parameters.set(name, 1));
+    }
+    EXPECT_EQ(parameters[RAZORING_MAX_DEPTH],
+              SEARCH_PARAMETER_DEFINITIONS[RAZORING_MAX_DEPTH].min);
+    EXPECT_NE(parameters[RAZORING_MAX_DEPTH], defaults[RAZORING_MAX_DEPTH]);
+}
+
+TEST(uci, setoption)
+{
+    UCI uci;
+
+    const Search_Parameters& parameters =
+        uci.get_search_constraints().parameters;
+
+    uci.handle_command("setoption name Hash value 32");
+    EXPECT_EQ(uci.get_search_constraints().transposition_table_size, 32);
+
+    uci.handle_command("setoption name RFPMaxDepth value 9");
+    EXPECT_EQ(parameters[REVERSE_FUTILITY_PRUNING_MAX_DEPTH], 9);
+
+    // Clamped to the parameter's range.
+    uci.handle_command("setoption name RazoringLinearMargin value 100000");
+    EXPECT_EQ(parameters[RAZORING_LINEAR_MARGIN],
+              SEARCH_PARAMETER_DEFINITIONS[RAZORING_LINEAR_MARGIN].max);
+    uci.handle_command("setoption name RazoringLinearMargin value -5");
+    EXPECT_EQ(parameters[RAZORING_LINEAR_MARGIN],
+              SEARCH_PARAMETER_DEFINITIONS[RAZORING_LINEAR_MARGIN].min);
+
+    // Values that are not integers, missing values and unknown options are
+    // ignored.
+    uci.handle_command("setoption name RFPMaxDepth value 4x");
+    uci.handle_command("setoption name RFPMaxDepth value four");
+    uci.handle_command("setoption name RFPMaxDepth value");
+    uci.handle_command("setoption name RFPMaxDepth");
+    uci.handle_command("setoption name RFPDepth value 4");
+    EXPECT_EQ(parameters[REVERSE_FUTILITY_PRUNING_MAX_DEPTH], 9);
+
+    uci.handle_command("setoption name RFPConstantMargin value 0");
+    EXPECT_EQ(parameters[REVERSE_FUTILITY_PRUNING_CONSTANT_MARGIN], 0);
+}